@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+# All rights reserved. The contributor(s) of this file has/have agreed to the
+# RapidStream Contributor License Agreement.
+
+# Builds a DPI library with the host C++ compiler, accepting the subset of
+# `xsc` options used by `dpi_library`. Verilator compiles the simulation with
+# the host compiler, so the DPI library must be ABI-compatible with it.
+
+set -e
+
+output=""
+compile_options=()
+link_options=()
+srcs=()
+for arg in "$@"; do
+  case "${arg}" in
+  --output=*) output="${arg#--output=}" ;;
+  --mt=*) ;;
+  --gcc_compile_options=*) compile_options+=("${arg#--gcc_compile_options=}") ;;
+  --gcc_link_options=*) link_options+=("${arg#--gcc_link_options=}") ;;
+  *) srcs+=("${arg}") ;;
+  esac
+done
+
+# `dpi_library` escapes '$' for `xsc`; no shell is involved here, so unescape.
+link_options=("${link_options[@]//\\\$/\$}")
+
+exec "${CXX:-g++}" -std=c++17 -shared -fPIC -o "${output}" \
+  "${compile_options[@]}" "${srcs[@]}" "${link_options[@]}"
@@ -70,8 +70,8 @@ def _dpi_library_impl(ctx):
     ctx.actions.run(
         outputs = [output],
         inputs = depset(direct_inputs, transitive = transitive_inputs),
-        executable = ctx.executable._xsc,
-        tools = [ctx.executable._xsc],
+        executable = ctx.executable._compiler,
+        tools = [ctx.executable._compiler],
         arguments = args,
         mnemonic = "DpiCompile",
     )
@@ -89,7 +89,7 @@ _dpi_library = rule(
         "hdrs": attr.label_list(allow_files = True),
         "includes": attr.label_list(allow_files = True),
         "deps": attr.label_list(providers = [CcInfo]),
-        "_xsc": attr.label(
+        "_compiler": attr.label(
             cfg = "exec",
             default = Label("//bazel:xsc_xv"),
             executable = True,
@@ -104,7 +104,7 @@ _dpi_legacy_rdi_library = rule(
         "hdrs": attr.label_list(allow_files = True),
         "includes": attr.label_list(allow_files = True),
         "deps": attr.label_list(providers = [CcInfo]),
-        "_xsc": attr.label(
+        "_compiler": attr.label(
             cfg = "exec",
             default = Label("//bazel:xsc_legacy_rdi"),
             executable = True,
@@ -112,6 +112,21 @@ _dpi_legacy_rdi_library = rule(
     },
 )
 
+_verilator_dpi_library = rule(
+    implementation = _dpi_library_impl,
+    attrs = {
+        "srcs": attr.label_list(allow_files = True),
+        "hdrs": attr.label_list(allow_files = True),
+        "includes": attr.label_list(allow_files = True),
+        "deps": attr.label_list(providers = [CcInfo]),
+        "_compiler": attr.label(
+            cfg = "exec",
+            default = Label("//bazel:dpi_cc"),
+            executable = True,
+        ),
+    },
+)
+
 def dpi_library(name, **kwargs):
     _dpi_library(name = name, **kwargs)
     cc_library(name = name + "_cc", **kwargs)
@@ -119,3 +134,7 @@ def dpi_library(name, **kwargs):
 def dpi_legacy_rdi_library(name, **kwargs):
     _dpi_legacy_rdi_library(name = name, **kwargs)
     cc_library(name = name + "_cc", **kwargs)
+
+def verilator_dpi_library(name, **kwargs):
+    _verilator_dpi_library(name = name, **kwargs)
+    cc_library(name = name + "_cc", **kwargs)
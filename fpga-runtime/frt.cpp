@@ -4,48 +4,66 @@
 
 #include "frt.h"
 
-#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include <glog/logging.h>
-#include <CL/cl2.hpp>
 
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/intel_opencl_device.h"
+#include "frt/devices/model_device.h"
 #include "frt/devices/tapa_fast_cosim_device.h"
 #include "frt/devices/xilinx_opencl_device.h"
 
 namespace fpga {
 
-Instance::Instance(const std::string& bitstream) {
+Instance::Instance(const std::string& bitstream, int device_index) {
   LOG(INFO) << "Loading " << bitstream;
-  cl::Program::Binaries binaries;
-  {
-    std::ifstream stream(bitstream, std::ios::binary);
-    binaries = {{std::istreambuf_iterator<char>(stream),
-                 std::istreambuf_iterator<char>()}};
+  const internal::BitstreamFile file(bitstream);
+
+  if ((device_ = internal::XilinxOpenclDevice::New(file, device_index))) {
+    return;
   }
 
-  if ((device_ = internal::XilinxOpenclDevice::New(binaries))) {
+  if ((device_ = internal::IntelOpenclDevice::New(file, device_index))) {
     return;
   }
 
-  if ((device_ = internal::IntelOpenclDevice::New(binaries))) {
+  if ((device_ = internal::TapaFastCosimDevice::New(file, device_index))) {
     return;
   }
 
-  if ((device_ = internal::TapaFastCosimDevice::New(
-           bitstream,
-           std::string_view(reinterpret_cast<char*>(binaries.begin()->data()),
-                            binaries.begin()->size())))) {
+  if ((device_ = internal::ModelDevice::New(file, device_index))) {
     return;
   }
 
   LOG(FATAL) << "Unexpected bitstream file";
 }
 
-size_t Instance::SuspendBuf(int index) { return device_->SuspendBuffer(index); }
+Instance::Instance(std::unique_ptr<internal::Device> device)
+    : device_(std::move(device)) {
+  CHECK(device_ != nullptr);
+}
+
+bool Instance::UsesSoftwareKernel() const {
+  return device_->UsesSoftwareKernel();
+}
+
+bool Instance::SetSoftwareKernel(std::function<void()> kernel) {
+  return device_->SetSoftwareKernel(std::move(kernel));
+}
+
+size_t Instance::SuspendBuf(int index) {
+  size_t suspended = device_->SuspendBuffer(index);
+  if (auto it = arg_transfers_.find(index); it != arg_transfers_.end()) {
+    it->second.load_bytes = it->second.store_bytes = 0;
+  }
+  return suspended;
+}
 
 void Instance::WriteToDevice() { device_->WriteToDevice(); }
 
@@ -87,6 +105,10 @@ double Instance::StoreTimeSeconds() const {
   return static_cast<double>(StoreTimeNanoSeconds()) * 1e-9;
 }
 
+size_t Instance::LoadBytes() const { return device_->LoadBytes(); }
+
+size_t Instance::StoreBytes() const { return device_->StoreBytes(); }
+
 double Instance::LoadThroughputGbps() const {
   return static_cast<double>(device_->LoadBytes()) /
          static_cast<double>(LoadTimeNanoSeconds());
@@ -97,6 +119,41 @@ double Instance::StoreThroughputGbps() const {
          static_cast<double>(StoreTimeNanoSeconds());
 }
 
+InvocationReport Instance::GetInvocationReport() const {
+  InvocationReport report = {
+      .events = device_->GetPerfEvents(),
+      .load_ns = LoadTimeNanoSeconds(),
+      .compute_ns = ComputeTimeNanoSeconds(),
+      .store_ns = StoreTimeNanoSeconds(),
+      .load_bytes = LoadBytes(),
+      .store_bytes = StoreBytes(),
+      .staging_ns = device_->StagingTimeNanoSeconds(),
+      .cycles = device_->GetCycleCounters(),
+  };
+  std::map<int, std::string> names;
+  for (const auto& arg : GetArgsInfo()) {
+    names[arg.index] = arg.name;
+  }
+  for (auto [index, transfer] : arg_transfers_) {
+    if (auto it = names.find(index); it != names.end()) {
+      transfer.name = it->second;
+    }
+    transfer.is_staged = device_->IsBufferStaged(index);
+    report.args.push_back(std::move(transfer));
+  }
+  return report;
+}
+
+void Instance::RecordBufferArg(int index, internal::Tag tag, size_t size) {
+  ArgTransfer& transfer = arg_transfers_[index] = {.index = index};
+  if (tag == internal::Tag::kReadOnly || tag == internal::Tag::kReadWrite) {
+    transfer.store_bytes = size;
+  }
+  if (tag == internal::Tag::kWriteOnly || tag == internal::Tag::kReadWrite) {
+    transfer.load_bytes = size;
+  }
+}
+
 void Instance::ConditionallyFinish(bool has_stream) {
   if (!has_stream) {
     VLOG(1) << "no stream found; waiting for command to finish";
@@ -9,7 +9,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <ratio>
 #include <string>
@@ -20,6 +22,7 @@
 #include "frt/arg_info.h"
 #include "frt/buffer.h"
 #include "frt/device.h"
+#include "frt/perf_report.h"  // IWYU pragma: export
 #include "frt/stream.h"
 #include "frt/stream_arg.h"
 #include "frt/stringify.h"  // IWYU pragma: export
@@ -56,9 +59,15 @@ PlaceholderBuffer<T> Placeholder(T* ptr, size_t n) {
 template <typename T>
 using Stream = internal::Stream<T, internal::Tag::kReadWrite>;
 
+class WorkerPool;
+
 class Instance {
  public:
-  Instance(const std::string& bitstream);
+  // Loads `bitstream` onto the `device_index`-th matching device.
+  Instance(const std::string& bitstream, int device_index = 0);
+
+  // Wraps an already-created device, e.g., a mock device in tests.
+  explicit Instance(std::unique_ptr<internal::Device> device);
 
   // Move-only.
   Instance(Instance&&) = default;
@@ -82,6 +91,7 @@ class Instance {
   template <typename T, internal::Tag tag>
   void SetArg(int index, internal::Buffer<T, tag> arg) {
     device_->SetBufferArg(index, tag, arg);
+    RecordBufferArg(index, tag, arg.SizeInBytes());
   }
 
   // Sets a stream argument.
@@ -96,6 +106,12 @@ class Instance {
     SetArg(0, std::forward<Args>(args)...);
   }
 
+  // Sets the host implementation of the program, which devices that model
+  // the computation in software may run instead. Returns whether the device
+  // uses it, which `UsesSoftwareKernel` tells before the kernel is built.
+  bool UsesSoftwareKernel() const;
+  bool SetSoftwareKernel(std::function<void()> kernel);
+
   // Suspends a buffer from being transferred between host and device and
   // returns the number of transfer operations suspended.
   size_t SuspendBuf(int index);
@@ -157,13 +173,29 @@ class Instance {
   // Returns the store time in seconds.
   double StoreTimeSeconds() const;
 
+  // Returns the number of bytes written to the device.
+  size_t LoadBytes() const;
+
+  // Returns the number of bytes read from the device.
+  size_t StoreBytes() const;
+
   // Returns the load throughput in GB/s.
   double LoadThroughputGbps() const;
 
   // Returns the store throughput in GB/s.
   double StoreThroughputGbps() const;
 
+  // Returns the transferred bytes per argument, the timestamps of each
+  // command, and the cycle counters of the last invocation. Cycle counters are
+  // only reported by fast cosim with `-xosim_perf_counters` and are empty on
+  // board. Add reports of repeated invocations to a `PerfReport` to aggregate
+  // them.
+  InvocationReport GetInvocationReport() const;
+
  private:
+  // Replays arguments recorded in the parent process.
+  friend class WorkerPool;
+
   template <typename T, typename... Args>
   void SetArg(int index, T&& arg, Args&&... other_args) {
     SetArg(index, std::forward<T>(arg));
@@ -172,7 +204,10 @@ class Instance {
 
   void ConditionallyFinish(bool has_stream);
 
+  void RecordBufferArg(int index, internal::Tag tag, size_t size);
+
   std::unique_ptr<internal::Device> device_;
+  std::map<int, ArgTransfer> arg_transfers_;
 };
 
 template <typename Arg, typename... Args>
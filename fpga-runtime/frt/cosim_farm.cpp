@@ -0,0 +1,104 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/cosim_farm.h"
+
+#include <future>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace fpga {
+
+CosimFarm::CosimFarm(const std::string& bitstream, int max_parallel)
+    : CosimFarm([bitstream](int slot) { return Instance(bitstream, slot); },
+                max_parallel) {}
+
+CosimFarm::CosimFarm(InstanceFactory new_instance, int max_parallel)
+    : new_instance_(std::move(new_instance)) {
+  CHECK_GT(max_parallel, 0) << "a cosim farm needs at least one slot";
+  slots_.reserve(max_parallel);
+  for (int i = 0; i < max_parallel; ++i) {
+    slots_.emplace_back([this, i] { Serve(i); });
+  }
+}
+
+CosimFarm::~CosimFarm() {
+  {
+    std::unique_lock lock(mtx_);
+    is_stopping_ = true;
+  }
+  job_cv_.notify_all();
+  for (auto& slot : slots_) {
+    slot.join();
+  }
+}
+
+std::future<InvocationReport> CosimFarm::Submit(
+    std::function<void(Instance&)> set_args) {
+  return Submit(std::move(set_args), [](Instance& instance) {
+    return instance.GetInvocationReport();
+  });
+}
+
+std::vector<InvocationReport> CosimFarm::RunAll(
+    std::vector<std::function<void(Instance&)>> arg_sets) {
+  std::vector<std::future<InvocationReport>> futures;
+  futures.reserve(arg_sets.size());
+  for (auto& set_args : arg_sets) {
+    futures.push_back(Submit(std::move(set_args)));
+  }
+  std::vector<InvocationReport> reports;
+  reports.reserve(futures.size());
+  for (auto& future : futures) {
+    reports.push_back(future.get());
+  }
+  return reports;
+}
+
+size_t CosimFarm::pending() const {
+  std::unique_lock lock(mtx_);
+  return jobs_.size() + running_count_;
+}
+
+Instance CosimFarm::Run(int slot,
+                        const std::function<void(Instance&)>& set_args) {
+  Instance instance = new_instance_(slot);
+  set_args(instance);
+  instance.WriteToDevice();
+  instance.Exec();
+  instance.ReadFromDevice();
+  instance.Finish();
+  return instance;
+}
+
+void CosimFarm::Enqueue(std::function<void(int slot)> job) {
+  {
+    std::unique_lock lock(mtx_);
+    jobs_.push_back(std::move(job));
+  }
+  job_cv_.notify_one();
+}
+
+void CosimFarm::Serve(int slot) {
+  while (true) {
+    std::function<void(int slot)> job;
+    {
+      std::unique_lock lock(mtx_);
+      // Queued runs are drained before stopping.
+      job_cv_.wait(lock, [this] { return is_stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      ++running_count_;
+    }
+    VLOG(1) << "Starting a run in slot #" << slot;
+    job(slot);  // Errors are carried by the future.
+  }
+}
+
+}  // namespace fpga
@@ -0,0 +1,116 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_COSIM_FARM_H_
+#define FPGA_RUNTIME_COSIM_FARM_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "frt.h"
+#include "frt/perf_report.h"
+
+namespace fpga {
+
+// Runs many argument sets of the same program, e.g., test vectors of a
+// simulated `.xo` or `.zip`, with at most a bounded number of simulator
+// processes at a time. Each run gets a fresh `Instance`; the `i`-th slot
+// loads it as device `i`, so runs in different slots never share a work
+// directory. Results are collected asynchronously through futures.
+class CosimFarm {
+ public:
+  // Creates the instance of a run in the `slot`-th slot.
+  using InstanceFactory = std::function<Instance(int slot)>;
+
+  // Runs at most `max_parallel` simulations of `bitstream` at a time.
+  CosimFarm(const std::string& bitstream, int max_parallel);
+
+  // Runs at most `max_parallel` instances created by `new_instance` at a time,
+  // e.g., ones with mock devices in tests.
+  CosimFarm(InstanceFactory new_instance, int max_parallel);
+
+  // Not copyable or movable.
+  CosimFarm(const CosimFarm&) = delete;
+  CosimFarm& operator=(const CosimFarm&) = delete;
+
+  // Waits for all queued runs to finish.
+  ~CosimFarm();
+
+  // Returns the maximum number of concurrent runs.
+  size_t size() const { return slots_.size(); }
+
+  // Queues a run that calls `set_args(instance)` to bind the arguments, then
+  // writes, executes, reads, and finishes the program. Returns the result of
+  // `get_result(instance)` once the run is finished, or the error it throws.
+  // Buffers bound by `set_args` must remain valid until then.
+  template <typename GetResult>
+  std::future<std::invoke_result_t<GetResult&, Instance&>> Submit(
+      std::function<void(Instance&)> set_args, GetResult get_result) {
+    using Result = std::invoke_result_t<GetResult&, Instance&>;
+    auto task = std::make_shared<std::packaged_task<Result(int)>>(
+        [this, set_args = std::move(set_args),
+         get_result = std::move(get_result)](int slot) mutable {
+          RunScope scope(*this);
+          Instance instance = Run(slot, set_args);
+          return get_result(instance);
+        });
+    std::future<Result> result = task->get_future();
+    Enqueue([task](int slot) { (*task)(slot); });
+    return result;
+  }
+
+  // Queues a run and returns its invocation report.
+  std::future<InvocationReport> Submit(
+      std::function<void(Instance&)> set_args);
+
+  // Runs all argument sets and returns their reports in the same order.
+  std::vector<InvocationReport> RunAll(
+      std::vector<std::function<void(Instance&)>> arg_sets);
+
+  // Returns the number of queued or running runs.
+  size_t pending() const;
+
+ private:
+  // Ends a run of the `Serve` thread when it goes out of scope in a job. Jobs
+  // return or throw after their locals are destroyed, so a run no longer
+  // counts as pending once its future is ready.
+  class RunScope {
+   public:
+    explicit RunScope(CosimFarm& farm) : farm_(farm) {}
+    RunScope(const RunScope&) = delete;
+    RunScope& operator=(const RunScope&) = delete;
+    ~RunScope() {
+      std::unique_lock lock(farm_.mtx_);
+      --farm_.running_count_;
+    }
+
+   private:
+    CosimFarm& farm_;
+  };
+
+  Instance Run(int slot, const std::function<void(Instance&)>& set_args);
+  void Enqueue(std::function<void(int slot)> job);
+  void Serve(int slot);
+
+  InstanceFactory new_instance_;
+  std::vector<std::thread> slots_;
+  std::deque<std::function<void(int slot)>> jobs_;
+  size_t running_count_ = 0;
+  bool is_stopping_ = false;
+  mutable std::mutex mtx_;
+  std::condition_variable job_cv_;
+};
+
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_COSIM_FARM_H_
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/cosim_farm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "frt.h"
+#include "frt/device.h"
+
+namespace fpga {
+namespace {
+
+using std::chrono::milliseconds;
+
+std::atomic<int> running_count = 0;
+std::atomic<int> max_running_count = 0;
+
+// Simulates for 50 ms and reports scalar arg #0 as its compute time.
+class MockDevice : public internal::Device {
+ public:
+  void SetScalarArg(size_t index, const void* arg, int size) override {
+    memcpy(&value_, arg, sizeof(value_));
+  }
+  void SetBufferArg(size_t index, internal::Tag tag,
+                    const internal::BufferArg& arg) override {}
+  void SetStreamArg(size_t index, internal::Tag tag,
+                    internal::StreamArg& arg) override {}
+  size_t SuspendBuffer(size_t index) override { return 0; }
+
+  void WriteToDevice() override {}
+  void ReadFromDevice() override {}
+  void Exec() override {
+    const int count = ++running_count;
+    int max_count = max_running_count;
+    while (count > max_count &&
+           !max_running_count.compare_exchange_weak(max_count, count)) {
+    }
+  }
+  void Finish() override {
+    std::this_thread::sleep_for(milliseconds(50));
+    --running_count;
+  }
+  void Kill() override {}
+  bool IsFinished() const override { return true; }
+
+  std::vector<ArgInfo> GetArgsInfo() const override { return {}; }
+  int64_t LoadTimeNanoSeconds() const override { return 0; }
+  int64_t ComputeTimeNanoSeconds() const override { return value_; }
+  int64_t StoreTimeNanoSeconds() const override { return 0; }
+  size_t LoadBytes() const override { return 0; }
+  size_t StoreBytes() const override { return 0; }
+
+ private:
+  int value_ = 0;
+};
+
+Instance NewMockInstance(int slot) {
+  return Instance(std::make_unique<MockDevice>());
+}
+
+TEST(CosimFarmTest, RunsArgSetsWithBoundedParallelism) {
+  max_running_count = 0;
+  CosimFarm farm(NewMockInstance, 2);
+  EXPECT_EQ(farm.size(), size_t{2});
+
+  std::vector<std::function<void(Instance&)>> arg_sets;
+  for (int i = 0; i < 6; ++i) {
+    arg_sets.push_back([i](Instance& instance) { instance.SetArgs(i); });
+  }
+  auto tic = std::chrono::steady_clock::now();
+  std::vector<InvocationReport> reports = farm.RunAll(std::move(arg_sets));
+  auto toc = std::chrono::steady_clock::now();
+
+  ASSERT_EQ(reports.size(), size_t{6});
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(reports[i].compute_ns, i);
+  }
+  EXPECT_EQ(max_running_count, 2);
+  // 3 rounds of 2 concurrent runs.
+  EXPECT_GE(toc - tic, milliseconds(150));
+  EXPECT_EQ(farm.pending(), size_t{0});
+}
+
+TEST(CosimFarmTest, CarriesResultsAndErrors) {
+  CosimFarm farm(NewMockInstance, 1);
+  std::future<int64_t> result = farm.Submit(
+      [](Instance& instance) { instance.SetArgs(42); },
+      [](Instance& instance) { return instance.ComputeTimeNanoSeconds(); });
+  std::future<InvocationReport> error = farm.Submit(
+      [](Instance& instance) { throw std::runtime_error("bad args"); });
+
+  EXPECT_EQ(result.get(), 42);
+  EXPECT_THROW(error.get(), std::runtime_error);
+}
+
+}  // namespace
+}  // namespace fpga
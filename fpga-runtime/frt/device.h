@@ -8,10 +8,12 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <functional>
 #include <vector>
 
 #include "frt/arg_info.h"
 #include "frt/buffer_arg.h"
+#include "frt/perf_report.h"
 #include "frt/stream_arg.h"
 #include "frt/tag.h"
 
@@ -34,12 +36,34 @@ class Device {
   virtual void Kill() = 0;
   virtual bool IsFinished() const = 0;
 
+  // Returns whether the device models the computation by running the host
+  // implementation of the program, which is set by `SetSoftwareKernel`.
+  // `SetSoftwareKernel` returns the same.
+  virtual bool UsesSoftwareKernel() const { return false; }
+  virtual bool SetSoftwareKernel(std::function<void()> kernel) {
+    return false;
+  }
+
   virtual std::vector<ArgInfo> GetArgsInfo() const = 0;
   virtual int64_t LoadTimeNanoSeconds() const = 0;
   virtual int64_t ComputeTimeNanoSeconds() const = 0;
   virtual int64_t StoreTimeNanoSeconds() const = 0;
   virtual size_t LoadBytes() const = 0;
   virtual size_t StoreBytes() const = 0;
+
+  // Returns the timestamps of load, compute, and store commands of the last
+  // invocation, or nothing if the device does not record them.
+  virtual std::vector<PerfEvent> GetPerfEvents() const { return {}; }
+
+  // Returns whether buffer arg `index` is copied through host staging memory
+  // on each transfer, and the time such copies took in the last invocation.
+  virtual bool IsBufferStaged(size_t index) const { return false; }
+  virtual int64_t StagingTimeNanoSeconds() const { return 0; }
+
+  // Returns the cycle counters of the last invocation, or empty counters if
+  // the device does not count cycles. Only fast cosim counts cycles; on-board
+  // devices cannot read the counters through OpenCL.
+  virtual CycleCounters GetCycleCounters() const { return {}; }
 };
 
 }  // namespace internal
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/device_group.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <glog/logging.h>
+
+namespace fpga {
+
+DeviceGroup::DeviceGroup(const std::string& bitstream, int device_count) {
+  CHECK_GT(device_count, 0) << "a device group needs at least one device";
+  instances_.reserve(device_count);
+  for (int i = 0; i < device_count; ++i) {
+    instances_.emplace_back(bitstream, i);
+  }
+  LOG(INFO) << "Loaded " << bitstream << " onto " << device_count
+            << " device(s)";
+}
+
+DeviceGroup::DeviceGroup(std::vector<Instance> instances)
+    : instances_(std::move(instances)) {
+  CHECK(!instances_.empty()) << "a device group needs at least one device";
+}
+
+std::pair<size_t, size_t> DeviceGroup::ShardRange(size_t total, size_t index,
+                                                  size_t count) {
+  CHECK_GT(count, 0);
+  CHECK_LT(index, count);
+  const size_t quotient = total / count;
+  const size_t remainder = total % count;
+  const size_t begin = index * quotient + std::min(index, remainder);
+  const size_t end = begin + quotient + (index < remainder ? 1 : 0);
+  return {begin, end};
+}
+
+void DeviceGroup::Run() {
+  auto tic = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  threads.reserve(instances_.size());
+  for (auto& instance : instances_) {
+    threads.emplace_back([&instance] {
+      instance.WriteToDevice();
+      instance.Exec();
+      instance.ReadFromDevice();
+      instance.Finish();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  wall_time_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - tic)
+                      .count();
+}
+
+int64_t DeviceGroup::LoadTimeNanoSeconds() const {
+  int64_t time = 0;
+  for (const auto& instance : instances_) {
+    time = std::max(time, instance.LoadTimeNanoSeconds());
+  }
+  return time;
+}
+
+int64_t DeviceGroup::ComputeTimeNanoSeconds() const {
+  int64_t time = 0;
+  for (const auto& instance : instances_) {
+    time = std::max(time, instance.ComputeTimeNanoSeconds());
+  }
+  return time;
+}
+
+int64_t DeviceGroup::StoreTimeNanoSeconds() const {
+  int64_t time = 0;
+  for (const auto& instance : instances_) {
+    time = std::max(time, instance.StoreTimeNanoSeconds());
+  }
+  return time;
+}
+
+size_t DeviceGroup::LoadBytes() const {
+  size_t bytes = 0;
+  for (const auto& instance : instances_) {
+    bytes += instance.LoadBytes();
+  }
+  return bytes;
+}
+
+size_t DeviceGroup::StoreBytes() const {
+  size_t bytes = 0;
+  for (const auto& instance : instances_) {
+    bytes += instance.StoreBytes();
+  }
+  return bytes;
+}
+
+double DeviceGroup::LoadThroughputGbps() const {
+  return static_cast<double>(LoadBytes()) /
+         static_cast<double>(LoadTimeNanoSeconds());
+}
+
+double DeviceGroup::StoreThroughputGbps() const {
+  return static_cast<double>(StoreBytes()) /
+         static_cast<double>(StoreTimeNanoSeconds());
+}
+
+}  // namespace fpga
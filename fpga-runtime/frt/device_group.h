@@ -0,0 +1,107 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_DEVICE_GROUP_H_
+#define FPGA_RUNTIME_DEVICE_GROUP_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "frt.h"
+#include "frt/buffer.h"
+#include "frt/tag.h"
+
+namespace fpga {
+
+// A group of identical devices loaded with the same bitstream. Each member
+// owns its own `Instance` (and therefore its own command queue); invocations
+// run on all members concurrently and timing counters are aggregated.
+class DeviceGroup {
+ public:
+  // Loads `bitstream` onto `device_count` matching devices.
+  DeviceGroup(const std::string& bitstream, int device_count);
+
+  // Takes ownership of already-created instances.
+  explicit DeviceGroup(std::vector<Instance> instances);
+
+  // Move-only.
+  DeviceGroup(DeviceGroup&&) = default;
+  DeviceGroup& operator=(DeviceGroup&&) = default;
+
+  // Returns the number of devices in the group.
+  size_t size() const { return instances_.size(); }
+
+  // Returns the instance of the `index`-th device.
+  Instance& operator[](size_t index) { return instances_[index]; }
+  const Instance& operator[](size_t index) const { return instances_[index]; }
+
+  // Returns the half-open range of `total` items (batch indices or channels of
+  // an `mmaps` array) assigned to shard `index` out of `count` shards. Items
+  // are split into contiguous ranges whose sizes differ by at most one.
+  static std::pair<size_t, size_t> ShardRange(size_t total, size_t index,
+                                              size_t count);
+
+  // Returns the part of `buffer` assigned to the `index`-th device.
+  template <typename T, internal::Tag tag>
+  internal::Buffer<T, tag> Shard(internal::Buffer<T, tag> buffer,
+                                 size_t index) const {
+    CHECK_LT(index, size());
+    auto [begin, end] = ShardRange(buffer.Size(), index, size());
+    return internal::Buffer<T, tag>(buffer.Get() + begin, end - begin);
+  }
+
+  // Calls `set_args(instance, index)` for each device to bind its shard of the
+  // arguments, then writes, executes, reads, and finishes all devices
+  // concurrently. Stream arguments are not supported.
+  template <typename Func>
+  DeviceGroup& Invoke(Func&& set_args) {
+    for (size_t i = 0; i < instances_.size(); ++i) {
+      set_args(instances_[i], i);
+    }
+    Run();
+    return *this;
+  }
+
+  // Runs `WriteToDevice`, `Exec`, `ReadFromDevice`, and `Finish` on all
+  // devices concurrently, one thread per device, and waits for all of them.
+  void Run();
+
+  // Returns the wall-clock time of the last `Run` in nanoseconds.
+  int64_t WallTimeNanoSeconds() const { return wall_time_ns_; }
+
+  // Returns the longest load time among all devices in nanoseconds.
+  int64_t LoadTimeNanoSeconds() const;
+
+  // Returns the longest compute time among all devices in nanoseconds.
+  int64_t ComputeTimeNanoSeconds() const;
+
+  // Returns the longest store time among all devices in nanoseconds.
+  int64_t StoreTimeNanoSeconds() const;
+
+  // Returns the total number of bytes written to all devices.
+  size_t LoadBytes() const;
+
+  // Returns the total number of bytes read from all devices.
+  size_t StoreBytes() const;
+
+  // Returns the aggregated load throughput in GB/s.
+  double LoadThroughputGbps() const;
+
+  // Returns the aggregated store throughput in GB/s.
+  double StoreThroughputGbps() const;
+
+ private:
+  std::vector<Instance> instances_;
+  int64_t wall_time_ns_ = 0;
+};
+
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_DEVICE_GROUP_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/device_group.h"
+
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "frt.h"
+#include "frt/device.h"
+
+namespace fpga {
+namespace {
+
+using std::chrono::milliseconds;
+
+constexpr auto kComputeTime = milliseconds(100);
+
+// Doubles every int in buffer arg #0 after sleeping for `kComputeTime`.
+class MockDevice : public internal::Device {
+ public:
+  void SetScalarArg(size_t index, const void* arg, int size) override {}
+  void SetBufferArg(size_t index, internal::Tag tag,
+                    const internal::BufferArg& arg) override {
+    buffers_[index] = arg;
+  }
+  void SetStreamArg(size_t index, internal::Tag tag,
+                    internal::StreamArg& arg) override {}
+  size_t SuspendBuffer(size_t index) override { return 0; }
+
+  void WriteToDevice() override {}
+  void ReadFromDevice() override {}
+  void Exec() override { is_finished_ = false; }
+  void Finish() override {
+    std::this_thread::sleep_for(kComputeTime);
+    const internal::BufferArg& arg = buffers_.at(0);
+    int* data = reinterpret_cast<int*>(arg.Get());
+    for (size_t i = 0; i < arg.SizeInCount(); ++i) {
+      data[i] *= 2;
+    }
+    is_finished_ = true;
+  }
+  void Kill() override {}
+  bool IsFinished() const override { return is_finished_; }
+
+  std::vector<ArgInfo> GetArgsInfo() const override { return {}; }
+  int64_t LoadTimeNanoSeconds() const override { return 1; }
+  int64_t ComputeTimeNanoSeconds() const override {
+    return std::chrono::nanoseconds(kComputeTime).count();
+  }
+  int64_t StoreTimeNanoSeconds() const override { return 1; }
+  size_t LoadBytes() const override { return buffers_.at(0).SizeInBytes(); }
+  size_t StoreBytes() const override { return buffers_.at(0).SizeInBytes(); }
+
+ private:
+  std::unordered_map<int, internal::BufferArg> buffers_;
+  bool is_finished_ = true;
+};
+
+DeviceGroup NewMockGroup(int device_count) {
+  std::vector<Instance> instances;
+  for (int i = 0; i < device_count; ++i) {
+    instances.emplace_back(std::make_unique<MockDevice>());
+  }
+  return DeviceGroup(std::move(instances));
+}
+
+TEST(DeviceGroupTest, ShardRangeCoversAllItems) {
+  constexpr size_t kTotal = 10;
+  constexpr size_t kCount = 4;
+  size_t expected_begin = 0;
+  for (size_t i = 0; i < kCount; ++i) {
+    auto [begin, end] = DeviceGroup::ShardRange(kTotal, i, kCount);
+    EXPECT_EQ(begin, expected_begin);
+    EXPECT_EQ(end - begin, i < kTotal % kCount ? 3u : 2u);
+    expected_begin = end;
+  }
+  EXPECT_EQ(expected_begin, kTotal);
+}
+
+TEST(DeviceGroupTest, ShardRangeWithMoreShardsThanItems) {
+  EXPECT_EQ(DeviceGroup::ShardRange(2, 0, 4), std::make_pair(0UL, 1UL));
+  EXPECT_EQ(DeviceGroup::ShardRange(2, 1, 4), std::make_pair(1UL, 2UL));
+  EXPECT_EQ(DeviceGroup::ShardRange(2, 3, 4), std::make_pair(2UL, 2UL));
+}
+
+TEST(DeviceGroupTest, InvokeShardsBuffersAndRunsConcurrently) {
+  constexpr int kDeviceCount = 4;
+  DeviceGroup group = NewMockGroup(kDeviceCount);
+  ASSERT_EQ(group.size(), static_cast<size_t>(kDeviceCount));
+
+  std::vector<int> data(1001);
+  std::iota(data.begin(), data.end(), 0);
+  auto buffer = ReadWrite(data.data(), data.size());
+  group.Invoke([&](Instance& instance, size_t index) {
+    instance.SetArgs(group.Shard(buffer, index));
+  });
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(data[i], static_cast<int>(i * 2)) << "i = " << i;
+  }
+
+  // Devices run concurrently, so the wall time is much less than the sum.
+  EXPECT_LT(
+      group.WallTimeNanoSeconds(),
+      std::chrono::nanoseconds(kComputeTime * (kDeviceCount - 1)).count());
+  EXPECT_EQ(group.ComputeTimeNanoSeconds(),
+            std::chrono::nanoseconds(kComputeTime).count());
+  EXPECT_EQ(group.LoadBytes(), data.size() * sizeof(int));
+  EXPECT_EQ(group.StoreBytes(), data.size() * sizeof(int));
+}
+
+}  // namespace
+}  // namespace fpga
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/aligned_buffer_pool.h"
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <mutex>
+
+#include <glog/logging.h>
+
+namespace fpga {
+namespace internal {
+
+namespace {
+
+constexpr size_t kDefaultMaxCachedBytes = size_t{1} << 30;
+
+}  // namespace
+
+void AlignedBufferPool::Deleter::operator()(char* data) const {
+  if (pool_ != nullptr) {
+    pool_->Release(data, capacity_);
+  } else {
+    free(data);
+  }
+}
+
+AlignedBufferPool::AlignedBufferPool(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes) {}
+
+AlignedBufferPool::~AlignedBufferPool() {
+  for (auto& [capacity, data] : free_buffers_) {
+    free(data);
+  }
+}
+
+AlignedBufferPool& AlignedBufferPool::Default() {
+  // Never destroyed so that buffers may be released during static destruction.
+  static auto* pool = new AlignedBufferPool(kDefaultMaxCachedBytes);
+  return *pool;
+}
+
+AlignedBufferPool::Buffer AlignedBufferPool::Acquire(size_t size) {
+  const size_t capacity =
+      std::max<size_t>((size + kAlignment - 1) / kAlignment, 1) * kAlignment;
+  {
+    std::unique_lock lock(mtx_);
+    // Reuse the smallest cached buffer that is large enough, but do not waste
+    // more than half of it.
+    if (auto it = free_buffers_.lower_bound(capacity);
+        it != free_buffers_.end() && it->first / 2 <= capacity) {
+      auto [cached_capacity, data] = *it;
+      free_buffers_.erase(it);
+      cached_bytes_ -= cached_capacity;
+      return Buffer(data, Deleter(this, cached_capacity));
+    }
+  }
+
+  auto* data = static_cast<char*>(aligned_alloc(kAlignment, capacity));
+  PLOG_IF(FATAL, data == nullptr)
+      << "Cannot allocate " << capacity << " bytes of aligned host memory";
+  return Buffer(data, Deleter(this, capacity));
+}
+
+size_t AlignedBufferPool::cached_bytes() const {
+  std::unique_lock lock(mtx_);
+  return cached_bytes_;
+}
+
+void AlignedBufferPool::Release(char* data, size_t capacity) {
+  {
+    std::unique_lock lock(mtx_);
+    if (cached_bytes_ + capacity <= max_cached_bytes_) {
+      free_buffers_.insert({capacity, data});
+      cached_bytes_ += capacity;
+      return;
+    }
+  }
+  free(data);
+}
+
+}  // namespace internal
+}  // namespace fpga
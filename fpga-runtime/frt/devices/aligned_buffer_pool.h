@@ -0,0 +1,76 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_ALIGNED_BUFFER_POOL_H_
+#define FPGA_RUNTIME_ALIGNED_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace fpga {
+namespace internal {
+
+// A pool of page-aligned host buffers, used to stage unaligned buffer
+// arguments. Released buffers are cached and handed out again so that repeated
+// invocations do not allocate and fault in fresh pages each time.
+class AlignedBufferPool {
+ public:
+  static constexpr size_t kAlignment = 4096;
+
+  class Deleter {
+   public:
+    Deleter() = default;
+    Deleter(AlignedBufferPool* pool, size_t capacity)
+        : pool_(pool), capacity_(capacity) {}
+
+    void operator()(char* data) const;
+
+   private:
+    AlignedBufferPool* pool_ = nullptr;
+    size_t capacity_ = 0;
+  };
+
+  // Returns the buffer to the pool on destruction.
+  using Buffer = std::unique_ptr<char[], Deleter>;
+
+  // Buffers are freed instead of cached once `max_cached_bytes` are cached.
+  explicit AlignedBufferPool(size_t max_cached_bytes);
+
+  // Not copyable or movable.
+  AlignedBufferPool(const AlignedBufferPool&) = delete;
+  AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+  ~AlignedBufferPool();
+
+  // Returns the process-wide pool.
+  static AlignedBufferPool& Default();
+
+  // Returns a `kAlignment`-aligned buffer of at least `size` bytes.
+  Buffer Acquire(size_t size);
+
+  // Returns the number of bytes cached for reuse.
+  size_t cached_bytes() const;
+
+ private:
+  void Release(char* data, size_t capacity);
+
+  const size_t max_cached_bytes_;
+  mutable std::mutex mtx_;
+  std::multimap<size_t, char*> free_buffers_;  // Keyed by capacity.
+  size_t cached_bytes_ = 0;
+};
+
+// Returns whether `ptr` is aligned for zero-copy buffers.
+inline bool IsPageAligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % AlignedBufferPool::kAlignment == 0;
+}
+
+}  // namespace internal
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_ALIGNED_BUFFER_POOL_H_
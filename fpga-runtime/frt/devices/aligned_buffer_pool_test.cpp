@@ -0,0 +1,57 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/aligned_buffer_pool.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+namespace fpga::internal {
+namespace {
+
+constexpr size_t kPage = AlignedBufferPool::kAlignment;
+
+TEST(AlignedBufferPoolTest, AcquiresAlignedBuffers) {
+  AlignedBufferPool pool(/*max_cached_bytes=*/0);
+  for (size_t size : {size_t{0}, size_t{1}, kPage, kPage + 1}) {
+    AlignedBufferPool::Buffer buffer = pool.Acquire(size);
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_TRUE(IsPageAligned(buffer.get()));
+    memset(buffer.get(), 0xff, size);
+  }
+  EXPECT_EQ(pool.cached_bytes(), size_t{0});
+}
+
+TEST(AlignedBufferPoolTest, ReusesReleasedBuffers) {
+  AlignedBufferPool pool(/*max_cached_bytes=*/kPage * 16);
+  char* data = pool.Acquire(kPage * 3).get();
+  EXPECT_EQ(pool.cached_bytes(), kPage * 3);
+
+  // Large enough and not too large.
+  EXPECT_EQ(pool.Acquire(kPage * 2 + 1).get(), data);
+
+  // Too large to waste.
+  AlignedBufferPool::Buffer buffer = pool.Acquire(kPage);
+  EXPECT_NE(buffer.get(), data);
+  EXPECT_EQ(pool.cached_bytes(), kPage * 3);
+}
+
+TEST(AlignedBufferPoolTest, FreesBuffersBeyondLimit) {
+  AlignedBufferPool pool(/*max_cached_bytes=*/kPage * 2);
+  { AlignedBufferPool::Buffer buffer = pool.Acquire(kPage * 3); }
+  EXPECT_EQ(pool.cached_bytes(), size_t{0});
+  { AlignedBufferPool::Buffer buffer = pool.Acquire(kPage * 2); }
+  EXPECT_EQ(pool.cached_bytes(), kPage * 2);
+}
+
+TEST(AlignedBufferPoolTest, IsPageAligned) {
+  alignas(kPage) static char data[kPage * 2];
+  EXPECT_TRUE(IsPageAligned(data));
+  EXPECT_FALSE(IsPageAligned(data + 8));
+  EXPECT_TRUE(IsPageAligned(data + kPage));
+}
+
+}  // namespace
+}  // namespace fpga::internal
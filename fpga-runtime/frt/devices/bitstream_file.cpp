@@ -0,0 +1,154 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/bitstream_file.h"
+
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+#include <nlohmann/json.hpp>
+
+#include "frt/arg_info.h"
+#include "frt/devices/filesystem.h"
+
+namespace fpga {
+namespace internal {
+
+namespace {
+
+// Bump this when the cache format or the parsed metadata changes.
+constexpr int kCacheVersion = 1;
+
+// Number of bytes hashed at each end of the content.
+constexpr size_t kHashedBytes = 64 * 1024;
+
+uint64_t Fnv1a(std::string_view data, uint64_t hash) {
+  for (unsigned char byte : data) {
+    hash ^= byte;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+BitstreamFile::BitstreamFile(const std::string& path) : path_(path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  PLOG_IF(FATAL, fd < 0) << "Cannot open '" << path << "'";
+  struct stat stat_buf;
+  PLOG_IF(FATAL, fstat(fd, &stat_buf) != 0) << "Cannot stat '" << path << "'";
+  size_ = stat_buf.st_size;
+  mtime_ns_ = int64_t{stat_buf.st_mtim.tv_sec} * 1000000000 +
+              stat_buf.st_mtim.tv_nsec;
+  if (size_ > 0) {
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    PLOG_IF(FATAL, data_ == MAP_FAILED) << "Cannot mmap '" << path << "'";
+  }
+  close(fd);
+}
+
+BitstreamFile::~BitstreamFile() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+std::optional<std::vector<ArgInfo>> BitstreamFile::LoadCachedArgsInfo() const {
+  std::ifstream cache_file(GetCachePath());
+  if (!cache_file) {
+    return std::nullopt;
+  }
+  try {
+    const nlohmann::json json = nlohmann::json::parse(cache_file);
+    if (json.at("version") != kCacheVersion || json.at("size") != size_ ||
+        json.at("mtime_ns") != mtime_ns_ ||
+        json.at("hash") != GetContentHash()) {
+      VLOG(1) << "Ignoring stale metadata cache for '" << path_ << "'";
+      return std::nullopt;
+    }
+    std::vector<ArgInfo> args;
+    for (const auto& arg_json : json.at("args")) {
+      args.push_back({
+          .index = arg_json.at("index"),
+          .name = arg_json.at("name"),
+          .type = arg_json.at("type"),
+          .cat = arg_json.at("cat"),
+      });
+    }
+    VLOG(1) << "Loaded metadata cache for '" << path_ << "'";
+    return args;
+  } catch (const nlohmann::json::exception& e) {
+    LOG(WARNING) << "Ignoring corrupted metadata cache '" << GetCachePath()
+                 << "': " << e.what();
+    return std::nullopt;
+  }
+}
+
+void BitstreamFile::StoreCachedArgsInfo(
+    const std::vector<ArgInfo>& args) const {
+  nlohmann::json json;
+  json["version"] = kCacheVersion;
+  json["size"] = size_;
+  json["mtime_ns"] = mtime_ns_;
+  json["hash"] = GetContentHash();
+  nlohmann::json& args_json = json["args"] = nlohmann::json::array();
+  for (const auto& arg : args) {
+    args_json.push_back({
+        {"index", arg.index},
+        {"name", arg.name},
+        {"type", arg.type},
+        {"cat", arg.cat},
+    });
+  }
+
+  // Write to a temporary file and rename it so that concurrent launches never
+  // observe a partially written cache.
+  const std::string cache_path = GetCachePath();
+  const std::string tmp_path = cache_path + "." + std::to_string(getpid());
+  if (!(std::ofstream(tmp_path) << json.dump(2))) {
+    VLOG(1) << "Cannot write metadata cache '" << tmp_path << "'";
+    return;
+  }
+  std::error_code ec;
+  fs::rename(tmp_path, cache_path, ec);
+  if (ec) {
+    VLOG(1) << "Cannot write metadata cache '" << cache_path
+            << "': " << ec.message();
+    fs::remove(tmp_path, ec);
+  }
+}
+
+std::string BitstreamFile::GetCachePath() const {
+  const fs::path path = fs::absolute(path_);
+  return (path.parent_path() / ("." + path.filename().string() + ".frt.json"))
+      .string();
+}
+
+uint64_t BitstreamFile::GetContentHash() const {
+  const std::string_view data = content();
+  uint64_t hash = Fnv1a(
+      std::string_view(reinterpret_cast<const char*>(&size_), sizeof(size_)),
+      0xcbf29ce484222325ULL);
+  hash = Fnv1a(data.substr(0, kHashedBytes), hash);
+  if (data.size() > kHashedBytes) {
+    const size_t tail = std::max(kHashedBytes, data.size() - kHashedBytes);
+    hash = Fnv1a(data.substr(tail), hash);
+  }
+  return hash;
+}
+
+}  // namespace internal
+}  // namespace fpga
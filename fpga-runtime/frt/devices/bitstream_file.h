@@ -0,0 +1,65 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_BITSTREAM_FILE_H_
+#define FPGA_RUNTIME_BITSTREAM_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "frt/arg_info.h"
+
+namespace fpga {
+namespace internal {
+
+// A read-only memory mapping of a bitstream file. Device backends inspect only
+// the sections they need instead of copying the whole file.
+//
+// Parsed argument metadata can be cached next to the bitstream, keyed by the
+// file size, mtime, and a content hash, so that repeated launches skip
+// decompression and XML/YAML parsing altogether.
+class BitstreamFile {
+ public:
+  // Maps `path` into memory. Fails fatally if the file cannot be mapped.
+  explicit BitstreamFile(const std::string& path);
+  BitstreamFile(const BitstreamFile&) = delete;
+  BitstreamFile& operator=(const BitstreamFile&) = delete;
+  BitstreamFile(BitstreamFile&&) = delete;
+  BitstreamFile& operator=(BitstreamFile&&) = delete;
+  ~BitstreamFile();
+
+  const std::string& path() const { return path_; }
+  std::string_view content() const {
+    return {static_cast<const char*>(data_), size_};
+  }
+
+  // Returns the cached args info if the cache is present and up-to-date.
+  std::optional<std::vector<ArgInfo>> LoadCachedArgsInfo() const;
+
+  // Caches `args` next to the bitstream. Failures are not fatal.
+  void StoreCachedArgsInfo(const std::vector<ArgInfo>& args) const;
+
+ private:
+  std::string GetCachePath() const;
+
+  // Hashes the size and the head and tail of the content. Together with the
+  // mtime this detects rewritten bitstreams without reading the whole file.
+  uint64_t GetContentHash() const;
+
+  const std::string path_;
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  int64_t mtime_ns_ = 0;
+};
+
+}  // namespace internal
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_BITSTREAM_FILE_H_
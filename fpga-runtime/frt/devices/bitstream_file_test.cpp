@@ -0,0 +1,81 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/bitstream_file.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "frt/arg_info.h"
+#include "frt/devices/filesystem.h"
+
+namespace fpga::internal {
+namespace {
+
+class BitstreamFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = fs::temp_directory_path() /
+           ("frt-bitstream-test." + std::to_string(getpid()));
+    fs::create_directories(dir_);
+    path_ = (dir_ / "kernel.xo").string();
+    Write("PK\3\4 fake bitstream");
+  }
+
+  void TearDown() override { fs::remove_all(dir_); }
+
+  void Write(const std::string& content) {
+    std::ofstream(path_, std::ios::binary | std::ios::trunc) << content;
+  }
+
+  fs::path dir_;
+  std::string path_;
+  const std::vector<ArgInfo> args_ = {
+      {.index = 0, .name = "n", .type = "int", .cat = ArgInfo::kScalar},
+      {.index = 1, .name = "mem", .type = "float*", .cat = ArgInfo::kMmap},
+  };
+};
+
+TEST_F(BitstreamFileTest, MapsContent) {
+  BitstreamFile file(path_);
+  EXPECT_EQ(file.path(), path_);
+  EXPECT_EQ(file.content(), std::string_view("PK\3\4 fake bitstream"));
+}
+
+TEST_F(BitstreamFileTest, MissingCacheReturnsNullopt) {
+  EXPECT_FALSE(BitstreamFile(path_).LoadCachedArgsInfo().has_value());
+}
+
+TEST_F(BitstreamFileTest, CachedArgsInfoRoundTrips) {
+  BitstreamFile(path_).StoreCachedArgsInfo(args_);
+
+  auto args = BitstreamFile(path_).LoadCachedArgsInfo();
+  ASSERT_TRUE(args.has_value());
+  ASSERT_EQ(args->size(), args_.size());
+  for (size_t i = 0; i < args_.size(); ++i) {
+    EXPECT_EQ((*args)[i].index, args_[i].index);
+    EXPECT_EQ((*args)[i].name, args_[i].name);
+    EXPECT_EQ((*args)[i].type, args_[i].type);
+    EXPECT_EQ((*args)[i].cat, args_[i].cat);
+  }
+}
+
+TEST_F(BitstreamFileTest, CacheIsInvalidatedByNewContent) {
+  BitstreamFile(path_).StoreCachedArgsInfo(args_);
+  const auto mtime = fs::last_write_time(path_);
+
+  // Same size and mtime, different content.
+  Write("PK\3\4 fake bitstreaM");
+  fs::last_write_time(path_, mtime);
+
+  EXPECT_FALSE(BitstreamFile(path_).LoadCachedArgsInfo().has_value());
+}
+
+}  // namespace
+}  // namespace fpga::internal
@@ -7,6 +7,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include <elf.h>
 
@@ -14,6 +15,7 @@
 #include <tinyxml2.h>
 #include <CL/cl2.hpp>
 
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/opencl_device_matcher.h"
 #include "frt/devices/opencl_util.h"
 #include "frt/stream_arg.h"
@@ -50,7 +52,8 @@ class DeviceMatcher : public OpenclDeviceMatcher {
 
 }  // namespace
 
-IntelOpenclDevice::IntelOpenclDevice(const cl::Program::Binaries& binaries) {
+IntelOpenclDevice::IntelOpenclDevice(const cl::Program::Binaries& binaries,
+                                     int device_index) {
   std::string target_device_name;
   std::string vendor_name;
   std::vector<std::string> kernel_names;
@@ -134,16 +137,18 @@ IntelOpenclDevice::IntelOpenclDevice(const cl::Program::Binaries& binaries) {
   }
 
   Initialize(binaries, vendor_name, DeviceMatcher(target_device_name),
-             kernel_names, kernel_arg_counts);
+             kernel_names, kernel_arg_counts, device_index);
 }
 
 std::unique_ptr<Device> IntelOpenclDevice::New(
-    const cl::Program::Binaries& binaries) {
-  if (binaries.size() != 1 || binaries.begin()->size() < SELFMAG ||
-      memcmp(binaries.begin()->data(), ELFMAG, SELFMAG) != 0) {
+    const BitstreamFile& bitstream, int device_index) {
+  const std::string_view content = bitstream.content();
+  if (content.size() < SELFMAG ||
+      memcmp(content.data(), ELFMAG, SELFMAG) != 0) {
     return nullptr;
   }
-  return std::make_unique<IntelOpenclDevice>(binaries);
+  const cl::Program::Binaries binaries = {{content.begin(), content.end()}};
+  return std::make_unique<IntelOpenclDevice>(binaries, device_index);
 }
 
 void IntelOpenclDevice::SetStreamArg(size_t index, Tag tag, StreamArg& arg) {
@@ -12,6 +12,7 @@
 
 #include <CL/cl2.hpp>
 
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/opencl_device.h"
 
 namespace fpga {
@@ -19,9 +20,11 @@ namespace internal {
 
 class IntelOpenclDevice : public OpenclDevice {
  public:
-  IntelOpenclDevice(const cl::Program::Binaries& binaries);
+  explicit IntelOpenclDevice(const cl::Program::Binaries& binaries,
+                             int device_index = 0);
 
-  static std::unique_ptr<Device> New(const cl::Program::Binaries& binaries);
+  static std::unique_ptr<Device> New(const BitstreamFile& bitstream,
+                                     int device_index = 0);
 
   void SetStreamArg(size_t index, Tag tag, StreamArg& arg) override;
   void WriteToDevice() override;
@@ -0,0 +1,328 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/model_device.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+#include <nlohmann/json.hpp>
+
+#include "frt/arg_info.h"
+#include "frt/buffer_arg.h"
+#include "frt/devices/bitstream_file.h"
+#include "frt/stream_arg.h"
+#include "frt/tag.h"
+
+namespace fpga {
+namespace internal {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::string_view kManifestKind = "frt-model-device";
+
+int64_t ToNanoSeconds(clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+std::chrono::nanoseconds Microseconds(double us) {
+  return std::chrono::nanoseconds(static_cast<int64_t>(us * 1e3));
+}
+
+ArgInfo::Cat ParseArgCat(const std::string& cat) {
+  if (cat == "scalar") {
+    return ArgInfo::kScalar;
+  }
+  if (cat == "mmap") {
+    return ArgInfo::kMmap;
+  }
+  if (cat == "istream" || cat == "ostream" || cat == "stream") {
+    return ArgInfo::kStream;
+  }
+  if (cat == "istreams" || cat == "ostreams" || cat == "streams") {
+    return ArgInfo::kStreams;
+  }
+  LOG(FATAL) << "Unknown argument category: " << cat;
+  return ArgInfo::kScalar;
+}
+
+}  // namespace
+
+ModelDevice::ModelDevice(Options options) : options_(std::move(options)) {
+  LOG(INFO) << "Using model device; PCIe bandwidth: "
+            << options_.bandwidth_gbps << " GB/s, latency: "
+            << options_.latency.count() << " ns, compute: "
+            << (options_.run_software_kernel
+                    ? "software kernel"
+                    : std::to_string(options_.compute_duration.count()) +
+                          " ns");
+}
+
+ModelDevice::~ModelDevice() {
+  Kill();
+  if (compute_thread_.joinable()) {
+    compute_thread_.join();
+  }
+}
+
+std::unique_ptr<Device> ModelDevice::New(const BitstreamFile& bitstream,
+                                         int device_index) {
+  std::unique_ptr<Options> options = ParseManifest(bitstream.content());
+  if (options == nullptr) {
+    return nullptr;
+  }
+  LOG_IF(FATAL, device_index < 0 || device_index >= options->device_count)
+      << "Model device #" << device_index << " requested but "
+      << bitstream.path() << " models only " << options->device_count
+      << " device(s)";
+  VLOG(1) << "Model device #" << device_index << " from " << bitstream.path();
+  return std::make_unique<ModelDevice>(std::move(*options));
+}
+
+std::unique_ptr<ModelDevice::Options> ModelDevice::ParseManifest(
+    std::string_view manifest) {
+  // Avoid parsing binary bitstreams as JSON.
+  const size_t begin = manifest.find_first_not_of(" \t\r\n");
+  if (begin == std::string_view::npos || manifest[begin] != '{') {
+    return nullptr;
+  }
+  const nlohmann::json json = nlohmann::json::parse(
+      manifest, /*cb=*/nullptr, /*allow_exceptions=*/false);
+  if (!json.is_object() || json.value("kind", "") != kManifestKind) {
+    return nullptr;
+  }
+
+  auto options = std::make_unique<Options>();
+  try {
+    for (const auto& arg_json : json.value("args", nlohmann::json::array())) {
+      options->args.push_back({
+          .index = static_cast<int>(options->args.size()),
+          .name = arg_json.at("name"),
+          .type = arg_json.value("type", ""),
+          .cat = ParseArgCat(arg_json.at("cat")),
+      });
+    }
+
+    const nlohmann::json pcie = json.value("pcie", nlohmann::json::object());
+    options->bandwidth_gbps = pcie.value("bandwidth_gbps", 0.);
+    options->latency = Microseconds(pcie.value("latency_us", 0.));
+
+    const nlohmann::json compute =
+        json.value("compute", nlohmann::json::object());
+    const std::string mode = compute.value("mode", "fixed");
+    if (mode == "software") {
+      options->run_software_kernel = true;
+    } else if (mode == "fixed") {
+      options->compute_duration =
+          Microseconds(compute.value("duration_us", 0.));
+    } else {
+      LOG(FATAL) << "Unknown model device compute mode: " << mode;
+    }
+
+    options->device_count = json.value("device_count", 1);
+    LOG_IF(FATAL, options->device_count <= 0)
+        << "Invalid model device count: " << options->device_count;
+  } catch (const nlohmann::json::exception& e) {
+    LOG(FATAL) << "Invalid model device manifest: " << e.what();
+  }
+  return options;
+}
+
+bool ModelDevice::UsesSoftwareKernel() const {
+  return options_.run_software_kernel;
+}
+
+bool ModelDevice::SetSoftwareKernel(std::function<void()> kernel) {
+  if (!UsesSoftwareKernel()) {
+    return false;
+  }
+  software_kernel_ = std::move(kernel);
+  return true;
+}
+
+void ModelDevice::SetScalarArg(size_t index, const void* arg, int size) {
+  arg_indices_.insert(index);
+}
+
+void ModelDevice::SetBufferArg(size_t index, Tag tag, const BufferArg& arg) {
+  arg_indices_.insert(index);
+  buffer_table_.insert_or_assign(index, arg);
+  if (tag == Tag::kReadOnly || tag == Tag::kReadWrite) {
+    store_indices_.insert(index);
+  }
+  if (tag == Tag::kWriteOnly || tag == Tag::kReadWrite) {
+    load_indices_.insert(index);
+  }
+}
+
+void ModelDevice::SetStreamArg(size_t index, Tag tag, StreamArg& arg) {
+  // Streams are accessed by the software kernel directly, if any.
+  arg_indices_.insert(index);
+}
+
+size_t ModelDevice::SuspendBuffer(size_t index) {
+  return load_indices_.erase(index) + store_indices_.erase(index);
+}
+
+void ModelDevice::WriteToDevice() {
+  is_write_to_device_scheduled_ = true;
+  load_event_.queued_ns = ToNanoSeconds(clock::now());
+}
+
+void ModelDevice::ReadFromDevice() {
+  is_read_from_device_scheduled_ = true;
+  store_event_.queued_ns = ToNanoSeconds(clock::now());
+}
+
+void ModelDevice::Exec() {
+  LOG_IF(FATAL, options_.run_software_kernel && !software_kernel_)
+      << "The model device is configured to run a software kernel but none "
+         "is set";
+  {
+    std::unique_lock lock(mtx_);
+    is_killed_ = false;
+  }
+  if (is_write_to_device_scheduled_) {
+    auto tic = clock::now();
+    Transfer(load_indices_);
+    auto toc = clock::now();
+    load_time_ = toc - tic;
+    load_event_.submit_ns = load_event_.start_ns = ToNanoSeconds(tic);
+    load_event_.end_ns = ToNanoSeconds(toc);
+  }
+
+  if (compute_thread_.joinable()) {
+    compute_thread_.join();
+  }
+  is_finished_ = false;
+  compute_event_.queued_ns = ToNanoSeconds(clock::now());
+  compute_event_.end_ns = 0;
+  compute_thread_ = std::thread([this] {
+    auto tic = clock::now();
+    if (options_.run_software_kernel) {
+      software_kernel_();
+    } else {
+      SleepFor(options_.compute_duration);
+    }
+    auto toc = clock::now();
+    compute_time_ = toc - tic;
+    compute_event_.submit_ns = compute_event_.start_ns = ToNanoSeconds(tic);
+    compute_event_.end_ns = ToNanoSeconds(toc);
+    is_finished_ = true;
+  });
+}
+
+void ModelDevice::Finish() {
+  LOG_IF(FATAL, !compute_thread_.joinable())
+      << "Exec() must be called before Finish()";
+  compute_thread_.join();
+
+  if (is_read_from_device_scheduled_) {
+    auto tic = clock::now();
+    Transfer(store_indices_);
+    auto toc = clock::now();
+    store_time_ = toc - tic;
+    store_event_.submit_ns = store_event_.start_ns = ToNanoSeconds(tic);
+    store_event_.end_ns = ToNanoSeconds(toc);
+  }
+}
+
+void ModelDevice::Kill() {
+  std::unique_lock lock(mtx_);
+  is_killed_ = true;
+  killed_cv_.notify_all();
+  LOG_IF(WARNING, options_.run_software_kernel && !is_finished_)
+      << "The software kernel cannot be killed; waiting for it to finish";
+}
+
+bool ModelDevice::IsFinished() const { return is_finished_; }
+
+std::vector<ArgInfo> ModelDevice::GetArgsInfo() const {
+  if (!options_.args.empty()) {
+    return options_.args;
+  }
+
+  // Without args in the manifest, report the args set so far.
+  std::vector<ArgInfo> args;
+  for (int index = 0; arg_indices_.count(index); ++index) {
+    args.push_back({
+        .index = index,
+        .name = "arg" + std::to_string(index),
+        .type = "",
+        .cat = buffer_table_.count(index) ? ArgInfo::kMmap : ArgInfo::kScalar,
+    });
+  }
+  return args;
+}
+
+int64_t ModelDevice::LoadTimeNanoSeconds() const { return load_time_.count(); }
+
+int64_t ModelDevice::ComputeTimeNanoSeconds() const {
+  return compute_time_.count();
+}
+
+int64_t ModelDevice::StoreTimeNanoSeconds() const {
+  return store_time_.count();
+}
+
+size_t ModelDevice::LoadBytes() const {
+  size_t total_size = 0;
+  for (int index : load_indices_) {
+    total_size += buffer_table_.at(index).SizeInBytes();
+  }
+  return total_size;
+}
+
+size_t ModelDevice::StoreBytes() const {
+  size_t total_size = 0;
+  for (int index : store_indices_) {
+    total_size += buffer_table_.at(index).SizeInBytes();
+  }
+  return total_size;
+}
+
+std::vector<PerfEvent> ModelDevice::GetPerfEvents() const {
+  std::vector<PerfEvent> events;
+  for (const PerfEvent* event :
+       {&load_event_, &compute_event_, &store_event_}) {
+    if (event->end_ns > 0) {
+      events.push_back(*event);
+    }
+  }
+  return events;
+}
+
+CycleCounters ModelDevice::GetCycleCounters() const { return {}; }
+
+void ModelDevice::Transfer(const std::unordered_set<int>& indices) {
+  std::chrono::nanoseconds duration{0};
+  for (int index : indices) {
+    duration += options_.latency;
+    if (options_.bandwidth_gbps > 0) {
+      // 1 GB/s is 1 byte/ns.
+      duration += std::chrono::nanoseconds(static_cast<int64_t>(
+          buffer_table_.at(index).SizeInBytes() / options_.bandwidth_gbps));
+    }
+  }
+  SleepFor(duration);
+}
+
+void ModelDevice::SleepFor(std::chrono::nanoseconds duration) {
+  std::unique_lock lock(mtx_);
+  killed_cv_.wait_for(lock, duration, [this] { return is_killed_; });
+}
+
+}  // namespace internal
+}  // namespace fpga
@@ -0,0 +1,135 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_MODEL_DEVICE_H_
+#define FPGA_RUNTIME_MODEL_DEVICE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "frt/arg_info.h"
+#include "frt/buffer_arg.h"
+#include "frt/device.h"
+#include "frt/devices/bitstream_file.h"
+#include "frt/stream_arg.h"
+
+namespace fpga {
+namespace internal {
+
+// A device that models an FPGA card on the host, for exercising host code in
+// environments without hardware. It is selected by a JSON manifest used in
+// place of the bitstream, e.g.,
+//
+//   {
+//     "kind": "frt-model-device",
+//     "args": [{"name": "a", "type": "float*", "cat": "mmap"}],
+//     "pcie": {"bandwidth_gbps": 12.0, "latency_us": 2.0},
+//     "compute": {"mode": "fixed", "duration_us": 1000},
+//     "device_count": 1
+//   }
+//
+// Buffer transfers take `latency_us + bytes / bandwidth_gbps` each. The
+// computation either takes `duration_us` ("fixed"), or runs the software
+// kernel passed to `SetSoftwareKernel` ("software"), e.g., the TAPA software
+// simulation of the kernel. "args" is optional. Buffers stay in host memory.
+// "device_count" is the number of cards modeled for device groups; it is 1 if
+// omitted.
+class ModelDevice : public Device {
+ public:
+  struct Options {
+    std::vector<ArgInfo> args{};
+    double bandwidth_gbps = 0;  // GB/s; non-positive means infinite.
+    std::chrono::nanoseconds latency{0};
+    bool run_software_kernel = false;
+    std::chrono::nanoseconds compute_duration{0};
+    int device_count = 1;
+  };
+
+  explicit ModelDevice(Options options);
+  ModelDevice(const ModelDevice&) = delete;
+  ModelDevice& operator=(const ModelDevice&) = delete;
+  ModelDevice(ModelDevice&&) = delete;
+  ModelDevice& operator=(ModelDevice&&) = delete;
+
+  ~ModelDevice() override;
+
+  static std::unique_ptr<Device> New(const BitstreamFile& bitstream,
+                                     int device_index = 0);
+
+  // Parses `manifest`. Returns `nullptr` if it is not a model device manifest.
+  static std::unique_ptr<Options> ParseManifest(std::string_view manifest);
+
+  // Sets the function that models the computation in "software" mode.
+  // Returns false and ignores `kernel` in "fixed" mode.
+  bool UsesSoftwareKernel() const override;
+  bool SetSoftwareKernel(std::function<void()> kernel) override;
+
+  void SetScalarArg(size_t index, const void* arg, int size) override;
+  void SetBufferArg(size_t index, Tag tag, const BufferArg& arg) override;
+  void SetStreamArg(size_t index, Tag tag, StreamArg& arg) override;
+  size_t SuspendBuffer(size_t index) override;
+
+  void WriteToDevice() override;
+  void ReadFromDevice() override;
+  void Exec() override;
+  void Finish() override;
+  void Kill() override;
+  bool IsFinished() const override;
+
+  std::vector<ArgInfo> GetArgsInfo() const override;
+  int64_t LoadTimeNanoSeconds() const override;
+  int64_t ComputeTimeNanoSeconds() const override;
+  int64_t StoreTimeNanoSeconds() const override;
+  size_t LoadBytes() const override;
+  size_t StoreBytes() const override;
+  std::vector<PerfEvent> GetPerfEvents() const override;
+  CycleCounters GetCycleCounters() const override;
+
+ private:
+  // Sleeps for the time it takes to transfer buffers at `indices`, or until
+  // `Kill` is called.
+  void Transfer(const std::unordered_set<int>& indices);
+
+  // Sleeps for `duration` or until `Kill` is called.
+  void SleepFor(std::chrono::nanoseconds duration);
+
+  const Options options_;
+  std::function<void()> software_kernel_;
+
+  std::unordered_map<int, BufferArg> buffer_table_;
+  std::unordered_set<int> load_indices_;
+  std::unordered_set<int> store_indices_;
+  std::unordered_set<int> arg_indices_;
+
+  bool is_write_to_device_scheduled_ = false;
+  bool is_read_from_device_scheduled_ = false;
+
+  std::chrono::nanoseconds load_time_{0};
+  std::chrono::nanoseconds compute_time_{0};
+  std::chrono::nanoseconds store_time_{0};
+
+  PerfEvent load_event_ = {.phase = PerfEvent::kLoad};
+  PerfEvent compute_event_ = {.phase = PerfEvent::kCompute};
+  PerfEvent store_event_ = {.phase = PerfEvent::kStore};
+
+  std::thread compute_thread_;
+  std::atomic<bool> is_finished_ = true;
+  std::mutex mtx_;
+  std::condition_variable killed_cv_;
+  bool is_killed_ = false;
+};
+
+}  // namespace internal
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_MODEL_DEVICE_H_
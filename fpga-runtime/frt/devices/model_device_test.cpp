@@ -0,0 +1,146 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/model_device.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "frt/arg_info.h"
+#include "frt/buffer.h"
+#include "frt/device.h"
+#include "frt/tag.h"
+
+namespace fpga::internal {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+TEST(ModelDeviceTest, ParseManifestIgnoresOtherContent) {
+  EXPECT_EQ(ModelDevice::ParseManifest("PK\3\4 fake bitstream"), nullptr);
+  EXPECT_EQ(ModelDevice::ParseManifest("{\"kind\": \"other\"}"), nullptr);
+  EXPECT_EQ(ModelDevice::ParseManifest("{ not json"), nullptr);
+}
+
+TEST(ModelDeviceTest, ParseManifestSucceeds) {
+  auto options = ModelDevice::ParseManifest(R"({
+    "kind": "frt-model-device",
+    "args": [
+      {"name": "n", "type": "int", "cat": "scalar"},
+      {"name": "a", "type": "float*", "cat": "mmap"},
+      {"name": "s", "type": "float", "cat": "istream"}
+    ],
+    "pcie": {"bandwidth_gbps": 2.5, "latency_us": 3},
+    "compute": {"mode": "fixed", "duration_us": 1.5}
+  })");
+  ASSERT_NE(options, nullptr);
+  ASSERT_EQ(options->args.size(), size_t{3});
+  EXPECT_EQ(options->args[1].index, 1);
+  EXPECT_EQ(options->args[1].name, "a");
+  EXPECT_EQ(options->args[1].cat, ArgInfo::kMmap);
+  EXPECT_EQ(options->args[2].cat, ArgInfo::kStream);
+  EXPECT_EQ(options->bandwidth_gbps, 2.5);
+  EXPECT_EQ(options->latency, microseconds(3));
+  EXPECT_FALSE(options->run_software_kernel);
+  EXPECT_EQ(options->compute_duration, nanoseconds(1500));
+  EXPECT_EQ(options->device_count, 1);
+}
+
+TEST(ModelDeviceTest, ParseManifestReadsDeviceCount) {
+  auto options = ModelDevice::ParseManifest(
+      R"({"kind": "frt-model-device", "device_count": 4})");
+  ASSERT_NE(options, nullptr);
+  EXPECT_EQ(options->device_count, 4);
+}
+
+TEST(ModelDeviceTest, ModelsTransferAndComputeTime) {
+  constexpr auto kLatency = microseconds(1000);
+  constexpr auto kComputeTime = microseconds(20000);
+  ModelDevice device({
+      .bandwidth_gbps = 1,
+      .latency = kLatency,
+      .compute_duration = kComputeTime,
+  });
+
+  std::vector<char> input(1000000);  // 1 ms at 1 GB/s.
+  std::vector<char> output(100);
+  device.SetBufferArg(
+      0, Tag::kWriteOnly,
+      Buffer<char, Tag::kWriteOnly>(input.data(), input.size()));
+  device.SetBufferArg(
+      1, Tag::kReadOnly,
+      Buffer<char, Tag::kReadOnly>(output.data(), output.size()));
+  device.WriteToDevice();
+  device.Exec();
+  device.ReadFromDevice();
+  device.Finish();
+  EXPECT_TRUE(device.IsFinished());
+
+  EXPECT_EQ(device.LoadBytes(), input.size());
+  EXPECT_EQ(device.StoreBytes(), output.size());
+  EXPECT_GE(device.LoadTimeNanoSeconds(), nanoseconds(kLatency).count() +
+                                              int64_t(input.size()));
+  EXPECT_GE(device.ComputeTimeNanoSeconds(),
+            nanoseconds(kComputeTime).count());
+  EXPECT_GE(device.StoreTimeNanoSeconds(), nanoseconds(kLatency).count());
+
+  const std::vector<ArgInfo> args = device.GetArgsInfo();
+  ASSERT_EQ(args.size(), size_t{2});
+  EXPECT_EQ(args[0].cat, ArgInfo::kMmap);
+}
+
+TEST(ModelDeviceTest, RunsSoftwareKernel) {
+  std::unique_ptr<Device> device =
+      std::make_unique<ModelDevice>(ModelDevice::Options{
+          .run_software_kernel = true,
+      });
+  std::vector<int> data = {1, 2, 3};
+  device->SetBufferArg(0, Tag::kReadWrite,
+                       Buffer<int, Tag::kReadWrite>(data.data(), data.size()));
+  std::promise<void> may_finish;
+  EXPECT_TRUE(device->UsesSoftwareKernel());
+  ASSERT_TRUE(device->SetSoftwareKernel(
+      [&data, may_finish = may_finish.get_future().share()] {
+        may_finish.wait();
+        for (int& x : data) {
+          x *= 2;
+        }
+      }));
+  device->WriteToDevice();
+  device->Exec();
+  device->ReadFromDevice();
+  EXPECT_FALSE(device->IsFinished());
+  may_finish.set_value();
+  device->Finish();
+  EXPECT_TRUE(device->IsFinished());
+  EXPECT_EQ(data, std::vector<int>({2, 4, 6}));
+}
+
+TEST(ModelDeviceTest, IgnoresSoftwareKernelInFixedMode) {
+  std::unique_ptr<Device> device =
+      std::make_unique<ModelDevice>(ModelDevice::Options{});
+  bool is_called = false;
+  EXPECT_FALSE(device->UsesSoftwareKernel());
+  EXPECT_FALSE(device->SetSoftwareKernel([&is_called] { is_called = true; }));
+  device->Exec();
+  device->Finish();
+  EXPECT_FALSE(is_called);
+}
+
+TEST(ModelDeviceTest, KillStopsFixedCompute) {
+  ModelDevice device({.compute_duration = std::chrono::hours(1)});
+  device.Exec();
+  device.Kill();
+  device.Finish();
+  EXPECT_LT(device.ComputeTimeNanoSeconds(),
+            nanoseconds(std::chrono::minutes(1)).count());
+}
+
+}  // namespace
+}  // namespace fpga::internal
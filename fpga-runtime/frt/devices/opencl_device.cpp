@@ -8,6 +8,7 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <glog/logging.h>
@@ -53,6 +54,18 @@ int64_t Latest(const std::vector<cl::Event>& events,
   return default_value;
 }
 
+PerfEvent ToPerfEvent(PerfEvent::Phase phase, const cl::Event& event,
+                      std::string name = "") {
+  return {
+      .phase = phase,
+      .name = std::move(name),
+      .queued_ns = GetTime<CL_PROFILING_COMMAND_QUEUED>(event),
+      .submit_ns = GetTime<CL_PROFILING_COMMAND_SUBMIT>(event),
+      .start_ns = GetTime<CL_PROFILING_COMMAND_START>(event),
+      .end_ns = GetTime<CL_PROFILING_COMMAND_END>(event),
+  };
+}
+
 }  // namespace
 
 void OpenclDevice::SetScalarArg(size_t index, const void* arg, int size) {
@@ -113,10 +126,20 @@ void OpenclDevice::Kill() { LOG(ERROR) << "OpenCl kernels cannot be killed"; }
 bool OpenclDevice::IsFinished() const {
   if (is_finished_) {
     return true;
-  } else {
-    LOG(ERROR) << "Not implemented, assuming to be running.";
-    return false;
   }
+  // The last commands enqueued are the stores, or the kernels if there is
+  // nothing to store. Negative statuses are errors, reported by `Finish`.
+  const std::vector<cl::Event>& last_events =
+      store_event_.empty() ? compute_event_ : store_event_;
+  for (const auto& event : last_events) {
+    cl_int err;
+    cl_int status = event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>(&err);
+    CL_CHECK(err);
+    if (status > CL_COMPLETE) {
+      return false;
+    }
+  }
+  return true;
 }
 
 std::vector<ArgInfo> OpenclDevice::GetArgsInfo() const {
@@ -163,11 +186,35 @@ size_t OpenclDevice::StoreBytes() const {
   return total_size;
 }
 
+std::vector<PerfEvent> OpenclDevice::GetPerfEvents() const {
+  std::vector<PerfEvent> events;
+  for (const auto& event : load_event_) {
+    events.push_back(ToPerfEvent(PerfEvent::kLoad, event));
+  }
+  // `compute_event_` is in the same order as `kernels_`.
+  auto kernel_it = kernels_.begin();
+  for (const auto& event : compute_event_) {
+    std::string name;
+    if (kernel_it != kernels_.end()) {
+      cl_int err;
+      name = kernel_it->second.getInfo<CL_KERNEL_FUNCTION_NAME>(&err);
+      CL_CHECK(err);
+      ++kernel_it;
+    }
+    events.push_back(ToPerfEvent(PerfEvent::kCompute, event, std::move(name)));
+  }
+  for (const auto& event : store_event_) {
+    events.push_back(ToPerfEvent(PerfEvent::kStore, event));
+  }
+  return events;
+}
+
 void OpenclDevice::Initialize(const cl::Program::Binaries& binaries,
                               const std::string& vendor_name,
                               const OpenclDeviceMatcher& device_matcher,
                               const std::vector<std::string>& kernel_names,
-                              const std::vector<int>& kernel_arg_counts) {
+                              const std::vector<int>& kernel_arg_counts,
+                              int device_index) {
   std::vector<cl::Platform> platforms;
   CL_CHECK(cl::Platform::get(&platforms));
   cl_int err;
@@ -181,6 +228,12 @@ void OpenclDevice::Initialize(const cl::Program::Binaries& binaries,
       for (const auto& device : devices) {
         if (std::string device_name = device_matcher.Match(device);
             !device_name.empty()) {
+          // Skip devices that are claimed by other members of a device group.
+          if (device_index > 0) {
+            VLOG(1) << "Skipping " << device_name;
+            --device_index;
+            continue;
+          }
           LOG(INFO) << "Using " << device_name;
           device_ = device;
           context_ = cl::Context(device, nullptr, nullptr, nullptr, &err);
@@ -211,7 +264,8 @@ void OpenclDevice::Initialize(const cl::Program::Binaries& binaries,
         }
       }
       LOG(FATAL) << "Target device '" << device_matcher.GetTargetName()
-                 << "' not found";
+                 << "' not found"
+                 << (device_index > 0 ? " (not enough matching devices)" : "");
     }
   }
   LOG(FATAL) << "Target platform '" + vendor_name + "' not found";
@@ -41,13 +41,15 @@ class OpenclDevice : public Device {
   int64_t StoreTimeNanoSeconds() const override;
   size_t LoadBytes() const override;
   size_t StoreBytes() const override;
+  std::vector<PerfEvent> GetPerfEvents() const override;
 
  protected:
   void Initialize(const cl::Program::Binaries& binaries,
                   const std::string& vendor_name,
                   const OpenclDeviceMatcher& device_matcher,
                   const std::vector<std::string>& kernel_names,
-                  const std::vector<int>& kernel_arg_counts);
+                  const std::vector<int>& kernel_arg_counts,
+                  int device_index);
   virtual cl::Buffer CreateBuffer(size_t index, cl_mem_flags flags,
                                   void* host_ptr, size_t size);
 
@@ -0,0 +1,69 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/shared_memory_buffer.h"
+
+#include <cstring>
+
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+namespace fpga {
+namespace internal {
+
+SharedMemoryBuffer::SharedMemoryBuffer(Options options)
+    : path_(std::move(options.filename_template)), size_(options.size) {
+  // Create a unique name under /dev/shm, then reopen it with shm_open.
+  std::string dev_shm_path = "/dev/shm/" + path_;
+  int tmp_fd = mkstemp(&dev_shm_path[0]);
+  if (tmp_fd < 0) {
+    PLOG(ERROR) << "mkstemp";
+    return;
+  }
+  close(tmp_fd);
+  path_ = dev_shm_path.substr(strlen("/dev/shm"));
+
+  fd_ = shm_open(path_.c_str(), O_RDWR, 0600);
+  if (fd_ < 0) {
+    PLOG(ERROR) << "shm_open";
+    return;
+  }
+  if (ftruncate(fd_, size_) != 0) {
+    PLOG(ERROR) << "ftruncate";
+    return;
+  }
+  if (size_ == 0) {
+    return;
+  }
+  void* ptr =
+      mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (ptr == MAP_FAILED) {
+    PLOG(ERROR) << "mmap";
+    return;
+  }
+  data_ = static_cast<char*>(ptr);
+}
+
+SharedMemoryBuffer::~SharedMemoryBuffer() {
+  if (data_ != nullptr) {
+    PLOG_IF(WARNING, munmap(data_, size_)) << __func__ << ": munmap";
+  }
+  if (fd_ >= 0) {
+    PLOG_IF(WARNING, shm_unlink(path_.c_str())) << __func__ << ": shm_unlink";
+    PLOG_IF(WARNING, close(fd_)) << __func__ << ": close";
+  }
+}
+
+const std::string& SharedMemoryBuffer::path() const { return path_; }
+char* SharedMemoryBuffer::data() const { return data_; }
+size_t SharedMemoryBuffer::size() const { return size_; }
+
+}  // namespace internal
+}  // namespace fpga
@@ -0,0 +1,52 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_SHARED_MEMORY_BUFFER_H_
+#define FPGA_RUNTIME_SHARED_MEMORY_BUFFER_H_
+
+#include <cstddef>
+
+#include <string>
+
+namespace fpga {
+namespace internal {
+
+// A flat shared-memory object that another process maps by `path()`, e.g., to
+// pass buffer arguments to a worker process without staging data files.
+class SharedMemoryBuffer {
+ public:
+  struct Options {
+    size_t size = 0;
+
+    // This will be consumed by `mkstemp` to create a unique path for the shared
+    // memory object. See `SharedMemoryQueue::CreateFile`.
+    std::string filename_template = "shared_memory_buffer.XXXXXX";
+  };
+
+  explicit SharedMemoryBuffer(Options options);
+
+  // Not copyable or movable.
+  SharedMemoryBuffer(const SharedMemoryBuffer&) = delete;
+  SharedMemoryBuffer& operator=(const SharedMemoryBuffer&) = delete;
+
+  ~SharedMemoryBuffer();
+
+  // Name of the shared memory object, suitable for `shm_open`.
+  const std::string& path() const;
+
+  // Host mapping of the shared memory object; nullptr on failure.
+  char* data() const;
+  size_t size() const;
+
+ private:
+  std::string path_;
+  int fd_ = -1;
+  char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_SHARED_MEMORY_BUFFER_H_
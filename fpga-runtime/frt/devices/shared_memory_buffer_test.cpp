@@ -0,0 +1,50 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/devices/shared_memory_buffer.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace fpga::internal {
+namespace {
+
+constexpr size_t kSize = 4096 + 3;
+
+TEST(SharedMemoryBufferTest, CreateBufferSharesContent) {
+  SharedMemoryBuffer buffer({.size = kSize});
+  ASSERT_NE(buffer.data(), nullptr);
+  EXPECT_EQ(buffer.size(), kSize);
+  memset(buffer.data(), 0x5a, kSize);
+
+  // Map the same object like the simulator does.
+  int fd = shm_open(buffer.path().c_str(), O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  auto* peer = static_cast<char*>(
+      mmap(nullptr, kSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+  ASSERT_NE(peer, MAP_FAILED);
+  close(fd);
+
+  EXPECT_EQ(peer[kSize - 1], 0x5a);
+  peer[0] = 0x33;
+  EXPECT_EQ(buffer.data()[0], 0x33);
+  munmap(peer, kSize);
+}
+
+TEST(SharedMemoryBufferTest, CreateBufferFailsWithInvalidPathTemplate) {
+  SharedMemoryBuffer buffer({
+      .size = kSize,
+      .filename_template = "invalid path",
+  });
+
+  EXPECT_EQ(buffer.data(), nullptr);
+}
+
+}  // namespace
+}  // namespace fpga::internal
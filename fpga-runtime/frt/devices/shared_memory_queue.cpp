@@ -4,15 +4,21 @@
 
 #include "frt/devices/shared_memory_queue.h"
 
+#include <climits>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 
+#include <atomic>
+#include <chrono>
 #include <string>
 
 #include <fcntl.h>
+#include <linux/futex.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <glog/logging.h>
@@ -23,7 +29,32 @@ namespace internal {
 namespace {
 
 constexpr char kMagic[] = "tapa";
-constexpr int32_t kVersion = 1;
+
+// Version 2 puts `head_` and `tail_` on separate cache lines and adds the
+// futex words. Version 1 queues are rejected.
+constexpr int32_t kVersion = 2;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Sleeps until `*word` is woken up, `*word` is not `expected`, or `timeout`
+// elapses. Spurious wake-ups are possible.
+void FutexWait(const std::atomic<uint32_t>* word, uint32_t expected,
+               std::chrono::nanoseconds timeout) {
+  const auto seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  const timespec ts = {
+      .tv_sec = static_cast<time_t>(seconds.count()),
+      .tv_nsec = static_cast<long>((timeout - seconds).count()),  // NOLINT
+  };
+  syscall(SYS_futex, reinterpret_cast<const uint32_t*>(word), FUTEX_WAIT,
+          expected, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
 
 }  // namespace
 
@@ -124,32 +155,100 @@ int SharedMemoryQueue::CreateFile(std::string& path, int32_t depth,
   return rc;
 }
 
-size_t SharedMemoryQueue::size() const { return head_ - tail_; }
+size_t SharedMemoryQueue::size() const {
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  return head_.load(std::memory_order_acquire) - tail;
+}
 
 size_t SharedMemoryQueue::capacity() const { return depth_; }
 
 size_t SharedMemoryQueue::width() const { return width_; }
 
-bool SharedMemoryQueue::empty() const { return size() <= 0; }
-
-bool SharedMemoryQueue::full() const { return size() >= capacity(); }
+bool SharedMemoryQueue::empty() const {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (cached_head_.load(std::memory_order_relaxed) != tail) {
+    return false;
+  }
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  cached_head_.store(head, std::memory_order_relaxed);
+  return head == tail;
+}
 
 std::string SharedMemoryQueue::front() const {
-  return std::string(&data_[(tail_ % depth_) * width_], width_);
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  return std::string(&data_[(tail % depth_) * width_], width_);
 }
 
 std::string SharedMemoryQueue::pop() {
-  CHECK_GT(size(), 0U) << "pop called on an empty queue";
+  CHECK(!empty()) << "pop called on an empty queue";
   std::string val = front();
-  ++tail_;
+  const uint64_t tail = tail_.load(std::memory_order_relaxed) + 1;
+  tail_.store(tail, std::memory_order_release);
+
+  // Pairs with the fence in `wait_not_full`: either the producer sees the new
+  // tail, or we see the producer waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producer_waiting_.load(std::memory_order_relaxed) > 0) {
+    tail_futex_.store(static_cast<uint32_t>(tail), std::memory_order_release);
+    FutexWake(&tail_futex_);
+  }
   return val;
 }
 
+bool SharedMemoryQueue::wait_not_empty(
+    std::chrono::nanoseconds timeout) const {
+  if (!empty()) {
+    return true;
+  }
+  consumer_waiting_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const uint32_t expected = head_futex_.load(std::memory_order_acquire);
+  if (empty()) {
+    FutexWait(&head_futex_, expected, timeout);
+  }
+  consumer_waiting_.fetch_sub(1, std::memory_order_relaxed);
+  return !empty();
+}
+
+bool SharedMemoryQueue::full() const {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  if (head - cached_tail_.load(std::memory_order_relaxed) < depth_) {
+    return false;
+  }
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  cached_tail_.store(tail, std::memory_order_relaxed);
+  return head - tail >= depth_;
+}
+
 void SharedMemoryQueue::push(const std::string& val) {
-  CHECK_LT(size(), capacity()) << "push called on a full queue";
+  CHECK(!full()) << "push called on a full queue";
   CHECK_EQ(val.size(), width_) << "unexpected input: " << val;
-  memcpy(&data_[(head_ % depth_) * width_], val.data(), val.size());
-  ++head_;
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  memcpy(&data_[(head % depth_) * width_], val.data(), val.size());
+  head_.store(head + 1, std::memory_order_release);
+
+  // Pairs with the fence in `wait_not_empty`: either the consumer sees the new
+  // head, or we see the consumer waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_waiting_.load(std::memory_order_relaxed) > 0) {
+    head_futex_.store(static_cast<uint32_t>(head + 1),
+                      std::memory_order_release);
+    FutexWake(&head_futex_);
+  }
+}
+
+bool SharedMemoryQueue::wait_not_full(std::chrono::nanoseconds timeout) const {
+  if (!full()) {
+    return true;
+  }
+  producer_waiting_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const uint32_t expected = tail_futex_.load(std::memory_order_acquire);
+  if (full()) {
+    FutexWait(&tail_futex_, expected, timeout);
+  }
+  producer_waiting_.fetch_sub(1, std::memory_order_relaxed);
+  return !full();
 }
 
 size_t SharedMemoryQueue::mmap_len() const {
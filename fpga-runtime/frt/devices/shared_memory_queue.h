@@ -9,6 +9,7 @@
 #include <cstring>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -16,6 +17,13 @@ namespace fpga {
 namespace internal {
 
 // Shared-memory lock-free SPSC queue with fixed depth and width.
+//
+// The producer owns `head_` and the consumer owns `tail_`. Each index lives on
+// its own cache line together with the owner's cached copy of the peer index,
+// so the two sides only touch each other's line when the cached copy says the
+// queue looks full (producer) or empty (consumer). A blocked side may sleep in
+// the kernel with `wait_not_full`/`wait_not_empty` and is woken up by the peer
+// through a futex word, which also works across processes.
 class SharedMemoryQueue {
   struct Deleter {
     void operator()(SharedMemoryQueue* ptr);
@@ -41,13 +49,27 @@ class SharedMemoryQueue {
   size_t size() const;
   size_t capacity() const;
   size_t width() const;
+
+  // Consumer-side operations.
   bool empty() const;
-  bool full() const;
   std::string front() const;
   std::string pop();
+
+  // Blocks until the queue is not empty or `timeout` elapses. Returns whether
+  // the queue is not empty.
+  bool wait_not_empty(std::chrono::nanoseconds timeout) const;
+
+  // Producer-side operations.
+  bool full() const;
   void push(const std::string& val);
 
+  // Blocks until the queue is not full or `timeout` elapses. Returns whether
+  // the queue is not full.
+  bool wait_not_full(std::chrono::nanoseconds timeout) const;
+
  private:
+  static constexpr size_t kCacheLineSize = 64;
+
   explicit SharedMemoryQueue() = default;
 
   size_t mmap_len() const;
@@ -56,12 +78,27 @@ class SharedMemoryQueue {
   int32_t version_ = 0;
   uint32_t depth_ = 0;
   uint32_t width_ = 0;
-  std::atomic<uint64_t> tail_{};
-  std::atomic<uint64_t> head_{};
-  char data_[];
+
+  // Written by the producer.
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_{};
+  mutable std::atomic<uint64_t> cached_tail_{};
+  // Lower 32 bits of `head_`, published only when `consumer_waiting_` is set.
+  std::atomic<uint32_t> head_futex_{};
+  // Number of consumers sleeping on `head_futex_`.
+  mutable std::atomic<uint32_t> consumer_waiting_{};
+
+  // Written by the consumer.
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_{};
+  mutable std::atomic<uint64_t> cached_head_{};
+  // Lower 32 bits of `tail_`, published only when `producer_waiting_` is set.
+  std::atomic<uint32_t> tail_futex_{};
+  // Number of producers sleeping on `tail_futex_`.
+  mutable std::atomic<uint32_t> producer_waiting_{};
+
+  alignas(kCacheLineSize) char data_[];
 };
 
-static_assert(sizeof(SharedMemoryQueue) == 32);
+static_assert(sizeof(SharedMemoryQueue) == 3 * 64);
 
 }  // namespace internal
 }  // namespace fpga
@@ -4,7 +4,11 @@
 
 #include "frt/devices/shared_memory_queue.h"
 
+#include <chrono>
+#include <thread>
+
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -65,5 +69,49 @@ TEST_F(SharedMemoryQueueTest, GettersSucceed) {
   EXPECT_EQ(queue_->size(), 1);
 }
 
+TEST_F(SharedMemoryQueueTest, WaitNotEmptyTimesOut) {
+  EXPECT_FALSE(queue_->wait_not_empty(std::chrono::milliseconds(1)));
+}
+
+TEST_F(SharedMemoryQueueTest, WaitNotEmptyIsWokenUpByPush) {
+  std::thread producer([this] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue_->push("val");
+  });
+  const auto tic = std::chrono::steady_clock::now();
+  while (!queue_->wait_not_empty(std::chrono::seconds(10))) {
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - tic, std::chrono::seconds(10));
+  EXPECT_EQ(queue_->pop(), "val");
+  producer.join();
+}
+
+TEST_F(SharedMemoryQueueTest, WaitNotFullIsWokenUpByPop) {
+  queue_->push("val");
+  queue_->push("val");
+  EXPECT_FALSE(queue_->wait_not_full(std::chrono::milliseconds(1)));
+
+  std::thread consumer([this] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue_->pop();
+  });
+  const auto tic = std::chrono::steady_clock::now();
+  while (!queue_->wait_not_full(std::chrono::seconds(10))) {
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - tic, std::chrono::seconds(10));
+  consumer.join();
+}
+
+TEST_F(SharedMemoryQueueTest, NewFailsWithVersion1Layout) {
+  struct {
+    char magic[4] = {'t', 'a', 'p', 'a'};
+    int32_t version = 1;
+    uint32_t depth = kDepth;
+    uint32_t width = kWidth;
+  } header;
+  ASSERT_EQ(pwrite(fd_, &header, sizeof(header), 0), sizeof(header));
+  EXPECT_EQ(SharedMemoryQueue::New(fd_), nullptr);
+}
+
 }  // namespace
 }  // namespace fpga::internal
@@ -4,6 +4,8 @@
 
 #include "frt/devices/tapa_fast_cosim_device.h"
 
+#include <cerrno>
+#include <cstdint>
 #include <cstdlib>
 
 #include <algorithm>
@@ -11,6 +13,7 @@
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -18,6 +21,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include <sys/prctl.h>
 #include <tinyxml2.h>
 #include <unistd.h>
 
@@ -27,6 +31,7 @@
 #include <nlohmann/json.hpp>
 
 #include "frt/arg_info.h"
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/filesystem.h"
 #include "frt/devices/shared_memory_stream.h"
 #include "frt/devices/xilinx_environ.h"
@@ -49,6 +54,27 @@ DEFINE_string(xosim_part_num, "",
 DEFINE_bool(xosim_setup_only, false, "only setup the simulation");
 DEFINE_bool(xosim_resume_from_post_sim, false,
             "skip simulation and do post-sim checking");
+DEFINE_bool(xosim_shared_memory_buffers, false,
+            "let the simulator access mmap buffers in place in host memory "
+            "instead of staging them as data files");
+// Keep the default in sync with `DEFAULT_STREAM_BATCH_SIZE` in tapa/cosim.
+DEFINE_int32(xosim_stream_batch_size, 16,
+             "maximum number of tokens the testbench exchanges with a host "
+             "stream per DPI call");
+DEFINE_string(xosim_snapshot_cache_dir, "",
+              "if not empty, cache compiled simulation snapshots in the "
+              "specified directory and reuse them across runs");
+DEFINE_string(xosim_simulator, "xsim",
+              "simulator used for cosim, either `xsim` or `verilator`");
+DEFINE_int32(xosim_verilator_threads, 1,
+             "number of threads of the Verilator simulation");
+DEFINE_string(xosim_memory_model, "",
+              "if not empty, simulate mmap latency and bandwidth with either a "
+              "preset (`ddr4` or `hbm`) for all mmaps, or `file:<path>` of "
+              "a JSON file that maps mmap names to memory models");
+DEFINE_bool(xosim_perf_counters, false,
+            "count cycles of the kernel and its top-level ports in simulation "
+            "and report them with the invocation");
 
 namespace fpga {
 namespace internal {
@@ -57,7 +83,13 @@ namespace {
 
 using clock = std::chrono::steady_clock;
 
-std::string GetWorkDirectory() {
+int64_t ToNanoSeconds(clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+std::string GetWorkDirectory(int device_index) {
   fs::path work_dir;
 
   if (!FLAGS_xosim_work_dir.empty()) {
@@ -76,6 +108,11 @@ std::string GetWorkDirectory() {
       LOG_IF(FATAL, ::mkdtemp(&dir[0]) == nullptr)
           << "failed to create work directory";
       work_dir = dir;
+    } else if (device_index > 0) {
+      // Members of a device group other than the first one get their own
+      // subdirectory so that concurrent simulations do not clobber each other.
+      work_dir /= "device" + std::to_string(device_index);
+      fs::create_directories(work_dir);
     }
 
   } else {
@@ -102,6 +139,34 @@ std::string GetConfigPath(const std::string& work_dir) {
   return work_dir + "/config.json";
 }
 
+std::string GetPerfCountersPath(const std::string& work_dir) {
+  return work_dir + "/output/perf_counters.json";
+}
+
+// Data files are still needed if the simulation is set up to be run or
+// checked later by another process.
+bool UseSharedMemoryBuffers() {
+  return FLAGS_xosim_shared_memory_buffers && !FLAGS_xosim_setup_only &&
+         !FLAGS_xosim_resume_from_post_sim;
+}
+
+// Returns `arg` as `<pid>:<address>:<size>:<rw|ro>`. The simulator reads and
+// writes the buffer in place with `process_vm_readv`/`process_vm_writev`.
+std::string GetHostBuffer(const BufferArg& arg, bool is_writable) {
+  return std::to_string(getpid()) + ":" +
+         std::to_string(reinterpret_cast<uintptr_t>(arg.Get())) + ":" +
+         std::to_string(arg.SizeInBytes()) + (is_writable ? ":rw" : ":ro");
+}
+
+// Lets the simulator, which is a descendant of this process, access its
+// memory if Yama restricts that to ancestors (`kernel.yama.ptrace_scope=1`).
+void AllowDescendantsToAccessMemory() {
+  // Fails with EINVAL without Yama, where no exception is needed.
+  if (prctl(PR_SET_PTRACER, getpid(), 0, 0, 0) != 0 && errno != EINVAL) {
+    PLOG(WARNING) << "prctl(PR_SET_PTRACER)";
+  }
+}
+
 }  // namespace
 
 struct TapaFastCosimDevice::Context {
@@ -109,42 +174,66 @@ struct TapaFastCosimDevice::Context {
   subprocess::Popen proc;
 };
 
-TapaFastCosimDevice::TapaFastCosimDevice(std::string_view xo_path)
-    : xo_path(fs::absolute(xo_path)), work_dir(GetWorkDirectory()) {
-  if (xo_path.compare(xo_path.size() - 3, 3, ".xo") == 0) {
-    LoadArgsFromKernelXml();
-  } else if (xo_path.compare(xo_path.size() - 4, 4, ".zip") == 0) {
-    LoadArgsFromTapaYaml();
+TapaFastCosimDevice::TapaFastCosimDevice(const BitstreamFile& bitstream,
+                                         int device_index)
+    : xo_path(fs::absolute(bitstream.path())),
+      work_dir(GetWorkDirectory(device_index)) {
+  if (auto args = bitstream.LoadCachedArgsInfo()) {
+    args_ = std::move(*args);
   } else {
-    LOG(FATAL) << "Unknown file extension: " << xo_path;
+    if (xo_path.compare(xo_path.size() - 3, 3, ".xo") == 0) {
+      LoadArgsFromKernelXml(bitstream.content());
+    } else if (xo_path.compare(xo_path.size() - 4, 4, ".zip") == 0) {
+      LoadArgsFromTapaYaml(bitstream.content());
+    } else {
+      LOG(FATAL) << "Unknown file extension: " << xo_path;
+    }
+    bitstream.StoreCachedArgsInfo(args_);
   }
 
   LOG(INFO) << "Running hardware simulation with TAPA fast cosim";
 }
 
+// Extracts `filename` from the in-memory zip archive `zip_content`. Only the
+// central directory is scanned; other entries are not decompressed.
 static std::string ReadFileInZip(const std::string& zip_path,
+                                 std::string_view zip_content,
                                  const std::string& filename) {
-  miniz_cpp::zip_file xo_file = zip_path;
-  for (auto& info : xo_file.infolist()) {
-    // Check for files in the root directory.
-    if (info.filename == filename) {
-      return xo_file.read(info);
-    }
-    // Check for files in subdirectories.
-    const std::string suffix = "/" + filename;
-    if (info.filename.size() >= suffix.size() &&
-        std::equal(suffix.rbegin(), suffix.rend(), info.filename.rbegin())) {
-      return xo_file.read(info);
+  mz_zip_archive archive{};
+  LOG_IF(FATAL, !mz_zip_reader_init_mem(&archive, zip_content.data(),
+                                        zip_content.size(), /*flags=*/0))
+      << "Cannot read '" << zip_path << "' as a zip file";
+  const std::string suffix = "/" + filename;
+  std::string content;
+  bool found = false;
+  for (mz_uint i = 0; !found && i < mz_zip_reader_get_num_files(&archive);
+       ++i) {
+    char name_buf[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
+    mz_zip_reader_get_filename(&archive, i, name_buf, sizeof(name_buf));
+    const std::string_view name = name_buf;
+    // Check for files in the root directory and in subdirectories.
+    if (name == filename ||
+        (name.size() >= suffix.size() &&
+         name.substr(name.size() - suffix.size()) == suffix)) {
+      size_t size = 0;
+      void* data = mz_zip_reader_extract_to_heap(&archive, i, &size, 0);
+      LOG_IF(FATAL, data == nullptr)
+          << "Cannot extract '" << name << "' from '" << zip_path << "'";
+      content.assign(static_cast<const char*>(data), size);
+      mz_free(data);
+      found = true;
     }
   }
-  LOG(FATAL) << "Missing '" << filename << "' in '" << zip_path << "'";
-  return "";
+  mz_zip_reader_end(&archive);
+  LOG_IF(FATAL, !found) << "Missing '" << filename << "' in '" << zip_path
+                        << "'";
+  return content;
 }
 
-void TapaFastCosimDevice::LoadArgsFromKernelXml() {
-  std::string kernel_xml = ReadFileInZip(xo_path, "kernel.xml");
+void TapaFastCosimDevice::LoadArgsFromKernelXml(std::string_view xo_content) {
+  std::string kernel_xml = ReadFileInZip(xo_path, xo_content, "kernel.xml");
   tinyxml2::XMLDocument doc;
-  doc.Parse(kernel_xml.data());
+  doc.Parse(kernel_xml.data(), kernel_xml.size());
   for (const tinyxml2::XMLElement* xml_arg = doc.FirstChildElement("root")
                                                  ->FirstChildElement("kernel")
                                                  ->FirstChildElement("args")
@@ -175,8 +264,8 @@ void TapaFastCosimDevice::LoadArgsFromKernelXml() {
   }
 }
 
-void TapaFastCosimDevice::LoadArgsFromTapaYaml() {
-  std::string graph_yaml = ReadFileInZip(xo_path, "graph.yaml");
+void TapaFastCosimDevice::LoadArgsFromTapaYaml(std::string_view zip_content) {
+  std::string graph_yaml = ReadFileInZip(xo_path, zip_content, "graph.yaml");
   YAML::Node graph = YAML::Load(graph_yaml);
   auto ports = graph["tasks"][graph["top"].as<std::string>()]["ports"];
 
@@ -211,14 +300,15 @@ TapaFastCosimDevice::~TapaFastCosimDevice() {
   }
 }
 
-std::unique_ptr<Device> TapaFastCosimDevice::New(std::string_view path,
-                                                 std::string_view content) {
+std::unique_ptr<Device> TapaFastCosimDevice::New(
+    const BitstreamFile& bitstream, int device_index) {
+  const std::string_view content = bitstream.content();
   constexpr std::string_view kZipMagic("PK\3\4", 4);
   if (content.size() < kZipMagic.size() ||
       memcmp(content.data(), kZipMagic.data(), kZipMagic.size()) != 0) {
     return nullptr;
   }
-  return std::make_unique<TapaFastCosimDevice>(path);
+  return std::make_unique<TapaFastCosimDevice>(bitstream, device_index);
 }
 
 void TapaFastCosimDevice::SetScalarArg(size_t index, const void* arg,
@@ -248,7 +338,7 @@ void TapaFastCosimDevice::SetBufferArg(size_t index, Tag tag,
   LOG_IF(FATAL, args_[index].cat != ArgInfo::kMmap)
       << "Cannot set argument '" << args_[index].name
       << "' as an mmap; it is a " << args_[index].cat;
-  buffer_table_.insert({index, arg});
+  buffer_table_.insert_or_assign(index, arg);
   if (tag == Tag::kReadOnly || tag == Tag::kReadWrite) {
     store_indices_.insert(index);
   }
@@ -267,32 +357,47 @@ size_t TapaFastCosimDevice::SuspendBuffer(size_t index) {
 
 void TapaFastCosimDevice::WriteToDevice() {
   is_write_to_device_scheduled_ = true;
+  load_event_.queued_ns = ToNanoSeconds(clock::now());
 }
 
 void TapaFastCosimDevice::WriteToDeviceImpl() {
-  // All buffers must have a data file.
+  // All buffers must have a data file unless the simulator accesses them in
+  // place.
   auto tic = clock::now();
   for (const auto& [index, buffer_arg] : buffer_table_) {
-    std::ofstream(GetInputDataPath(work_dir, index),
-                  std::ios::out | std::ios::binary)
-        .write(buffer_arg.Get(), buffer_arg.SizeInBytes());
+    if (!UseSharedMemoryBuffers()) {
+      std::ofstream(GetInputDataPath(work_dir, index),
+                    std::ios::out | std::ios::binary)
+          .write(buffer_arg.Get(), buffer_arg.SizeInBytes());
+    }
   }
-  load_time_ = clock::now() - tic;
+  auto toc = clock::now();
+  load_time_ = toc - tic;
+  load_event_.submit_ns = load_event_.start_ns = ToNanoSeconds(tic);
+  load_event_.end_ns = ToNanoSeconds(toc);
 }
 
 void TapaFastCosimDevice::ReadFromDevice() {
   is_read_from_device_scheduled_ = true;
+  store_event_.queued_ns = ToNanoSeconds(clock::now());
 }
 
 void TapaFastCosimDevice::ReadFromDeviceImpl() {
   auto tic = clock::now();
   for (int index : store_indices_) {
+    // The simulator has already updated the buffer in place.
+    if (UseSharedMemoryBuffers()) {
+      continue;
+    }
     auto buffer_arg = buffer_table_.at(index);
     std::ifstream(GetOutputDataPath(work_dir, index),
                   std::ios::in | std::ios::binary)
         .read(buffer_arg.Get(), buffer_arg.SizeInBytes());
   }
-  store_time_ = clock::now() - tic;
+  auto toc = clock::now();
+  store_time_ = toc - tic;
+  store_event_.submit_ns = store_event_.start_ns = ToNanoSeconds(tic);
+  store_event_.end_ns = ToNanoSeconds(toc);
 }
 
 void TapaFastCosimDevice::Exec() {
@@ -301,6 +406,9 @@ void TapaFastCosimDevice::Exec() {
   }
 
   auto tic = clock::now();
+  compute_event_.queued_ns = compute_event_.submit_ns =
+      compute_event_.start_ns = ToNanoSeconds(tic);
+  compute_event_.end_ns = 0;
 
   nlohmann::json json;
   json["xo_path"] = xo_path;
@@ -313,12 +421,25 @@ void TapaFastCosimDevice::Exec() {
 
   nlohmann::json axi_to_c_array_size = nlohmann::json::object();
   nlohmann::json axi_to_data_file = nlohmann::json::object();
+  nlohmann::json axi_to_host_buffer = nlohmann::json::object();
+  if (UseSharedMemoryBuffers()) {
+    AllowDescendantsToAccessMemory();
+  }
   for (const auto& [index, content] : buffer_table_) {
     axi_to_c_array_size[std::to_string(index)] = content.SizeInCount();
-    axi_to_data_file[std::to_string(index)] = GetInputDataPath(work_dir, index);
+    if (UseSharedMemoryBuffers()) {
+      axi_to_host_buffer[std::to_string(index)] =
+          GetHostBuffer(content, store_indices_.count(index) > 0);
+      VLOG(1) << "arg[" << index << "] is accessed in place as "
+              << axi_to_host_buffer[std::to_string(index)];
+    } else {
+      axi_to_data_file[std::to_string(index)] =
+          GetInputDataPath(work_dir, index);
+    }
   }
   json["axi_to_c_array_size"] = std::move(axi_to_c_array_size);
   json["axi_to_data_file"] = std::move(axi_to_data_file);
+  json["axi_to_host_buffer"] = std::move(axi_to_host_buffer);
 
   nlohmann::json axis_to_data_file = nlohmann::json::object();
   for (const auto& [index, stream] : stream_table_) {
@@ -326,6 +447,20 @@ void TapaFastCosimDevice::Exec() {
     axis_to_data_file[std::to_string(index)] = stream->path();
   }
   json["axis_to_data_file"] = std::move(axis_to_data_file);
+  CHECK_GT(FLAGS_xosim_stream_batch_size, 0)
+      << "--xosim_stream_batch_size must be positive";
+  json["stream_batch_size"] = FLAGS_xosim_stream_batch_size;
+
+  if (constexpr std::string_view kFilePrefix = "file:";
+      FLAGS_xosim_memory_model.rfind(kFilePrefix, 0) == 0) {
+    const std::string path =
+        FLAGS_xosim_memory_model.substr(kFilePrefix.size());
+    std::ifstream ifs(path);
+    CHECK(ifs) << "cannot open memory model file " << path;
+    json["axi_to_memory_model"] = nlohmann::json::parse(ifs);
+  } else if (!FLAGS_xosim_memory_model.empty()) {
+    json["axi_to_memory_model"] = {{"*", FLAGS_xosim_memory_model}};
+  }
 
   std::ofstream(GetConfigPath(work_dir)) << json.dump(2);
 
@@ -351,6 +486,22 @@ void TapaFastCosimDevice::Exec() {
   if (!FLAGS_xosim_part_num.empty()) {
     argv.push_back("--part-num=" + FLAGS_xosim_part_num);
   }
+  if (!FLAGS_xosim_snapshot_cache_dir.empty()) {
+    argv.push_back("--snapshot-cache-dir=" + FLAGS_xosim_snapshot_cache_dir);
+  }
+  argv.push_back("--simulator=" + FLAGS_xosim_simulator);
+  if (FLAGS_xosim_simulator == "verilator") {
+    argv.push_back("--verilator-threads=" +
+                   std::to_string(FLAGS_xosim_verilator_threads));
+  }
+  cycle_counters_ = {};
+  if (FLAGS_xosim_perf_counters) {
+    argv.push_back("--perf-counters-path=" + GetPerfCountersPath(work_dir));
+    if (!FLAGS_xosim_resume_from_post_sim) {
+      // Do not report stale counters if the simulation does not finish.
+      fs::remove(GetPerfCountersPath(work_dir));
+    }
+  }
 
   // launch simulation as a noop if resume from post sim
   if (FLAGS_xosim_resume_from_post_sim) {
@@ -385,7 +536,19 @@ void TapaFastCosimDevice::Finish() {
     exit(0);
   }
 
-  compute_time_ = clock::now() - context_->start_timestamp;
+  auto toc = clock::now();
+  compute_time_ = toc - context_->start_timestamp;
+  compute_event_.end_ns = ToNanoSeconds(toc);
+
+  if (FLAGS_xosim_perf_counters) {
+    if (std::ifstream ifs(GetPerfCountersPath(work_dir)); ifs) {
+      cycle_counters_ = CycleCounters::FromJson(
+          std::string(std::istreambuf_iterator<char>(ifs), {}));
+    } else {
+      LOG(WARNING) << "performance counters are not found in "
+                   << GetPerfCountersPath(work_dir);
+    }
+  }
 
   if (is_read_from_device_scheduled_) {
     ReadFromDeviceImpl();
@@ -437,5 +600,20 @@ size_t TapaFastCosimDevice::StoreBytes() const {
   return total_size;
 }
 
+std::vector<PerfEvent> TapaFastCosimDevice::GetPerfEvents() const {
+  std::vector<PerfEvent> events;
+  for (const PerfEvent* event :
+       {&load_event_, &compute_event_, &store_event_}) {
+    if (event->end_ns > 0) {
+      events.push_back(*event);
+    }
+  }
+  return events;
+}
+
+CycleCounters TapaFastCosimDevice::GetCycleCounters() const {
+  return cycle_counters_;
+}
+
 }  // namespace internal
 }  // namespace fpga
@@ -11,9 +11,11 @@
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "frt/buffer_arg.h"
 #include "frt/device.h"
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/shared_memory_stream.h"
 #include "frt/stream_arg.h"
 
@@ -22,7 +24,8 @@ namespace internal {
 
 class TapaFastCosimDevice : public Device {
  public:
-  TapaFastCosimDevice(std::string_view bitstream);
+  explicit TapaFastCosimDevice(const BitstreamFile& bitstream,
+                               int device_index = 0);
   TapaFastCosimDevice(const TapaFastCosimDevice&) = delete;
   TapaFastCosimDevice& operator=(const TapaFastCosimDevice&) = delete;
   TapaFastCosimDevice(TapaFastCosimDevice&&) = delete;
@@ -30,11 +33,11 @@ class TapaFastCosimDevice : public Device {
 
   ~TapaFastCosimDevice() override;
 
-  static std::unique_ptr<Device> New(std::string_view path,
-                                     std::string_view content);
+  static std::unique_ptr<Device> New(const BitstreamFile& bitstream,
+                                     int device_index = 0);
 
-  void LoadArgsFromKernelXml();
-  void LoadArgsFromTapaYaml();
+  void LoadArgsFromKernelXml(std::string_view xo_content);
+  void LoadArgsFromTapaYaml(std::string_view zip_content);
 
   void SetScalarArg(size_t index, const void* arg, int size) override;
   void SetBufferArg(size_t index, Tag tag, const BufferArg& arg) override;
@@ -54,6 +57,8 @@ class TapaFastCosimDevice : public Device {
   int64_t StoreTimeNanoSeconds() const override;
   size_t LoadBytes() const override;
   size_t StoreBytes() const override;
+  std::vector<PerfEvent> GetPerfEvents() const override;
+  CycleCounters GetCycleCounters() const override;
 
   const std::string xo_path;
   const std::string work_dir;
@@ -76,6 +81,11 @@ class TapaFastCosimDevice : public Device {
   std::chrono::nanoseconds compute_time_;
   std::chrono::nanoseconds store_time_;
 
+  PerfEvent load_event_ = {.phase = PerfEvent::kLoad};
+  PerfEvent compute_event_ = {.phase = PerfEvent::kCompute};
+  PerfEvent store_event_ = {.phase = PerfEvent::kStore};
+  CycleCounters cycle_counters_;
+
   struct Context;
   std::unique_ptr<Context> context_;  // For asynchronous execution.
 };
@@ -3,16 +3,21 @@
 // RapidStream Contributor License Agreement.
 
 #include <climits>
+#include <cstdint>
+#include <cstring>
 
+#include <algorithm>
 #include <bitset>
+#include <optional>
 #include <sstream>
 #include <string>
-#include <tuple>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <glog/logging.h>
@@ -24,48 +29,104 @@ namespace {
 
 using ::fpga::internal::SharedMemoryQueue;
 
-std::unordered_map<std::string, SharedMemoryQueue::UniquePtr> InitStreamMap() {
+// Per-stream state, indexed by the handle returned by `tapa_stream_open`.
+// The handshake state is only used by the legacy per-cycle interface; the
+// batched interface keeps it in the testbench.
+struct Stream {
+  std::string id;
+  SharedMemoryQueue::UniquePtr queue;
+
+  // Whether data was provided (istream) or accepted (ostream) in the previous
+  // cycle.
+  bool last_empty_n = false;
+  bool last_full_n = false;
+};
+
+std::vector<Stream> InitStreams() {
   const char* env = std::getenv("TAPA_FAST_COSIM_DPI_ARGS");
   CHECK(env != nullptr) << "Please set `TAPA_FAST_COSIM_DPI_ARGS`";
   VLOG(1) << "TAPA_FAST_COSIM_DPI_ARGS: " << env;
 
-  std::vector<std::tuple<std::string, std::string>> stream_id_and_path;
-  {
-    std::istringstream ss(env);
-    std::string stream_entry;  // `id:path`
-    while (std::getline(ss, stream_entry, /*delimiter=*/',')) {
-      const std::string::size_type pos = stream_entry.find(':');
-      CHECK_NE(pos, std::string::npos) << stream_entry;
-      stream_id_and_path.push_back({
-          stream_entry.substr(0, pos),
-          stream_entry.substr(pos + 1),
-      });
-    }
-  }
-
-  std::unordered_map<std::string, SharedMemoryQueue::UniquePtr> streams;
-  for (const std::tuple<std::string, std::string>& entry : stream_id_and_path) {
-    const std::string& stream_id = std::get<0>(entry);
-    const std::string& stream_path = std::get<1>(entry);
+  std::vector<Stream> streams;
+  std::istringstream ss(env);
+  std::string stream_entry;  // `id:path`
+  while (std::getline(ss, stream_entry, /*delimiter=*/',')) {
+    const std::string::size_type pos = stream_entry.find(':');
+    CHECK_NE(pos, std::string::npos) << stream_entry;
+    Stream& stream = streams.emplace_back();
+    stream.id = stream_entry.substr(0, pos);
+    const std::string stream_path = stream_entry.substr(pos + 1);
     int fd = shm_open(stream_path.c_str(), O_RDWR, 0600);
-    VLOG(2) << "fd: " << fd << " <=> arg: " << stream_id;
-    streams[stream_id] = SharedMemoryQueue::New(fd);
+    VLOG(2) << "fd: " << fd << " <=> arg: " << stream.id;
+    stream.queue = SharedMemoryQueue::New(fd);
   }
   return streams;
 }
 
-SharedMemoryQueue* GetStream(const char* id) {
+std::vector<Stream>& GetStreams() {
+  static std::vector<Stream> streams = InitStreams();
+  return streams;
+}
+
+// Returns the handle of stream `id`, or -1 if there is no such stream. The
+// legacy interface looks up the handle in every call, so the handles are
+// indexed by ID once.
+int FindStream(const char* id) {
   if (id == nullptr) {
     LOG(ERROR) << "stream id is nullptr";
-    return nullptr;
+    return -1;
+  }
+  static const std::unordered_map<std::string_view, int> handles = [] {
+    std::unordered_map<std::string_view, int> handles;
+    const std::vector<Stream>& streams = GetStreams();
+    for (size_t i = 0; i < streams.size(); ++i) {
+      handles.emplace(streams[i].id, i);  // Keeps the first of duplicates.
+    }
+    return handles;
+  }();
+  const auto it = handles.find(id);
+  return it == handles.end() ? -1 : it->second;
+}
+
+Stream& GetStream(int handle) {
+  std::vector<Stream>& streams = GetStreams();
+  CHECK_GE(handle, 0) << "invalid stream handle";
+  CHECK_LT(size_t(handle), streams.size()) << "invalid stream handle";
+  Stream& stream = streams[handle];
+  CHECK(stream.queue != nullptr) << "stream '" << stream.id << "' is not open";
+  return stream;
+}
+
+// Copies `bytes` into the `word_count` 32-bit words of `handle` starting at
+// `first_word`, least significant word first, zero-padding words not covered
+// by `bytes`.
+void BytesToWords(const std::string& bytes, svOpenArrayHandle handle,
+                  int first_word, int word_count) {
+  for (int i = 0; i < word_count; ++i) {
+    svBitVecVal word = 0;
+    const size_t offset = size_t(i) * sizeof(word);
+    if (offset < bytes.size()) {
+      memcpy(&word, bytes.data() + offset,
+             std::min(sizeof(word), bytes.size() - offset));
+    }
+    svPutBitArrElem1VecVal(handle, &word, first_word + i);
   }
-  static std::unordered_map<std::string, SharedMemoryQueue::UniquePtr> streams =
-      InitStreamMap();
-  auto it = streams.find(id);
-  if (it == streams.end()) {
-    return nullptr;
+}
+
+// Inverse of `BytesToWords`. Returns exactly `width` bytes.
+std::string WordsToBytes(const svOpenArrayHandle handle, int first_word,
+                         int word_count, size_t width) {
+  std::string bytes(width, '\0');
+  for (int i = 0; i < word_count; ++i) {
+    const size_t offset = size_t(i) * sizeof(svBitVecVal);
+    if (offset >= width) {
+      break;
+    }
+    svBitVecVal word;
+    svGetBitArrElem1VecVal(&word, handle, first_word + i);
+    memcpy(&bytes[offset], &word, std::min(sizeof(word), width - offset));
   }
-  return it->second.get();
+  return bytes;
 }
 
 void StringToOpenArrayHandle(const std::string& bytes,
@@ -120,22 +181,12 @@ std::string OpenArrayHandleToString(svOpenArrayHandle handle, size_t width) {
   return bytes;
 }
 
-}  // namespace
-
-extern "C" {
-
-DPI_DLLESPEC void istream(
-    /* output */ svOpenArrayHandle dout,
-    /* output */ svLogic& empty_n,
-    /* input */ svLogic read,
-    /* input */ const char* id) {
-  SharedMemoryQueue* istream = GetStream(id);
-  CHECK(istream != nullptr);
-  CHECK_GE(istream->width() * CHAR_BIT, size_t(svSize(dout, 1)));
-
-  static std::unordered_map<std::string, bool> last_empty_n;
+// Advances istream `stream` by one cycle. Returns the token to provide in this
+// cycle, or `std::nullopt` if the stream is empty.
+std::optional<std::string> ReadStream(Stream& stream, svLogic read) {
+  SharedMemoryQueue* istream = stream.queue.get();
 
-  if (last_empty_n[id] && read == sv_1) {
+  if (stream.last_empty_n && read == sv_1) {
     // If we provided data in the last cycle, and the downstream consumed it,
     // we need to pop that data in this cycle.
     CHECK(!istream->empty());
@@ -144,63 +195,264 @@ DPI_DLLESPEC void istream(
 
   if (istream->empty()) {
     // If we are empty in this cycle, we do not provide data.
-    StringToOpenArrayHandle(std::string(istream->width(), 'x'), dout);
-    empty_n = sv_0;
-    last_empty_n[id] = false;
+    stream.last_empty_n = false;
 
     // If there is no data to be consumed from the DPI queue, we yield to
     // the operating system to allow the TAPA processes or other simulation
     // processes to produce data to write to the queue.
     sleep(0);
-  } else {
-    // Otherwise, we provide data and tell the downstream we are not empty.
-    StringToOpenArrayHandle(istream->front(), dout);
-    empty_n = sv_1;
-    last_empty_n[id] = true;
+    return std::nullopt;
   }
-}
 
-DPI_DLLESPEC void ostream(
-    /* input */ svOpenArrayHandle din,
-    /* output */ svLogic& full_n,
-    /* input */ svLogic write,
-    /* input */ const char* id) {
-  SharedMemoryQueue* ostream = GetStream(id);
-  CHECK(ostream != nullptr);
-  CHECK_GE(ostream->width() * CHAR_BIT, size_t(svSize(din, 1)));
+  // Otherwise, we provide data and tell the downstream we are not empty.
+  stream.last_empty_n = true;
+  return istream->front();
+}
 
-  static std::unordered_map<std::string, bool> last_full_n;
+// Advances ostream `stream` by one cycle, calling `get_data` to obtain the
+// token if the upstream writes one. Returns whether more data can be accepted.
+template <typename GetData>
+bool WriteStream(Stream& stream, svLogic write, GetData get_data) {
+  SharedMemoryQueue* ostream = stream.queue.get();
 
   if (ostream->full()) {
     // In the previous cycle we should have indicated that we are full, or this
     // is the first cycle of the simulation. Otherwise, we have to consume data
     // in this cycle which is not possible.
-    CHECK(last_full_n.find(id) != last_full_n.end() ||
-          last_full_n[id] == false);
-
-    // No data can be read in the next cycle because we are full
-    full_n = sv_0;
-    last_full_n[id] = false;
+    CHECK(!stream.last_full_n);
 
     // If the DPI queue is full, we yield to the operating system to allow
     // the TAPA processes or other simulation processes to consume data from
     // the queue.
     sleep(0);
-  } else {
-    // If in the *previous* cycle we have indicated that we are not full, we
-    // shall consume data in this cycle if it is available.
-    if (last_full_n.find(id) != last_full_n.end() && last_full_n[id] == true &&
-        write == sv_1) {
-      const std::string bits = OpenArrayHandleToString(din, ostream->width());
-      ostream->push(bits);
+    return false;
+  }
+
+  // If in the *previous* cycle we have indicated that we are not full, we
+  // shall consume data in this cycle if it is available.
+  if (stream.last_full_n && write == sv_1) {
+    ostream->push(get_data(ostream->width()));
+  }
+
+  // If we are still not full after the consumption, we can accept data in
+  // the next cycle.
+  stream.last_full_n = !ostream->full();
+  return stream.last_full_n;
+}
+
+// Granularity of `AxiMemory::overlay`.
+constexpr uint64_t kOverlayPageSize = 4096;
+
+// A host buffer that backs an AXI RAM in the testbench. The simulator accesses
+// it in place in the memory of the host process.
+struct AxiMemory {
+  pid_t pid;
+  uintptr_t address;
+  size_t size;
+  bool is_writable;
+
+  // Pages of a buffer that is not written back to the host, indexed by page
+  // number. A page is copied from the host on the first write of the DUT to
+  // it, and later reads of the DUT see the copy.
+  std::unordered_map<uint64_t, std::vector<char>> overlay;
+};
+
+// Copies `size` bytes at `offset` of the host buffer of `mem` to `data`.
+void ReadHostMemory(const AxiMemory& mem, uint64_t offset, char* data,
+                    size_t size) {
+  iovec local = {data, size};
+  iovec remote = {reinterpret_cast<void*>(mem.address + offset), size};
+  PCHECK(process_vm_readv(mem.pid, &local, 1, &remote, 1, 0) ==
+         static_cast<ssize_t>(size))
+      << "process_vm_readv from process " << mem.pid;
+}
+
+// Returns the overlay page containing `offset`, copying it from the host if
+// the DUT has not written to it yet.
+std::vector<char>& GetOverlayPage(AxiMemory& mem, uint64_t offset) {
+  const uint64_t page_begin = offset - offset % kOverlayPageSize;
+  std::vector<char>& page = mem.overlay[offset / kOverlayPageSize];
+  if (page.empty()) {
+    page.resize(kOverlayPageSize);
+    ReadHostMemory(mem, page_begin, page.data(),
+                   std::min<uint64_t>(kOverlayPageSize, mem.size - page_begin));
+  }
+  return page;
+}
+
+}  // namespace
+
+extern "C" {
+
+// `buffer` is `<pid>:<address>:<size>:<rw|ro>` of a host buffer.
+DPI_DLLESPEC void* tapa_axi_mem_open(/* input */ const char* buffer) {
+  CHECK(buffer != nullptr);
+  auto* mem = new AxiMemory{};
+  std::istringstream is(buffer);
+  char sep[3];
+  std::string mode;
+  is >> mem->pid >> sep[0] >> mem->address >> sep[1] >> mem->size >> sep[2] >>
+      mode;
+  CHECK(is && sep[0] == ':' && sep[1] == ':' && sep[2] == ':' &&
+        (mode == "rw" || mode == "ro"))
+      << "invalid host buffer '" << buffer << "'";
+  mem->is_writable = mode == "rw";
+  VLOG(1) << "accessing " << mem->size << " bytes at " << mem->address
+          << " of process " << mem->pid << " in place";
+  return mem;
+}
+
+DPI_DLLESPEC void tapa_axi_mem_read(
+    /* input */ void* handle,
+    /* input */ unsigned long long offset,
+    /* output */ svOpenArrayHandle data) {
+  const auto* mem = static_cast<const AxiMemory*>(handle);
+  CHECK(mem != nullptr);
+
+  // Out-of-range reads see zeros, just like uninitialized RAM.
+  std::vector<char> bytes(svSize(data, 1));
+  if (offset < mem->size) {
+    const uint64_t end =
+        offset + std::min<size_t>(bytes.size(), mem->size - offset);
+    ReadHostMemory(*mem, offset, bytes.data(), end - offset);
+    if (!mem->overlay.empty()) {
+      for (uint64_t page = offset / kOverlayPageSize;
+           page * kOverlayPageSize < end; ++page) {
+        const auto it = mem->overlay.find(page);
+        if (it == mem->overlay.end()) {
+          continue;
+        }
+        const uint64_t page_begin = page * kOverlayPageSize;
+        const uint64_t begin = std::max<uint64_t>(offset, page_begin);
+        memcpy(&bytes[begin - offset], &it->second[begin - page_begin],
+               std::min(end, page_begin + kOverlayPageSize) - begin);
+      }
+    }
+  }
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    *static_cast<char*>(svGetArrElemPtr1(data, svLow(data, 1) + i)) =
+        bytes[i];
+  }
+}
+
+DPI_DLLESPEC void tapa_axi_mem_write(
+    /* input */ void* handle,
+    /* input */ unsigned long long offset,
+    /* input */ const svOpenArrayHandle data,
+    /* input */ const svOpenArrayHandle strb) {
+  auto* mem = static_cast<AxiMemory*>(handle);
+  CHECK(mem != nullptr);
+  CHECK_EQ(svSize(data, 1), svSize(strb, 1));
+
+  // Gather the enabled bytes into runs of contiguous host addresses, so that
+  // a beat is written with a single system call.
+  std::vector<char> bytes(svSize(data, 1));
+  std::vector<iovec> local;
+  std::vector<iovec> remote;
+  ssize_t size = 0;
+  for (size_t i = 0; i < bytes.size(); ++i, ++offset) {
+    const int index = svLow(data, 1) + i;
+    if (*static_cast<const char*>(svGetArrElemPtr1(strb, index)) == 0) {
+      continue;
     }
+    bytes[i] = *static_cast<const char*>(svGetArrElemPtr1(data, index));
+    if (offset >= mem->size) {
+      LOG(WARNING) << "dropping out-of-range write at offset " << offset;
+    } else if (!mem->is_writable) {
+      GetOverlayPage(*mem, offset)[offset % kOverlayPageSize] = bytes[i];
+    } else if (!local.empty() && static_cast<char*>(local.back().iov_base) +
+                                         local.back().iov_len ==
+                                     &bytes[i]) {
+      ++local.back().iov_len;
+      ++remote.back().iov_len;
+      ++size;
+    } else {
+      local.push_back({&bytes[i], 1});
+      remote.push_back({reinterpret_cast<void*>(mem->address + offset), 1});
+      ++size;
+    }
+  }
+  if (size > 0) {
+    PCHECK(process_vm_writev(mem->pid, local.data(), local.size(),
+                             remote.data(), remote.size(), 0) == size)
+        << "process_vm_writev to process " << mem->pid;
+  }
+}
+
+DPI_DLLESPEC int tapa_stream_open(/* input */ const char* id) {
+  const int handle = FindStream(id);
+  CHECK_GE(handle, 0) << "unknown stream '" << (id ? id : "") << "'";
+  VLOG(1) << "stream '" << id << "' opened as handle " << handle;
+  return handle;
+}
+
+DPI_DLLESPEC int tapa_istream_batch(
+    /* input */ int handle,
+    /* output */ svOpenArrayHandle words,
+    /* input */ int token_words) {
+  SharedMemoryQueue* istream = GetStream(handle).queue.get();
+  CHECK_GT(token_words, 0);
+  const int low = svLow(words, 1);
+  const int capacity = svSize(words, 1) / token_words;
+  int count = 0;
+  for (; count < capacity && !istream->empty(); ++count) {
+    BytesToWords(istream->pop(), words, low + count * token_words,
+                 token_words);
+  }
+  return count;
+}
 
-    // If we are still not full after the consumption, we can accept data in
-    // the next cycle.
-    bool is_full = ostream->full();
-    full_n = is_full ? sv_0 : sv_1;
-    last_full_n[id] = is_full ? false : true;
+DPI_DLLESPEC int tapa_ostream_batch(
+    /* input */ int handle,
+    /* input */ const svOpenArrayHandle words,
+    /* input */ int token_words,
+    /* input */ int count) {
+  SharedMemoryQueue* ostream = GetStream(handle).queue.get();
+  CHECK_GT(token_words, 0);
+  CHECK_LE(count * token_words, svSize(words, 1));
+  const int low = svLow(words, 1);
+  int pushed = 0;
+  for (; pushed < count && !ostream->full(); ++pushed) {
+    ostream->push(WordsToBytes(words, low + pushed * token_words, token_words,
+                               ostream->width()));
+  }
+  return pushed;
+}
+
+// Legacy interface that identifies the stream by `id` and transfers one token
+// bit by bit in every call. Kept for testbenches generated before the batched
+// interface.
+DPI_DLLESPEC void istream(
+    /* output */ svOpenArrayHandle dout,
+    /* output */ svLogic& empty_n,
+    /* input */ svLogic read,
+    /* input */ const char* id) {
+  const int handle = FindStream(id);
+  CHECK_GE(handle, 0);
+  Stream& stream = GetStream(handle);
+  CHECK_GE(stream.queue->width() * CHAR_BIT, size_t(svSize(dout, 1)));
+  if (std::optional<std::string> data = ReadStream(stream, read)) {
+    StringToOpenArrayHandle(*data, dout);
+    empty_n = sv_1;
+  } else {
+    StringToOpenArrayHandle(std::string(stream.queue->width(), 'x'), dout);
+    empty_n = sv_0;
   }
 }
 
+DPI_DLLESPEC void ostream(
+    /* input */ svOpenArrayHandle din,
+    /* output */ svLogic& full_n,
+    /* input */ svLogic write,
+    /* input */ const char* id) {
+  const int handle = FindStream(id);
+  CHECK_GE(handle, 0);
+  Stream& stream = GetStream(handle);
+  CHECK_GE(stream.queue->width() * CHAR_BIT, size_t(svSize(din, 1)));
+  const bool is_not_full = WriteStream(stream, write, [din](size_t width) {
+    return OpenArrayHandleToString(din, width);
+  });
+  full_n = is_not_full ? sv_1 : sv_0;
+}
+
 }  // extern "C"
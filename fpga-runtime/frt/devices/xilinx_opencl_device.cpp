@@ -6,11 +6,14 @@
 
 #include <cstdlib>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <initializer_list>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -24,6 +27,7 @@
 #include <CL/cl2.hpp>
 #include <nlohmann/json.hpp>
 
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/filesystem.h"
 #include "frt/devices/opencl_device_matcher.h"
 #include "frt/devices/opencl_util.h"
@@ -34,7 +38,8 @@
 
 DEFINE_string(xocl_bdf, "",
               "if not empty, use the specified PCIe Bus:Device:Function "
-              "instead of trying to match device name");
+              "instead of trying to match device name; a comma-separated list "
+              "assigns one BDF to each member of a device group");
 
 namespace fpga {
 namespace internal {
@@ -75,10 +80,11 @@ std::string Concat(std::initializer_list<std::string_view> pieces) {
 
 class DeviceMatcher : public OpenclDeviceMatcher {
  public:
-  explicit DeviceMatcher(std::string target_device_name)
+  DeviceMatcher(std::string target_device_name, std::string target_bdf)
       : target_device_name_(std::move(target_device_name)),
         target_device_name_pieces_(
-            Split(target_device_name_, /*delimiter=*/'_', /*maxsplit=*/4)) {}
+            Split(target_device_name_, /*delimiter=*/'_', /*maxsplit=*/4)),
+        target_bdf_(std::move(target_bdf)) {}
 
   // Not copyable nor movable because the `string_view`s won't be valid.
   DeviceMatcher(const DeviceMatcher&) = delete;
@@ -101,8 +107,8 @@ class DeviceMatcher : public OpenclDeviceMatcher {
         Concat({device_name, " (bdf=", bdf, ")"});
     LOG(INFO) << "Found device: " << device_name_and_bdf;
 
-    if (const std::string target_bdf = FLAGS_xocl_bdf; !target_bdf.empty()) {
-      if (target_bdf == bdf) {
+    if (!target_bdf_.empty()) {
+      if (target_bdf_ == bdf) {
         return device_name_and_bdf;
       }
       return "";
@@ -140,11 +146,13 @@ class DeviceMatcher : public OpenclDeviceMatcher {
  private:
   const std::string target_device_name_;
   const std::vector<std::string_view> target_device_name_pieces_;
+  const std::string target_bdf_;
 };
 
 }  // namespace
 
-XilinxOpenclDevice::XilinxOpenclDevice(const cl::Program::Binaries& binaries) {
+XilinxOpenclDevice::XilinxOpenclDevice(const cl::Program::Binaries& binaries,
+                                       int device_index) {
   std::string target_device_name;
   std::vector<std::string> kernel_names;
   std::vector<int> kernel_arg_counts;
@@ -170,11 +178,10 @@ XilinxOpenclDevice::XilinxOpenclDevice(const cl::Program::Binaries& binaries) {
   LOG_IF(FATAL, target_device_name.empty())
       << "Cannot determine target device name from binary";
   if (auto metadata = xclbin::get_axlf_section(axlf_top, EMBEDDED_METADATA)) {
-    std::string xml_string(
+    tinyxml2::XMLDocument doc;
+    doc.Parse(
         reinterpret_cast<const char*>(axlf_top) + metadata->m_sectionOffset,
         metadata->m_sectionSize);
-    tinyxml2::XMLDocument doc;
-    doc.Parse(xml_string.c_str());
     auto xml_core = doc.FirstChildElement("project")
                         ->FirstChildElement("platform")
                         ->FirstChildElement("device")
@@ -303,18 +310,38 @@ XilinxOpenclDevice::XilinxOpenclDevice(const cl::Program::Binaries& binaries) {
     LOG(INFO) << "Running on-board execution with Xilinx OpenCL";
   }
 
+  // If BDFs are specified, each device index maps to exactly one device.
+  std::string target_bdf;
+  if (!FLAGS_xocl_bdf.empty()) {
+    const std::vector<std::string_view> bdfs = Split(FLAGS_xocl_bdf, ',');
+    LOG_IF(FATAL, device_index >= static_cast<int>(bdfs.size()))
+        << "Device #" << device_index << " requested but only " << bdfs.size()
+        << " BDF(s) specified in --xocl_bdf";
+    target_bdf = bdfs[device_index];
+    device_index = 0;
+  }
+
   Initialize(binaries, /*vendor_name=*/"Xilinx",
-             DeviceMatcher(target_device_name), kernel_names,
-             kernel_arg_counts);
+             DeviceMatcher(target_device_name, std::move(target_bdf)),
+             kernel_names, kernel_arg_counts, device_index);
+}
+
+XilinxOpenclDevice::~XilinxOpenclDevice() {
+  // Release OpenCL buffers before their staging buffers return to the pool.
+  kernels_.clear();
+  buffer_table_.clear();
 }
 
 std::unique_ptr<Device> XilinxOpenclDevice::New(
-    const cl::Program::Binaries& binaries) {
-  if (binaries.size() != 1 || binaries.begin()->size() < 8 ||
-      memcmp(binaries.begin()->data(), "xclbin2", 8) != 0) {
+    const BitstreamFile& bitstream, int device_index) {
+  const std::string_view content = bitstream.content();
+  if (content.size() < 8 || memcmp(content.data(), "xclbin2", 8) != 0) {
     return nullptr;
   }
-  return std::make_unique<XilinxOpenclDevice>(binaries);
+  // OpenCL needs its own copy of the binary; make it in one shot only after
+  // the format is known.
+  const cl::Program::Binaries binaries = {{content.begin(), content.end()}};
+  return std::make_unique<XilinxOpenclDevice>(binaries, device_index);
 }
 
 void XilinxOpenclDevice::SetStreamArg(size_t index, Tag tag, StreamArg& arg) {
@@ -322,6 +349,15 @@ void XilinxOpenclDevice::SetStreamArg(size_t index, Tag tag, StreamArg& arg) {
 }
 
 void XilinxOpenclDevice::WriteToDevice() {
+  auto tic = std::chrono::steady_clock::now();
+  for (int index : load_indices_) {
+    if (auto it = staged_buffers_.find(index); it != staged_buffers_.end()) {
+      const StagedBuffer& buffer = it->second;
+      std::copy_n(buffer.host_ptr, buffer.size, buffer.staging.get());
+    }
+  }
+  copy_in_time_ = std::chrono::steady_clock::now() - tic;
+
   if (!load_indices_.empty()) {
     load_event_.resize(1);
     CL_CHECK(cmd_.enqueueMigrateMemObjects(GetLoadBuffers(), /* flags = */ 0,
@@ -341,12 +377,78 @@ void XilinxOpenclDevice::ReadFromDevice() {
   } else {
     store_event_.clear();
   }
+  // Staged buffers are copied back once the migration finishes.
+  is_copy_out_pending_ = true;
+}
+
+void XilinxOpenclDevice::Finish() {
+  OpenclDevice::Finish();
+  if (!is_copy_out_pending_) {
+    return;
+  }
+  is_copy_out_pending_ = false;
+
+  auto tic = std::chrono::steady_clock::now();
+  size_t copied_bytes = 0;
+  for (int index : store_indices_) {
+    if (auto it = staged_buffers_.find(index); it != staged_buffers_.end()) {
+      const StagedBuffer& buffer = it->second;
+      std::copy_n(buffer.staging.get(), buffer.size, buffer.host_ptr);
+      copied_bytes += buffer.size;
+    }
+  }
+  copy_out_time_ = std::chrono::steady_clock::now() - tic;
+  VLOG_IF(1, !staged_buffers_.empty())
+      << "Staging copies of unaligned buffers took "
+      << copy_in_time_.count() << " ns before loading and "
+      << copy_out_time_.count() << " ns for " << copied_bytes
+      << " bytes after storing";
+}
+
+int64_t XilinxOpenclDevice::LoadTimeNanoSeconds() const {
+  return OpenclDevice::LoadTimeNanoSeconds() + copy_in_time_.count();
+}
+
+int64_t XilinxOpenclDevice::StoreTimeNanoSeconds() const {
+  return OpenclDevice::StoreTimeNanoSeconds() + copy_out_time_.count();
+}
+
+bool XilinxOpenclDevice::IsBufferStaged(size_t index) const {
+  return staged_buffers_.count(index) > 0;
+}
+
+int64_t XilinxOpenclDevice::StagingTimeNanoSeconds() const {
+  return (copy_in_time_ + copy_out_time_).count();
 }
 
 cl::Buffer XilinxOpenclDevice::CreateBuffer(size_t index, cl_mem_flags flags,
                                             void* host_ptr, size_t size) {
   flags |= CL_MEM_USE_HOST_PTR;
-  return OpenclDevice::CreateBuffer(index, flags, host_ptr, size);
+  if (host_ptr == nullptr || IsPageAligned(host_ptr)) {
+    cl::Buffer buffer =
+        OpenclDevice::CreateBuffer(index, flags, host_ptr, size);
+    staged_buffers_.erase(index);
+    return buffer;
+  }
+
+  // XRT would silently copy unaligned buffers into aligned memory of its own.
+  // Do it explicitly with pooled buffers so that the cost is visible.
+  auto it = arg_table_.find(index);
+  LOG(WARNING) << "Buffer argument #" << index
+               << (it == arg_table_.end() ? "" : " (" + it->second.name + ")")
+               << " is not " << AlignedBufferPool::kAlignment
+               << "-byte aligned; it is staged through an aligned buffer, "
+                  "which costs a host copy per transfer; allocate it with "
+                  "tapa::aligned_allocator to avoid the copy";
+  StagedBuffer staged = {
+      .host_ptr = static_cast<char*>(host_ptr),
+      .size = size,
+      .staging = AlignedBufferPool::Default().Acquire(size),
+  };
+  cl::Buffer buffer =
+      OpenclDevice::CreateBuffer(index, flags, staged.staging.get(), size);
+  staged_buffers_[index] = std::move(staged);
+  return buffer;
 }
 
 }  // namespace internal
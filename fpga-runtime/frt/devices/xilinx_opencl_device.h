@@ -6,7 +6,9 @@
 #define FPGA_RUNTIME_XILINX_OPENCL_DEVICE_H_
 
 #include <cstddef>
+#include <cstdint>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -14,6 +16,8 @@
 #include <CL/cl_ext_xilinx.h>
 #include <CL/cl2.hpp>
 
+#include "frt/devices/aligned_buffer_pool.h"
+#include "frt/devices/bitstream_file.h"
 #include "frt/devices/opencl_device.h"
 
 namespace fpga {
@@ -21,17 +25,39 @@ namespace internal {
 
 class XilinxOpenclDevice : public OpenclDevice {
  public:
-  XilinxOpenclDevice(const cl::Program::Binaries& binaries);
+  explicit XilinxOpenclDevice(const cl::Program::Binaries& binaries,
+                              int device_index = 0);
+  ~XilinxOpenclDevice() override;
 
-  static std::unique_ptr<Device> New(const cl::Program::Binaries& binaries);
+  static std::unique_ptr<Device> New(const BitstreamFile& bitstream,
+                                     int device_index = 0);
 
   void SetStreamArg(size_t index, Tag tag, StreamArg& arg) override;
   void WriteToDevice() override;
   void ReadFromDevice() override;
+  void Finish() override;
+
+  // Staging copies are accounted as part of the transfers.
+  int64_t LoadTimeNanoSeconds() const override;
+  int64_t StoreTimeNanoSeconds() const override;
+  bool IsBufferStaged(size_t index) const override;
+  int64_t StagingTimeNanoSeconds() const override;
 
  private:
   cl::Buffer CreateBuffer(size_t index, cl_mem_flags flags, void* host_ptr,
                           size_t size) override;
+
+  // A page-aligned copy of a buffer argument whose host pointer is not
+  // page-aligned, which XRT cannot use without an internal copy.
+  struct StagedBuffer {
+    char* host_ptr;
+    size_t size;
+    AlignedBufferPool::Buffer staging;
+  };
+  std::unordered_map<int, StagedBuffer> staged_buffers_;
+  bool is_copy_out_pending_ = false;
+  std::chrono::nanoseconds copy_in_time_{0};
+  std::chrono::nanoseconds copy_out_time_{0};
 };
 
 }  // namespace internal
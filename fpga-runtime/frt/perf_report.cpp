@@ -0,0 +1,366 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/perf_report.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace fpga {
+
+namespace {
+
+// Returns the value at percentile `p` of `sorted`, which must not be empty.
+int64_t Percentile(const std::vector<int64_t>& sorted, int p) {
+  return sorted[(sorted.size() - 1) * p / 100];
+}
+
+// Returns the earliest known timestamp of `event`.
+int64_t BeginOf(const PerfEvent& event) {
+  return event.queued_ns > 0 ? std::min(event.queued_ns, event.start_ns)
+                             : event.start_ns;
+}
+
+std::string TrackOf(const PerfEvent& event) {
+  std::string track = PerfEvent::PhaseName(event.phase);
+  if (!event.name.empty()) {
+    track += ":" + event.name;
+  }
+  return track;
+}
+
+nlohmann::json HistogramToJson(const PerfReport::Histogram& histogram) {
+  return {
+      {"count", histogram.count},   {"min_ns", histogram.min_ns},
+      {"max_ns", histogram.max_ns}, {"mean_ns", histogram.mean_ns},
+      {"p50_ns", histogram.p50_ns}, {"p90_ns", histogram.p90_ns},
+      {"p99_ns", histogram.p99_ns}, {"buckets", histogram.buckets},
+  };
+}
+
+nlohmann::json CycleCountersToJson(const CycleCounters& cycles) {
+  nlohmann::json ports_json = nlohmann::json::array();
+  for (const auto& port : cycles.ports) {
+    nlohmann::json port_json = {
+        {"name", port.name},
+        {"kind", port.kind},
+        {"transfers", port.transfers},
+        {"stall_cycles", port.stall_cycles},
+    };
+    if (port.kind == "mmap") {
+      port_json["read_bytes"] = port.read_bytes;
+      port_json["write_bytes"] = port.write_bytes;
+      port_json["max_outstanding_reads"] = port.max_outstanding_reads;
+      port_json["max_outstanding_writes"] = port.max_outstanding_writes;
+    } else {
+      port_json["valid_cycles"] = port.valid_cycles;
+      port_json["ready_cycles"] = port.ready_cycles;
+    }
+    ports_json.push_back(std::move(port_json));
+  }
+  nlohmann::json cycles_json = {
+      {"kernel_cycles", cycles.kernel_cycles},
+      {"ports", std::move(ports_json)},
+  };
+  if (!cycles.counters.empty()) {
+    nlohmann::json counters_json = nlohmann::json::array();
+    for (const auto& counter : cycles.counters) {
+      counters_json.push_back({
+          {"name", counter.name},
+          {"kind", counter.kind},
+          {"event", counter.event},
+          {"value", counter.value},
+      });
+    }
+    cycles_json["counters"] = std::move(counters_json);
+  }
+  return cycles_json;
+}
+
+CycleCounters CycleCountersFromJson(const nlohmann::json& cycles_json) {
+  CycleCounters cycles;
+  cycles.kernel_cycles = cycles_json.value("kernel_cycles", int64_t{0});
+  for (const auto& port_json : cycles_json.value("ports", nlohmann::json())) {
+    PortCounters port;
+    port.name = port_json.at("name").get<std::string>();
+    port.kind = port_json.at("kind").get<std::string>();
+    port.transfers = port_json.value("transfers", int64_t{0});
+    port.stall_cycles = port_json.value("stall_cycles", int64_t{0});
+    port.valid_cycles = port_json.value("valid_cycles", int64_t{0});
+    port.ready_cycles = port_json.value("ready_cycles", int64_t{0});
+    port.read_bytes = port_json.value("read_bytes", size_t{0});
+    port.write_bytes = port_json.value("write_bytes", size_t{0});
+    port.max_outstanding_reads =
+        port_json.value("max_outstanding_reads", int64_t{0});
+    port.max_outstanding_writes =
+        port_json.value("max_outstanding_writes", int64_t{0});
+    cycles.ports.push_back(std::move(port));
+  }
+  for (const auto& counter_json :
+       cycles_json.value("counters", nlohmann::json())) {
+    KernelCounter counter;
+    counter.name = counter_json.at("name").get<std::string>();
+    counter.kind = counter_json.at("kind").get<std::string>();
+    counter.event = counter_json.at("event").get<std::string>();
+    counter.value = counter_json.value("value", int64_t{0});
+    cycles.counters.push_back(std::move(counter));
+  }
+  return cycles;
+}
+
+nlohmann::json InvocationReportToJson(const InvocationReport& report) {
+  nlohmann::json args_json = nlohmann::json::array();
+  for (const auto& arg : report.args) {
+    args_json.push_back({
+        {"index", arg.index},
+        {"name", arg.name},
+        {"load_bytes", arg.load_bytes},
+        {"store_bytes", arg.store_bytes},
+        {"is_staged", arg.is_staged},
+    });
+  }
+  nlohmann::json events_json = nlohmann::json::array();
+  for (const auto& event : report.events) {
+    events_json.push_back({
+        {"phase", PerfEvent::PhaseName(event.phase)},
+        {"name", event.name},
+        {"queued_ns", event.queued_ns},
+        {"submit_ns", event.submit_ns},
+        {"start_ns", event.start_ns},
+        {"end_ns", event.end_ns},
+    });
+  }
+  nlohmann::json report_json = {
+      {"args", std::move(args_json)},
+      {"events", std::move(events_json)},
+      {"load_ns", report.load_ns},
+      {"compute_ns", report.compute_ns},
+      {"store_ns", report.store_ns},
+      {"load_bytes", report.load_bytes},
+      {"store_bytes", report.store_bytes},
+      {"staging_ns", report.staging_ns},
+  };
+  if (!report.cycles.empty()) {
+    report_json["cycles"] = CycleCountersToJson(report.cycles);
+  }
+  return report_json;
+}
+
+PerfEvent::Phase PhaseFromName(const std::string& name) {
+  for (auto phase :
+       {PerfEvent::kLoad, PerfEvent::kCompute, PerfEvent::kStore}) {
+    if (name == PerfEvent::PhaseName(phase)) {
+      return phase;
+    }
+  }
+  throw std::invalid_argument("unknown phase: " + name);
+}
+
+}  // namespace
+
+CycleCounters CycleCounters::FromJson(const std::string& json) {
+  return CycleCountersFromJson(nlohmann::json::parse(json));
+}
+
+std::string CycleCounters::ToJson() const {
+  return CycleCountersToJson(*this).dump();
+}
+
+InvocationReport InvocationReport::FromJson(const std::string& json) {
+  const auto report_json = nlohmann::json::parse(json);
+  InvocationReport report;
+  for (const auto& arg_json : report_json.at("args")) {
+    ArgTransfer arg;
+    arg.index = arg_json.at("index").get<int>();
+    arg.name = arg_json.at("name").get<std::string>();
+    arg.load_bytes = arg_json.value("load_bytes", size_t{0});
+    arg.store_bytes = arg_json.value("store_bytes", size_t{0});
+    arg.is_staged = arg_json.value("is_staged", false);
+    report.args.push_back(std::move(arg));
+  }
+  for (const auto& event_json : report_json.at("events")) {
+    PerfEvent event;
+    event.phase = PhaseFromName(event_json.at("phase").get<std::string>());
+    event.name = event_json.value("name", std::string());
+    event.queued_ns = event_json.value("queued_ns", int64_t{0});
+    event.submit_ns = event_json.value("submit_ns", int64_t{0});
+    event.start_ns = event_json.value("start_ns", int64_t{0});
+    event.end_ns = event_json.value("end_ns", int64_t{0});
+    report.events.push_back(std::move(event));
+  }
+  report.load_ns = report_json.value("load_ns", int64_t{0});
+  report.compute_ns = report_json.value("compute_ns", int64_t{0});
+  report.store_ns = report_json.value("store_ns", int64_t{0});
+  report.load_bytes = report_json.value("load_bytes", size_t{0});
+  report.store_bytes = report_json.value("store_bytes", size_t{0});
+  report.staging_ns = report_json.value("staging_ns", int64_t{0});
+  if (report_json.contains("cycles")) {
+    report.cycles = CycleCountersFromJson(report_json.at("cycles"));
+  }
+  return report;
+}
+
+std::string InvocationReport::ToJson() const {
+  return InvocationReportToJson(*this).dump();
+}
+
+const char* PerfEvent::PhaseName(Phase phase) {
+  switch (phase) {
+    case kLoad:
+      return "load";
+    case kCompute:
+      return "compute";
+    case kStore:
+      return "store";
+  }
+  return "unknown";
+}
+
+void PerfReport::Add(InvocationReport report) {
+  invocations_.push_back(std::move(report));
+}
+
+PerfReport::Histogram PerfReport::GetHistogram(PerfEvent::Phase phase,
+                                               const std::string& name) const {
+  std::vector<int64_t> durations;
+  for (const auto& invocation : invocations_) {
+    int64_t begin = std::numeric_limits<int64_t>::max();
+    int64_t end = std::numeric_limits<int64_t>::min();
+    for (const auto& event : invocation.events) {
+      if (event.phase == phase && (name.empty() || event.name == name)) {
+        begin = std::min(begin, event.start_ns);
+        end = std::max(end, event.end_ns);
+      }
+    }
+    if (begin <= end) {
+      durations.push_back(end - begin);
+    }
+  }
+
+  Histogram histogram;
+  if (durations.empty()) {
+    return histogram;
+  }
+  std::sort(durations.begin(), durations.end());
+  histogram.count = durations.size();
+  histogram.min_ns = durations.front();
+  histogram.max_ns = durations.back();
+  double sum = 0;
+  for (int64_t duration : durations) {
+    sum += static_cast<double>(duration);
+    int bucket = 0;
+    while (bucket < 62 && (int64_t{2} << bucket) <= duration) {
+      ++bucket;
+    }
+    if (histogram.buckets.size() <= static_cast<size_t>(bucket)) {
+      histogram.buckets.resize(bucket + 1);
+    }
+    ++histogram.buckets[bucket];
+  }
+  histogram.mean_ns = sum / static_cast<double>(durations.size());
+  histogram.p50_ns = Percentile(durations, 50);
+  histogram.p90_ns = Percentile(durations, 90);
+  histogram.p99_ns = Percentile(durations, 99);
+  return histogram;
+}
+
+std::string PerfReport::ToJson() const {
+  nlohmann::json invocations_json = nlohmann::json::array();
+  std::map<std::string, std::pair<PerfEvent::Phase, std::string>> tracks;
+  for (const auto& invocation : invocations_) {
+    for (const auto& event : invocation.events) {
+      tracks[TrackOf(event)] = {event.phase, event.name};
+    }
+    invocations_json.push_back(InvocationReportToJson(invocation));
+  }
+
+  nlohmann::json histograms_json = nlohmann::json::object();
+  for (auto phase :
+       {PerfEvent::kLoad, PerfEvent::kCompute, PerfEvent::kStore}) {
+    histograms_json[PerfEvent::PhaseName(phase)] =
+        HistogramToJson(GetHistogram(phase));
+  }
+  // Per-kernel histograms of multi-kernel programs.
+  for (const auto& [track, key] : tracks) {
+    if (!key.second.empty()) {
+      histograms_json[track] =
+          HistogramToJson(GetHistogram(key.first, key.second));
+    }
+  }
+
+  return nlohmann::json{
+      {"invocations", std::move(invocations_json)},
+      {"histograms", std::move(histograms_json)},
+  }
+      .dump(2);
+}
+
+std::string PerfReport::ToChromeTrace() const {
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (const auto& invocation : invocations_) {
+    for (const auto& event : invocation.events) {
+      origin = std::min(origin, BeginOf(event));
+    }
+  }
+  const auto to_us = [origin](int64_t ns) {
+    return static_cast<double>(ns - origin) * 1e-3;
+  };
+
+  nlohmann::json events_json = nlohmann::json::array();
+  std::map<std::string, int> tids;
+  for (size_t i = 0; i < invocations_.size(); ++i) {
+    for (const auto& event : invocations_[i].events) {
+      const std::string track = TrackOf(event);
+      auto [it, is_new] = tids.insert({track, static_cast<int>(tids.size())});
+      if (is_new) {
+        events_json.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 0},
+            {"tid", it->second},
+            {"args", {{"name", track}}},
+        });
+      }
+      // Time spent waiting in the command queue.
+      if (event.queued_ns > 0 && event.queued_ns < event.start_ns) {
+        events_json.push_back({
+            {"name", track + " (queued)"},
+            {"cat", "queue"},
+            {"ph", "X"},
+            {"pid", 0},
+            {"tid", it->second},
+            {"ts", to_us(event.queued_ns)},
+            {"dur", static_cast<double>(event.start_ns - event.queued_ns) *
+                        1e-3},
+            {"args", {{"invocation", i}}},
+        });
+      }
+      events_json.push_back({
+          {"name", track},
+          {"cat", PerfEvent::PhaseName(event.phase)},
+          {"ph", "X"},
+          {"pid", 0},
+          {"tid", it->second},
+          {"ts", to_us(event.start_ns)},
+          {"dur", static_cast<double>(event.end_ns - event.start_ns) * 1e-3},
+          {"args", {{"invocation", i}}},
+      });
+    }
+  }
+
+  return nlohmann::json{
+      {"traceEvents", std::move(events_json)},
+      {"displayTimeUnit", "ns"},
+  }
+      .dump();
+}
+
+}  // namespace fpga
@@ -0,0 +1,142 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_PERF_REPORT_H_
+#define FPGA_RUNTIME_PERF_REPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+namespace fpga {
+
+// Timestamps of a device command in nanoseconds, on a monotonic clock chosen
+// by the device (OpenCL profiling counters or `std::chrono::steady_clock`).
+struct PerfEvent {
+  enum Phase { kLoad, kCompute, kStore };
+
+  Phase phase = kLoad;
+  std::string name{};  // Kernel name of compute events; may be empty.
+  int64_t queued_ns = 0;
+  int64_t submit_ns = 0;
+  int64_t start_ns = 0;
+  int64_t end_ns = 0;
+
+  static const char* PhaseName(Phase phase);
+};
+
+// Bytes of a buffer argument transferred between host and device.
+struct ArgTransfer {
+  int index = 0;
+  std::string name{};
+  size_t load_bytes = 0;
+  size_t store_bytes = 0;
+  // Whether the buffer is copied through host staging memory on each transfer
+  // because the device cannot transfer it in place, e.g., it is not aligned.
+  bool is_staged = false;
+};
+
+// Cycle counts of a top-level port of the kernel, measured in simulation.
+struct PortCounters {
+  std::string name;
+  std::string kind;       // `istream`, `ostream`, or `mmap`.
+  int64_t transfers = 0;  // Stream tokens, or data beats of `mmap`s.
+  // Streams: cycles with valid but not ready. `mmap`s: cycles with outstanding
+  // transactions but no data beat.
+  int64_t stall_cycles = 0;
+  // Streams only.
+  int64_t valid_cycles = 0;
+  int64_t ready_cycles = 0;
+  // `mmap`s only.
+  size_t read_bytes = 0;
+  size_t write_bytes = 0;
+  int64_t max_outstanding_reads = 0;
+  int64_t max_outstanding_writes = 0;
+};
+
+// A counter instantiated in the kernel by `tapa synth --enable-perf-counters`.
+struct KernelCounter {
+  std::string name;   // Task instance, FIFO, or top-level task name.
+  std::string kind;   // `task`, `fifo`, or `kernel`.
+  std::string event;  // E.g., `busy_cycles`, `blocked_cycles`, `full_cycles`.
+  int64_t value = 0;
+};
+
+// Cycle counts of an invocation, measured by instrumented simulation.
+struct CycleCounters {
+  int64_t kernel_cycles = 0;  // From start to done.
+  std::vector<PortCounters> ports{};
+  std::vector<KernelCounter> counters{};
+
+  bool empty() const {
+    return kernel_cycles == 0 && ports.empty() && counters.empty();
+  }
+
+  // Converts from and to the JSON written by the cosim testbench.
+  static CycleCounters FromJson(const std::string& json);
+  std::string ToJson() const;
+};
+
+// Performance of a single invocation, as returned by
+// `Instance::GetInvocationReport`.
+struct InvocationReport {
+  std::vector<ArgTransfer> args{};
+  std::vector<PerfEvent> events{};
+  int64_t load_ns = 0;
+  int64_t compute_ns = 0;
+  int64_t store_ns = 0;
+  size_t load_bytes = 0;
+  size_t store_bytes = 0;
+  int64_t staging_ns = 0;  // Copies of staged args; in `load_ns`/`store_ns`.
+  CycleCounters cycles{};  // Empty unless the device counts cycles.
+
+  // Converts from and to the JSON of an invocation in `PerfReport::ToJson`.
+  static InvocationReport FromJson(const std::string& json);
+  std::string ToJson() const;
+};
+
+// Aggregates `InvocationReport`s across repeated invocations.
+class PerfReport {
+ public:
+  // Distribution of durations across invocations.
+  struct Histogram {
+    size_t count = 0;
+    int64_t min_ns = 0;
+    int64_t max_ns = 0;
+    double mean_ns = 0;
+    int64_t p50_ns = 0;
+    int64_t p90_ns = 0;
+    int64_t p99_ns = 0;
+    // `buckets[i]` counts durations in [2^i, 2^(i+1)) nanoseconds; durations
+    // below 1 ns are counted in `buckets[0]`.
+    std::vector<size_t> buckets;
+  };
+
+  void Add(InvocationReport report);
+
+  const std::vector<InvocationReport>& invocations() const {
+    return invocations_;
+  }
+
+  // Returns the distribution of the duration of `phase` per invocation. If
+  // `name` is not empty, only events of that kernel are considered.
+  Histogram GetHistogram(PerfEvent::Phase phase,
+                         const std::string& name = "") const;
+
+  // Returns all invocations and histograms as a JSON object.
+  std::string ToJson() const;
+
+  // Returns all events in the Chrome trace event format, viewable in
+  // chrome://tracing or Perfetto.
+  std::string ToChromeTrace() const;
+
+ private:
+  std::vector<InvocationReport> invocations_;
+};
+
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_PERF_REPORT_H_
@@ -0,0 +1,208 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/perf_report.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "frt.h"
+#include "frt/devices/model_device.h"
+
+namespace fpga {
+namespace {
+
+InvocationReport NewReport(int64_t begin, int64_t compute_ns) {
+  return {
+      .args = {{.index = 0, .name = "a", .load_bytes = 64, .is_staged = true}},
+      .events =
+          {
+              {.phase = PerfEvent::kLoad,
+               .queued_ns = begin,
+               .submit_ns = begin + 1,
+               .start_ns = begin + 2,
+               .end_ns = begin + 10},
+              {.phase = PerfEvent::kCompute,
+               .name = "k0",
+               .start_ns = begin + 10,
+               .end_ns = begin + 10 + compute_ns},
+              {.phase = PerfEvent::kCompute,
+               .name = "k1",
+               .start_ns = begin + 20,
+               .end_ns = begin + 30},
+          },
+      .compute_ns = compute_ns,
+  };
+}
+
+TEST(PerfReportTest, HistogramAcrossInvocations) {
+  PerfReport report;
+  for (int64_t compute_ns : {100, 200, 300, 400}) {
+    report.Add(NewReport(1000 * compute_ns, compute_ns));
+  }
+
+  PerfReport::Histogram compute = report.GetHistogram(PerfEvent::kCompute);
+  EXPECT_EQ(compute.count, size_t{4});
+  EXPECT_EQ(compute.min_ns, 100);
+  EXPECT_EQ(compute.max_ns, 400);
+  EXPECT_EQ(compute.mean_ns, 250);
+  EXPECT_EQ(compute.p50_ns, 200);
+  EXPECT_EQ(compute.p99_ns, 300);
+  // 100 is in [64, 128), 200 in [128, 256), and 300 and 400 in [256, 512).
+  EXPECT_EQ(compute.buckets,
+            std::vector<size_t>({0, 0, 0, 0, 0, 0, 1, 1, 2}));
+
+  PerfReport::Histogram k1 = report.GetHistogram(PerfEvent::kCompute, "k1");
+  EXPECT_EQ(k1.count, size_t{4});
+  EXPECT_EQ(k1.min_ns, 10);
+  EXPECT_EQ(k1.max_ns, 10);
+
+  EXPECT_EQ(report.GetHistogram(PerfEvent::kStore).count, size_t{0});
+}
+
+TEST(PerfReportTest, ToJson) {
+  PerfReport report;
+  report.Add(NewReport(0, 100));
+
+  const auto json = nlohmann::json::parse(report.ToJson());
+  ASSERT_EQ(json["invocations"].size(), size_t{1});
+  EXPECT_EQ(json["invocations"][0]["args"][0]["load_bytes"], 64);
+  EXPECT_EQ(json["invocations"][0]["args"][0]["is_staged"], true);
+  EXPECT_EQ(json["invocations"][0]["staging_ns"], 0);
+  EXPECT_EQ(json["invocations"][0]["events"][1]["name"], "k0");
+  EXPECT_EQ(json["histograms"]["load"]["max_ns"], 8);
+  EXPECT_EQ(json["histograms"]["compute:k0"]["max_ns"], 100);
+  EXPECT_EQ(json["histograms"]["compute:k1"]["max_ns"], 10);
+  EXPECT_FALSE(json["invocations"][0].contains("cycles"));
+}
+
+TEST(PerfReportTest, InvocationReportRoundTrip) {
+  InvocationReport invocation = NewReport(1000, 100);
+  invocation.store_bytes = 32;
+  invocation.cycles.kernel_cycles = 500;
+
+  const auto json = nlohmann::json::parse(invocation.ToJson());
+  EXPECT_EQ(json["events"][1]["phase"], "compute");
+
+  const InvocationReport copy = InvocationReport::FromJson(json.dump());
+  ASSERT_EQ(copy.args.size(), size_t{1});
+  EXPECT_EQ(copy.args[0].name, "a");
+  EXPECT_EQ(copy.args[0].load_bytes, size_t{64});
+  EXPECT_TRUE(copy.args[0].is_staged);
+  ASSERT_EQ(copy.events.size(), size_t{3});
+  EXPECT_EQ(copy.events[0].phase, PerfEvent::kLoad);
+  EXPECT_EQ(copy.events[0].queued_ns, 1000);
+  EXPECT_EQ(copy.events[2].phase, PerfEvent::kCompute);
+  EXPECT_EQ(copy.events[2].name, "k1");
+  EXPECT_EQ(copy.compute_ns, 100);
+  EXPECT_EQ(copy.store_bytes, size_t{32});
+  EXPECT_EQ(copy.cycles.kernel_cycles, 500);
+}
+
+TEST(PerfReportTest, CycleCounters) {
+  // As written by the cosim testbench.
+  const CycleCounters cycles = CycleCounters::FromJson(R"({
+    "kernel_cycles": 1000,
+    "ports": [
+      {"name": "a_s", "kind": "istream", "valid_cycles": 300,
+       "ready_cycles": 250, "transfers": 200, "stall_cycles": 100},
+      {"name": "mem", "kind": "mmap", "transfers": 64, "stall_cycles": 40,
+       "read_bytes": 2048, "write_bytes": 0, "max_outstanding_reads": 4,
+       "max_outstanding_writes": 0}
+    ],
+    "counters": [
+      {"name": "Top", "kind": "kernel", "event": "cycles", "value": 990},
+      {"name": "Task_0", "kind": "task", "event": "busy_cycles", "value": 800}
+    ]
+  })");
+  EXPECT_EQ(cycles.kernel_cycles, 1000);
+  ASSERT_EQ(cycles.ports.size(), size_t{2});
+  EXPECT_EQ(cycles.ports[0].kind, "istream");
+  EXPECT_EQ(cycles.ports[0].stall_cycles, 100);
+  EXPECT_EQ(cycles.ports[1].read_bytes, size_t{2048});
+  EXPECT_EQ(cycles.ports[1].max_outstanding_reads, 4);
+  ASSERT_EQ(cycles.counters.size(), size_t{2});
+  EXPECT_EQ(cycles.counters[1].name, "Task_0");
+  EXPECT_EQ(cycles.counters[1].event, "busy_cycles");
+  EXPECT_EQ(cycles.counters[1].value, 800);
+
+  const CycleCounters copy = CycleCounters::FromJson(cycles.ToJson());
+  EXPECT_EQ(copy.ports[0].valid_cycles, 300);
+  EXPECT_EQ(copy.ports[1].transfers, 64);
+  ASSERT_EQ(copy.counters.size(), size_t{2});
+  EXPECT_EQ(copy.counters[0].kind, "kernel");
+  EXPECT_EQ(copy.counters[0].value, 990);
+
+  PerfReport report;
+  InvocationReport invocation = NewReport(0, 100);
+  invocation.cycles = cycles;
+  report.Add(std::move(invocation));
+  const auto json = nlohmann::json::parse(report.ToJson());
+  EXPECT_EQ(json["invocations"][0]["cycles"]["kernel_cycles"], 1000);
+  EXPECT_EQ(json["invocations"][0]["cycles"]["ports"][1]["name"], "mem");
+}
+
+TEST(PerfReportTest, ToChromeTrace) {
+  PerfReport report;
+  report.Add(NewReport(1000, 100));
+
+  const auto json = nlohmann::json::parse(report.ToChromeTrace());
+  int complete_events = 0;
+  for (const auto& event : json["traceEvents"]) {
+    if (event["ph"] == "X") {
+      ++complete_events;
+      EXPECT_GE(event["ts"].get<double>(), 0);
+    }
+    if (event["name"] == "load (queued)") {
+      EXPECT_EQ(event["ts"], 0);
+      EXPECT_EQ(event["dur"], 0.002);
+    }
+  }
+  // 3 commands and the queueing time of the load command.
+  EXPECT_EQ(complete_events, 4);
+}
+
+TEST(PerfReportTest, InstanceReportsArgsAndEvents) {
+  Instance instance(std::make_unique<internal::ModelDevice>(
+      internal::ModelDevice::Options{}));
+  std::vector<int> input(16);
+  std::vector<int> output(8);
+  instance.SetArgs(WriteOnly(input.data(), input.size()),
+                   ReadOnly(output.data(), output.size()), 42);
+  instance.WriteToDevice();
+  instance.Exec();
+  instance.ReadFromDevice();
+  instance.Finish();
+
+  InvocationReport report = instance.GetInvocationReport();
+  ASSERT_EQ(report.args.size(), size_t{2});
+  EXPECT_EQ(report.args[0].name, "arg0");
+  EXPECT_EQ(report.args[0].load_bytes, input.size() * sizeof(int));
+  EXPECT_EQ(report.args[0].store_bytes, size_t{0});
+  EXPECT_EQ(report.args[1].load_bytes, size_t{0});
+  EXPECT_EQ(report.args[1].store_bytes, output.size() * sizeof(int));
+  EXPECT_FALSE(report.args[0].is_staged);
+  EXPECT_FALSE(report.args[1].is_staged);
+  EXPECT_EQ(report.load_bytes, input.size() * sizeof(int));
+  EXPECT_EQ(report.staging_ns, 0);
+
+  ASSERT_EQ(report.events.size(), size_t{3});
+  EXPECT_EQ(report.events[0].phase, PerfEvent::kLoad);
+  EXPECT_EQ(report.events[1].phase, PerfEvent::kCompute);
+  EXPECT_EQ(report.events[2].phase, PerfEvent::kStore);
+  for (const auto& event : report.events) {
+    EXPECT_LE(event.queued_ns, event.start_ns);
+    EXPECT_LE(event.start_ns, event.end_ns);
+  }
+  EXPECT_LE(report.events[0].end_ns, report.events[1].start_ns);
+  EXPECT_LE(report.events[1].end_ns, report.events[2].start_ns);
+  EXPECT_TRUE(report.cycles.empty());
+}
+
+}  // namespace
+}  // namespace fpga
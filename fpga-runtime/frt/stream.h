@@ -7,6 +7,7 @@
 
 #include "frt/devices/shared_memory_queue.h"
 
+#include <chrono>
 #include <memory>
 
 #include <glog/logging.h>
@@ -48,6 +49,14 @@ class Stream<T, Tag::kReadWrite> : public StreamBase<T> {
   void push(const T& val) { this->queue().push(ToBinaryString(val)); }
   T pop() { return FromBinaryString<T>(this->queue().pop()); }
   T front() const { return FromBinaryString<T>(this->queue().front()); }
+
+  // Block until the stream is not empty/full or `timeout` elapses.
+  bool wait_not_empty(std::chrono::nanoseconds timeout) const {
+    return this->queue().wait_not_empty(timeout);
+  }
+  bool wait_not_full(std::chrono::nanoseconds timeout) const {
+    return this->queue().wait_not_full(timeout);
+  }
 };
 
 }  // namespace internal
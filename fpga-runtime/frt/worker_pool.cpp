@@ -0,0 +1,496 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/worker_pool.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+#include <nlohmann/json.hpp>
+
+#include "frt/arg_info.h"
+#include "frt/buffer.h"
+#include "frt/buffer_arg.h"
+#include "frt/device.h"
+#include "frt/devices/shared_memory_buffer.h"
+#include "frt/stream_arg.h"
+#include "frt/tag.h"
+
+namespace fpga {
+
+namespace {
+
+using internal::Tag;
+
+bool IsLoaded(Tag tag) {
+  return tag == Tag::kWriteOnly || tag == Tag::kReadWrite;
+}
+
+bool IsStored(Tag tag) {
+  return tag == Tag::kReadOnly || tag == Tag::kReadWrite;
+}
+
+// Records the arguments set on an `Instance` in the parent so that they can be
+// sent to a helper.
+class ArgRecorder : public internal::Device {
+ public:
+  struct Arg {
+    bool is_buffer = false;
+    std::vector<uint8_t> scalar{};
+    Tag tag = Tag::kPlaceHolder;
+    internal::BufferArg buffer{};
+    bool is_suspended = false;
+  };
+
+  void SetScalarArg(size_t index, const void* arg, int size) override {
+    const auto* bytes = static_cast<const uint8_t*>(arg);
+    args_[index] = {.scalar = std::vector<uint8_t>(bytes, bytes + size)};
+  }
+  void SetBufferArg(size_t index, Tag tag,
+                    const internal::BufferArg& arg) override {
+    args_[index] = {.is_buffer = true, .tag = tag, .buffer = arg};
+  }
+  void SetStreamArg(size_t index, Tag tag, internal::StreamArg& arg) override {
+    LOG(FATAL) << "Stream arguments are not supported in worker pools";
+  }
+  size_t SuspendBuffer(size_t index) override {
+    auto it = args_.find(index);
+    if (it == args_.end() || !it->second.is_buffer) {
+      return 0;
+    }
+    it->second.is_suspended = true;
+    return IsLoaded(it->second.tag) + IsStored(it->second.tag);
+  }
+
+  void WriteToDevice() override {}
+  void ReadFromDevice() override {}
+  void Exec() override {}
+  void Finish() override {}
+  void Kill() override {}
+  bool IsFinished() const override { return true; }
+
+  std::vector<ArgInfo> GetArgsInfo() const override { return {}; }
+  int64_t LoadTimeNanoSeconds() const override { return 0; }
+  int64_t ComputeTimeNanoSeconds() const override { return 0; }
+  int64_t StoreTimeNanoSeconds() const override { return 0; }
+  size_t LoadBytes() const override { return 0; }
+  size_t StoreBytes() const override { return 0; }
+
+  const std::map<size_t, Arg>& args() const { return args_; }
+
+ private:
+  std::map<size_t, Arg> args_;
+};
+
+bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    // MSG_NOSIGNAL: a crashed helper must not raise SIGPIPE in the parent.
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool ReadAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = read(fd, data, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+// Messages are JSON documents prefixed by their length.
+bool WriteMessage(int fd, const std::string& message) {
+  const uint64_t size = message.size();
+  return WriteAll(fd, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+         WriteAll(fd, message.data(), message.size());
+}
+
+bool ReadMessage(int fd, std::string& message) {
+  uint64_t size = 0;
+  if (!ReadAll(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  message.resize(size);
+  return ReadAll(fd, message.data(), message.size());
+}
+
+// Sends `fd` over the Unix domain socket `socket`.
+bool SendFd(int socket, int fd) {
+  char byte = 0;
+  iovec iov = {.iov_base = &byte, .iov_len = sizeof(byte)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fd))] = {};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fd));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+  ssize_t n;
+  do {
+    n = sendmsg(socket, &msg, MSG_NOSIGNAL);
+  } while (n < 0 && errno == EINTR);
+  return n == sizeof(byte);
+}
+
+// Receives a file descriptor sent by `SendFd`. Returns -1 on failure.
+int ReceiveFd(int socket) {
+  char byte;
+  iovec iov = {.iov_base = &byte, .iov_len = sizeof(byte)};
+  int fd = -1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fd))] = {};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t n;
+  do {
+    n = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+  } while (n < 0 && errno == EINTR);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (n != sizeof(byte) || cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS) {
+    return -1;
+  }
+  memcpy(&fd, CMSG_DATA(cmsg), sizeof(fd));
+  return fd;
+}
+
+// Describes how a process exited given its wait status.
+std::string DescribeExit(pid_t pid, int status) {
+  std::string description = "Worker process " + std::to_string(pid);
+  if (WIFSIGNALED(status)) {
+    description += " was killed by signal " +
+                   std::to_string(WTERMSIG(status)) + " (" +
+                   strsignal(WTERMSIG(status)) + ")";
+  } else {
+    description += " exited with status " + std::to_string(WEXITSTATUS(status));
+  }
+  return description;
+}
+
+// Dies with the parent even if stuck, e.g., in the device runtime. Exits if
+// the parent is already gone.
+void DieWithParent(pid_t parent) {
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+  if (getppid() != parent) {
+    _exit(EXIT_FAILURE);
+  }
+}
+
+// Maps the shared memory object created by the parent.
+char* MapSharedMemory(const std::string& path, size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  int fd = shm_open(path.c_str(), O_RDWR, 0600);
+  PCHECK(fd >= 0) << "shm_open " << path;
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  PCHECK(ptr != MAP_FAILED) << "mmap " << path;
+  PLOG_IF(WARNING, close(fd)) << "close";
+  return static_cast<char*>(ptr);
+}
+
+}  // namespace
+
+WorkerPool::WorkerPool(const std::string& bitstream, int worker_count)
+    : WorkerPool(
+          [bitstream](int worker_index) {
+            return Instance(bitstream, worker_index);
+          },
+          worker_count) {}
+
+WorkerPool::WorkerPool(InstanceFactory new_instance, int worker_count)
+    : new_instance_(std::move(new_instance)) {
+  CHECK_GT(worker_count, 0) << "a worker pool needs at least one worker";
+  int fds[2];
+  PCHECK(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0)
+      << "socketpair";
+  const pid_t parent = getpid();
+  fork_server_pid_ = fork();
+  PCHECK(fork_server_pid_ != -1) << "fork";
+  if (fork_server_pid_ == 0) {
+    close(fds[0]);
+    DieWithParent(parent);
+    // Exceptions must not unwind into the caller's copy of the stack.
+    try {
+      ServeForks(fds[1]);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Fork server of the worker pool failed: " << e.what();
+      _exit(EXIT_FAILURE);
+    }
+    _exit(EXIT_SUCCESS);
+  }
+  close(fds[1]);
+  fork_server_fd_ = fds[0];
+
+  workers_.resize(worker_count);
+  std::unique_lock lock(mtx_);
+  for (int i = 0; i < worker_count; ++i) {
+    Spawn(i);
+    idle_workers_.push_back(i);
+  }
+  LOG(INFO) << "Forked " << worker_count << " worker process(es)";
+}
+
+WorkerPool::~WorkerPool() {
+  // Helpers exit once they read EOF from their sockets, and the fork server
+  // exits once it reads EOF and has reaped them.
+  for (Worker& worker : workers_) {
+    PLOG_IF(WARNING, close(worker.fd)) << __func__ << ": close";
+  }
+  PLOG_IF(WARNING, close(fork_server_fd_)) << __func__ << ": close";
+  int status = 0;
+  PLOG_IF(WARNING, waitpid(fork_server_pid_, &status, 0) != fork_server_pid_)
+      << __func__ << ": waitpid";
+  LOG_IF(WARNING, !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      << "Fork server " << fork_server_pid_ << " did not exit cleanly";
+}
+
+int WorkerPool::spawn_count() const {
+  std::unique_lock lock(mtx_);
+  return spawn_count_;
+}
+
+InvocationReport WorkerPool::Invoke(
+    const std::function<void(Instance&)>& set_args) {
+  auto recorder = std::make_unique<ArgRecorder>();
+  const ArgRecorder& args = *recorder;
+  Instance instance(std::move(recorder));
+  set_args(instance);
+
+  // Copy buffers to shared memory objects that the helper maps by path.
+  std::vector<std::unique_ptr<internal::SharedMemoryBuffer>> buffers;
+  nlohmann::json args_json = nlohmann::json::array();
+  for (const auto& [index, arg] : args.args()) {
+    if (!arg.is_buffer) {
+      args_json.push_back({{"index", index}, {"scalar", arg.scalar}});
+      continue;
+    }
+    const size_t size = arg.buffer.SizeInBytes();
+    const auto& buffer =
+        buffers.emplace_back(std::make_unique<internal::SharedMemoryBuffer>(
+            internal::SharedMemoryBuffer::Options{
+                .size = size,
+                .filename_template = "frt_worker_pool.XXXXXX",
+            }));
+    CHECK(size == 0 || buffer->data() != nullptr)
+        << "Cannot create shared memory for arg #" << index;
+    if (IsLoaded(arg.tag) && !arg.is_suspended && size > 0) {
+      memcpy(buffer->data(), arg.buffer.Get(), size);
+    }
+    args_json.push_back({
+        {"index", index},
+        {"tag", static_cast<int>(arg.tag)},
+        {"path", buffer->path()},
+        {"size", size},
+        {"suspended", arg.is_suspended},
+    });
+  }
+  const std::string request = nlohmann::json{{"args", args_json}}.dump();
+
+  int index;
+  {
+    std::unique_lock lock(mtx_);
+    idle_cv_.wait(lock, [this] { return !idle_workers_.empty(); });
+    index = idle_workers_.back();
+    idle_workers_.pop_back();
+  }
+
+  std::string response;
+  const int fd = workers_[index].fd;
+  const bool is_ok = WriteMessage(fd, request) && ReadMessage(fd, response);
+  std::string error;
+  {
+    std::unique_lock lock(mtx_);
+    if (!is_ok) {
+      error = Reap(workers_[index]);
+      Spawn(index);
+    }
+    idle_workers_.push_back(index);
+  }
+  idle_cv_.notify_one();
+  if (!is_ok) {
+    LOG(ERROR) << error << "; replaced it with a new worker process";
+    throw std::runtime_error(error);
+  }
+
+  size_t buffer_index = 0;
+  for (const auto& [index, arg] : args.args()) {
+    if (!arg.is_buffer) {
+      continue;
+    }
+    const auto& buffer = buffers[buffer_index++];
+    if (IsStored(arg.tag) && !arg.is_suspended && buffer->size() > 0) {
+      memcpy(arg.buffer.Get(), buffer->data(), buffer->size());
+    }
+  }
+  return InvocationReport::FromJson(response);
+}
+
+void WorkerPool::Spawn(int index) {
+  const std::string request = nlohmann::json{{"spawn", index}}.dump();
+  std::string response;
+  CHECK(WriteMessage(fork_server_fd_, request) &&
+        ReadMessage(fork_server_fd_, response))
+      << "The fork server of the worker pool is gone";
+  const int fd = ReceiveFd(fork_server_fd_);
+  CHECK_GE(fd, 0) << "Cannot receive the socket of worker process #" << index;
+  const pid_t pid = nlohmann::json::parse(response).at("pid");
+  workers_[index] = {.pid = pid, .fd = fd};
+  ++spawn_count_;
+  VLOG(1) << "Forked worker process #" << index << ": " << pid;
+}
+
+std::string WorkerPool::Reap(Worker& worker) {
+  PLOG_IF(WARNING, close(worker.fd)) << __func__ << ": close";
+  const std::string request = nlohmann::json{{"reap", worker.pid}}.dump();
+  std::string response;
+  CHECK(WriteMessage(fork_server_fd_, request) &&
+        ReadMessage(fork_server_fd_, response))
+      << "The fork server of the worker pool is gone";
+  const int status = nlohmann::json::parse(response).at("status");
+  std::string error = DescribeExit(worker.pid, status);
+  worker = {};
+  return error;
+}
+
+void WorkerPool::ServeForks(int fd) {
+  const pid_t server = getpid();
+  std::string request;
+  while (ReadMessage(fd, request)) {
+    const nlohmann::json job = nlohmann::json::parse(request);
+    if (job.contains("reap")) {
+      const pid_t pid = job["reap"];
+      int status = 0;
+      PCHECK(waitpid(pid, &status, 0) == pid) << "waitpid";
+      PCHECK(WriteMessage(fd, nlohmann::json{{"status", status}}.dump()))
+          << "Cannot send the exit status to the parent";
+      continue;
+    }
+
+    const int index = job.at("spawn");
+    int fds[2];
+    // Close-on-exec so that subprocesses of helpers, e.g., simulators, do not
+    // keep the sockets open.
+    PCHECK(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == 0)
+        << "socketpair";
+    const pid_t pid = fork();
+    PCHECK(pid != -1) << "fork";
+    if (pid == 0) {
+      // Helper; the fork server holds no sockets of other helpers.
+      close(fd);
+      close(fds[0]);
+      DieWithParent(server);
+      try {
+        Serve(index, fds[1]);
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Worker process #" << index << " failed: " << e.what();
+        _exit(EXIT_FAILURE);
+      }
+      _exit(EXIT_SUCCESS);
+    }
+    close(fds[1]);
+    PCHECK(WriteMessage(fd, nlohmann::json{{"pid", pid}}.dump()) &&
+           SendFd(fd, fds[0]))
+        << "Cannot send worker process #" << index << " to the parent";
+    close(fds[0]);
+  }
+
+  // The pool is destroyed and has closed the sockets of all helpers.
+  int status = 0;
+  for (pid_t pid; (pid = wait(&status)) > 0;) {
+    LOG_IF(WARNING, !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        << DescribeExit(pid, status);
+  }
+}
+
+void WorkerPool::Serve(int index, int fd) {
+  // Loaded upon the first invocation and kept for the later ones.
+  std::unique_ptr<Instance> instance;
+  std::string request;
+  while (ReadMessage(fd, request)) {
+    if (instance == nullptr) {
+      instance = std::make_unique<Instance>(new_instance_(index));
+    }
+
+    std::vector<std::pair<char*, size_t>> mappings;
+    const nlohmann::json job = nlohmann::json::parse(request);
+    for (const auto& arg : job.at("args")) {
+      const int arg_index = arg.at("index");
+      if (arg.contains("scalar")) {
+        const std::vector<uint8_t> scalar = arg["scalar"];
+        instance->device_->SetScalarArg(arg_index, scalar.data(),
+                                        scalar.size());
+        continue;
+      }
+      const auto tag = static_cast<Tag>(arg.at("tag").get<int>());
+      const size_t size = arg.at("size");
+      char* data = MapSharedMemory(arg.at("path"), size);
+      mappings.push_back({data, size});
+      instance->device_->SetBufferArg(
+          arg_index, tag,
+          internal::Buffer<char, Tag::kPlaceHolder>(data, size));
+      instance->RecordBufferArg(arg_index, tag, size);
+      if (arg.at("suspended")) {
+        instance->SuspendBuf(arg_index);
+      }
+    }
+
+    instance->WriteToDevice();
+    instance->Exec();
+    instance->ReadFromDevice();
+    instance->Finish();
+
+    for (auto [data, size] : mappings) {
+      if (data != nullptr) {
+        PLOG_IF(WARNING, munmap(data, size)) << "munmap";
+      }
+    }
+    const std::string report = instance->GetInvocationReport().ToJson();
+    PCHECK(WriteMessage(fd, report))
+        << "Cannot send the result to the parent";
+  }
+  VLOG(1) << "Worker process #" << index << " exiting";
+}
+
+}  // namespace fpga
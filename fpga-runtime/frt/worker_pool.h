@@ -0,0 +1,98 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef FPGA_RUNTIME_WORKER_POOL_H_
+#define FPGA_RUNTIME_WORKER_POOL_H_
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "frt.h"
+#include "frt/perf_report.h"
+
+namespace fpga {
+
+// A pool of pre-forked helper processes, each of which keeps its `Instance`
+// (and therefore the device and program) loaded across invocations. Buffers
+// are passed to helpers through shared memory, so a crash in the device
+// runtime or simulator only takes down the helper, as if each invocation ran
+// in a new process. Crashed helpers are replaced for later invocations.
+//
+// Helpers, including replacements, are forked by a fork server, a process that
+// never starts threads. Create the pool early, before the process starts other
+// threads, because the fork server is forked from the process that creates the
+// pool when it is created.
+class WorkerPool {
+ public:
+  // Creates the instance of the `worker_index`-th helper in that helper.
+  using InstanceFactory = std::function<Instance(int worker_index)>;
+
+  // Forks `worker_count` helpers. The `i`-th helper loads `bitstream` onto the
+  // `i`-th matching device when it runs its first invocation.
+  WorkerPool(const std::string& bitstream, int worker_count = 1);
+
+  // Forks `worker_count` helpers that create their instances with
+  // `new_instance`, e.g., ones with mock devices in tests.
+  WorkerPool(InstanceFactory new_instance, int worker_count);
+
+  // Not copyable or movable.
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Stops all helpers and waits for them to exit.
+  ~WorkerPool();
+
+  // Returns the number of helpers.
+  size_t size() const { return workers_.size(); }
+
+  // Returns the number of helpers forked so far, including replacements.
+  int spawn_count() const;
+
+  // Calls `set_args(instance)` to bind the arguments, then writes, executes,
+  // reads, and finishes the program in an idle helper, blocking until it is
+  // done. Buffers are copied to and from the helper according to their tags.
+  // Stream arguments and software kernels are not supported. Throws
+  // `std::runtime_error` if the helper crashes.
+  InvocationReport Invoke(const std::function<void(Instance&)>& set_args);
+
+ private:
+  struct Worker {
+    pid_t pid = -1;
+    int fd = -1;  // Parent end of the socket connected to the helper.
+  };
+
+  // Has the fork server fork the `index`-th helper. Must be called with `mtx_`
+  // held.
+  void Spawn(int index);
+
+  // Closes the socket of a helper, waits for it to exit, and describes its
+  // exit. Must be called with `mtx_` held.
+  std::string Reap(Worker& worker);
+
+  // Forks and reaps helpers as requested through `fd` until the parent closes
+  // it. Runs in the fork server.
+  void ServeForks(int fd);
+
+  // Runs invocations sent through `fd` until the parent closes it. Runs in a
+  // helper.
+  void Serve(int index, int fd);
+
+  InstanceFactory new_instance_;
+  pid_t fork_server_pid_ = -1;
+  int fork_server_fd_ = -1;  // Parent end of the socket to the fork server.
+  std::vector<Worker> workers_;
+  std::vector<int> idle_workers_;
+  int spawn_count_ = 0;
+  mutable std::mutex mtx_;
+  std::condition_variable idle_cv_;
+};
+
+}  // namespace fpga
+
+#endif  // FPGA_RUNTIME_WORKER_POOL_H_
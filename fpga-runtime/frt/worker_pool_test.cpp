@@ -0,0 +1,195 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "frt/worker_pool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "frt.h"
+#include "frt/device.h"
+#include "frt/devices/model_device.h"
+
+namespace fpga {
+namespace {
+
+// Adds scalar arg #1 to every int in buffer arg #0 and aborts if it is
+// negative. The compute time is the number of invocations in this process, so
+// tests can tell whether the device stays loaded.
+class MockDevice : public internal::Device {
+ public:
+  void SetScalarArg(size_t index, const void* arg, int size) override {
+    memcpy(&addend_, arg, sizeof(addend_));
+  }
+  void SetBufferArg(size_t index, internal::Tag tag,
+                    const internal::BufferArg& arg) override {
+    buffers_[index] = arg;
+  }
+  void SetStreamArg(size_t index, internal::Tag tag,
+                    internal::StreamArg& arg) override {}
+  size_t SuspendBuffer(size_t index) override { return 0; }
+
+  void WriteToDevice() override {}
+  void ReadFromDevice() override {}
+  void Exec() override { ++invocation_count_; }
+  void Finish() override {
+    if (addend_ < 0) {
+      abort();
+    }
+    const internal::BufferArg& arg = buffers_.at(0);
+    int* data = reinterpret_cast<int*>(arg.Get());
+    for (size_t i = 0; i < arg.SizeInBytes() / sizeof(int); ++i) {
+      data[i] += addend_;
+    }
+  }
+  void Kill() override {}
+  bool IsFinished() const override { return true; }
+
+  std::vector<ArgInfo> GetArgsInfo() const override { return {}; }
+  int64_t LoadTimeNanoSeconds() const override { return 0; }
+  int64_t ComputeTimeNanoSeconds() const override { return invocation_count_; }
+  int64_t StoreTimeNanoSeconds() const override { return 0; }
+  size_t LoadBytes() const override { return 0; }
+  size_t StoreBytes() const override { return 0; }
+
+ private:
+  std::unordered_map<size_t, internal::BufferArg> buffers_;
+  int addend_ = 0;
+  int invocation_count_ = 0;
+};
+
+Instance NewMockInstance(int worker_index) {
+  return Instance(std::make_unique<MockDevice>());
+}
+
+TEST(WorkerPoolTest, KeepsInstanceLoadedAcrossInvocations) {
+  WorkerPool pool(NewMockInstance, 1);
+  std::vector<int> data(1000);
+  std::iota(data.begin(), data.end(), 0);
+  for (int i = 1; i <= 3; ++i) {
+    InvocationReport report = pool.Invoke([&](Instance& instance) {
+      instance.SetArgs(ReadWrite(data.data(), data.size()), 1);
+    });
+    EXPECT_EQ(report.compute_ns, i);
+    ASSERT_EQ(report.args.size(), size_t{1});
+    EXPECT_EQ(report.args[0].load_bytes, data.size() * sizeof(int));
+  }
+  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+    EXPECT_EQ(data[i], i + 3);
+  }
+  EXPECT_EQ(pool.spawn_count(), 1);
+}
+
+TEST(WorkerPoolTest, RebindsBuffersOfEachInvocation) {
+  WorkerPool pool(
+      [](int worker_index) {
+        return Instance(std::make_unique<internal::ModelDevice>(
+            internal::ModelDevice::Options{}));
+      },
+      1);
+  for (size_t size : {size_t{4096}, size_t{64}, size_t{4 << 20}}) {
+    std::vector<char> data(size);
+    InvocationReport report = pool.Invoke([&](Instance& instance) {
+      instance.SetArgs(ReadWrite(data.data(), data.size()));
+    });
+    EXPECT_EQ(report.load_bytes, size);
+    EXPECT_EQ(report.store_bytes, size);
+  }
+  EXPECT_EQ(pool.spawn_count(), 1);
+}
+
+TEST(WorkerPoolTest, CopiesBuffersByTag) {
+  WorkerPool pool(NewMockInstance, 1);
+  std::vector<int> input(16, 1);
+  std::vector<int> output(16, 1);
+  pool.Invoke([&](Instance& instance) {
+    instance.SetArgs(WriteOnly(input.data(), input.size()), 5);
+  });
+  pool.Invoke([&](Instance& instance) {
+    instance.SetArgs(ReadOnly(output.data(), output.size()), 5);
+  });
+
+  // Results of write-only buffers are not copied back, and read-only buffers
+  // are not copied to the device.
+  EXPECT_EQ(input, std::vector<int>(16, 1));
+  EXPECT_EQ(output, std::vector<int>(16, 5));
+}
+
+TEST(WorkerPoolTest, ReplacesCrashedWorker) {
+  WorkerPool pool(NewMockInstance, 1);
+  std::vector<int> data(4);
+  EXPECT_THROW(pool.Invoke([&](Instance& instance) {
+                 instance.SetArgs(ReadWrite(data.data(), data.size()), -1);
+               }),
+               std::runtime_error);
+
+  InvocationReport report = pool.Invoke([&](Instance& instance) {
+    instance.SetArgs(ReadWrite(data.data(), data.size()), 2);
+  });
+  EXPECT_EQ(report.compute_ns, 1);  // The new worker loads a new instance.
+  EXPECT_EQ(data, std::vector<int>(4, 2));
+  EXPECT_EQ(pool.spawn_count(), 2);
+}
+
+TEST(WorkerPoolTest, RunsConcurrentInvocations) {
+  WorkerPool pool(NewMockInstance, 2);
+  EXPECT_EQ(pool.size(), size_t{2});
+  std::vector<std::vector<int>> data(8, std::vector<int>(64));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+    threads.emplace_back([&, i] {
+      pool.Invoke([&](Instance& instance) {
+        instance.SetArgs(ReadWrite(data[i].data(), data[i].size()), i);
+      });
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+    EXPECT_EQ(data[i], std::vector<int>(64, i));
+  }
+  EXPECT_EQ(pool.spawn_count(), 2);
+}
+
+TEST(WorkerPoolTest, ReplacesCrashedWorkersWhileOthersRun) {
+  WorkerPool pool(NewMockInstance, 2);
+  std::vector<std::vector<int>> data(8, std::vector<int>(64));
+  std::atomic<int> crash_count = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+    threads.emplace_back([&, i] {
+      // Odd invocations crash their workers.
+      const int addend = i % 2 ? -1 : i;
+      try {
+        pool.Invoke([&](Instance& instance) {
+          instance.SetArgs(ReadWrite(data[i].data(), data[i].size()), addend);
+        });
+      } catch (const std::runtime_error&) {
+        ++crash_count;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(crash_count, 4);
+  for (int i = 0; i < static_cast<int>(data.size()); i += 2) {
+    EXPECT_EQ(data[i], std::vector<int>(64, i));
+  }
+  EXPECT_EQ(pool.spawn_count(), 2 + 4);
+}
+
+}  // namespace
+}  // namespace fpga
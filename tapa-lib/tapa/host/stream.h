@@ -11,6 +11,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <deque>
 #include <fstream>
 #include <iomanip>
@@ -153,6 +154,8 @@ class locked_queue : public base_queue<T> {
 // Implementation of `base_queue` that is a wrapper of `fpga::Stream`
 template <typename T>
 class frt_queue : public base_queue<T> {
+  static constexpr std::chrono::microseconds kFrtWaitTimeout{100};
+
  public:
   explicit frt_queue(int64_t depth, const std::string& name)
       : base_queue<T>(name), stream_(depth) {}
@@ -162,8 +165,9 @@ class frt_queue : public base_queue<T> {
   bool empty() const override {
     if (this->stream_.empty()) {
       if (is_frt_arg_.load(std::memory_order_relaxed)) {
-        // Yield to the OS to allow the simulation to produce data.
-        sleep(0);
+        // Sleep until the simulation produces data, but not for too long so
+        // that other tasks sharing this thread can make progress.
+        return !this->stream_.wait_not_empty(kFrtWaitTimeout);
       }
       return true;
     } else {
@@ -173,8 +177,9 @@ class frt_queue : public base_queue<T> {
   bool full() const override {
     if (this->stream_.full()) {
       if (is_frt_arg_.load(std::memory_order_relaxed)) {
-        // Yield to the OS to allow the simulation to consume data.
-        sleep(0);
+        // Sleep until the simulation consumes data, but not for too long so
+        // that other tasks sharing this thread can make progress.
+        return !this->stream_.wait_not_full(kFrtWaitTimeout);
       }
       return true;
     } else {
@@ -57,6 +57,70 @@ inline int64_t invoke_in_new_process(Func&& f, const std::string& bitstream,
       std::forward<Args>(args)...);
 }
 
+/// Pre-forked helper processes for @c tapa::invoke_in_new_process.
+using worker_pool = fpga::WorkerPool;
+
+// Like `invoke_in_new_process`, but runs the kernel in a helper process of
+// `pool` that keeps the device and program loaded across invocations. Buffers
+// are copied through shared memory, so they need not be allocated via mmap.
+// Stream arguments are not supported.
+template <typename Func, typename... Args>
+inline int64_t invoke_in_new_process(Func&& f, worker_pool& pool,
+                                     Args&&... args) {
+  static_assert(std::is_function_v<typename std::remove_reference_t<Func>>,
+                "the first argument for tapa::invoke_in_new_process() must be "
+                "a function");
+  return internal::invoker<Func>::template invoke<Args...>(
+      pool, std::forward<Func>(f), std::forward<Args>(args)...);
+}
+
+/// Selects the @c index-th device matching @c bitstream for
+/// @c tapa::invoke_async.
+struct fpga_device {
+  std::string bitstream;
+  int index = 0;
+};
+
+// Host-only invoke that launches the kernel and returns without waiting for
+// it, so that several invocations may be outstanding at the same time. Each
+// invocation loads its own instance of the bitstream. The returned handle
+// carries the kernel time and errors.
+template <typename Func, typename... Args>
+inline async_invocation invoke_async(Func&& f, const fpga_device& device,
+                                     Args&&... args) {
+  static_assert(std::is_function_v<typename std::remove_reference_t<Func>>,
+                "the first argument for tapa::invoke_async() must be a "
+                "function");
+  return internal::invoker<Func>::template invoke_async<Args...>(
+      std::forward<Func>(f), device.bitstream, device.index,
+      std::forward<Args>(args)...);
+}
+
+template <typename Func, typename... Args>
+inline async_invocation invoke_async(Func&& f, const std::string& bitstream,
+                                     Args&&... args) {
+  return invoke_async(std::forward<Func>(f), fpga_device{bitstream},
+                      std::forward<Args>(args)...);
+}
+
+/// Runs invocations of the same simulated bitstream on a bounded pool of
+/// simulator processes for @c tapa::invoke_async.
+using cosim_farm = fpga::CosimFarm;
+
+// Queues an invocation on `farm` and returns without waiting for it. At most
+// `farm.size()` invocations run at a time, each in its own work directory.
+// Arguments are copied, but the buffers they refer to must remain valid until
+// the invocation finishes.
+template <typename Func, typename... Args>
+inline async_invocation invoke_async(Func&& f, cosim_farm& farm,
+                                     Args&&... args) {
+  static_assert(std::is_function_v<typename std::remove_reference_t<Func>>,
+                "the first argument for tapa::invoke_async() must be a "
+                "function");
+  return internal::invoker<Func>::template invoke_async<Args...>(
+      farm, std::forward<Func>(f), std::forward<Args>(args)...);
+}
+
 template <typename T>
 struct aligned_allocator {
   using value_type = T;
@@ -11,8 +11,10 @@
 #include <algorithm>
 #include <atomic>
 #include <deque>
+#include <exception>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -67,17 +69,6 @@ void reschedule_this_thread() {
 
 namespace internal {
 
-// Signal handler for SIGINT to kill running kernel instance,
-// when the tapa::invoke synchronous kernel is running.
-fpga::Instance* frt_sync_kernel_instance = nullptr;
-extern "C" void kill_frt_sync_kernel(int) {
-  if (frt_sync_kernel_instance) {
-    frt_sync_kernel_instance->Kill();
-    frt_sync_kernel_instance = nullptr;
-  }
-  exit(EXIT_FAILURE);
-}
-
 namespace {
 
 thread_local pull_type* current_handle = nullptr;
@@ -491,8 +482,145 @@ void deallocate(void* addr, size_t length) {
   if (::munmap(addr, length) != 0) throw std::bad_alloc();
 }
 
+namespace {
+
+// Kernel instances launched by `tapa::invoke` or `tapa::invoke_async` that are
+// still running. Slots are allocated in chunks as needed and never freed, so
+// that the SIGINT handler can read them without locking.
+constexpr int kFrtKernelChunkSize = 256;
+struct FrtKernelChunk {
+  std::atomic<fpga::Instance*> slots[kFrtKernelChunkSize] = {};
+  std::atomic<FrtKernelChunk*> next = nullptr;
+};
+FrtKernelChunk frt_kernels;
+int frt_kernel_count = 0;
+std::mutex frt_kernel_mtx;
+
+// Signal handler for SIGINT to kill running kernel instances.
+extern "C" void kill_frt_kernels(int) {
+  for (FrtKernelChunk* chunk = &frt_kernels; chunk != nullptr;
+       chunk = chunk->next) {
+    for (auto& slot : chunk->slots) {
+      if (fpga::Instance* instance = slot.exchange(nullptr)) {
+        instance->Kill();
+      }
+    }
+  }
+  exit(EXIT_FAILURE);
+}
+
+// Stores `desired` in the first slot holding `expected` and returns whether
+// there is one.
+bool replace_frt_kernel(fpga::Instance* expected, fpga::Instance* desired) {
+  for (FrtKernelChunk* chunk = &frt_kernels; chunk != nullptr;
+       chunk = chunk->next) {
+    for (auto& slot : chunk->slots) {
+      fpga::Instance* actual = expected;
+      if (slot.compare_exchange_strong(actual, desired)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+void register_frt_kernel(fpga::Instance* instance) {
+  std::unique_lock<std::mutex> lock(frt_kernel_mtx);
+  if (frt_kernel_count++ == 0) {
+    signal(SIGINT, &kill_frt_kernels);
+  }
+  if (replace_frt_kernel(nullptr, instance)) {
+    return;
+  }
+
+  // All slots are taken; append a new chunk.
+  FrtKernelChunk* last = &frt_kernels;
+  while (last->next != nullptr) {
+    last = last->next;
+  }
+  auto* chunk = new FrtKernelChunk;
+  chunk->slots[0] = instance;
+  last->next = chunk;
+}
+
+void unregister_frt_kernel(fpga::Instance* instance) {
+  std::unique_lock<std::mutex> lock(frt_kernel_mtx);
+  CHECK(replace_frt_kernel(instance, nullptr))
+      << "kernel instance is not registered";
+  if (--frt_kernel_count == 0) {
+    signal(SIGINT, SIG_DFL);
+  }
+}
+
 }  // namespace internal
 
+async_invocation::async_invocation(std::unique_ptr<fpga::Instance> instance)
+    : instance_(std::move(instance)) {}
+
+async_invocation::async_invocation(std::future<int64_t> software_simulation)
+    : software_simulation_(std::move(software_simulation)) {}
+
+async_invocation::async_invocation(std::exception_ptr error)
+    : error_(std::move(error)) {}
+
+async_invocation& async_invocation::operator=(async_invocation&& other) {
+  if (this != &other) {
+    wait();
+    instance_ = std::move(other.instance_);
+    software_simulation_ = std::move(other.software_simulation_);
+    error_ = std::move(other.error_);
+    kernel_time_ns_ = std::move(other.kernel_time_ns_);
+  }
+  return *this;
+}
+
+async_invocation::~async_invocation() { wait(); }
+
+bool async_invocation::ready() const {
+  if (kernel_time_ns_.has_value() || error_ != nullptr) {
+    return true;
+  }
+  if (instance_ != nullptr) {
+    return instance_->IsFinished();
+  }
+  return !software_simulation_.valid() ||
+         software_simulation_.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready;
+}
+
+void async_invocation::wait() {
+  if (kernel_time_ns_.has_value() || error_ != nullptr) {
+    return;
+  }
+  try {
+    if (instance_ != nullptr) {
+      try {
+        instance_->Finish();
+      } catch (...) {
+        internal::unregister_frt_kernel(instance_.get());
+        throw;
+      }
+      internal::unregister_frt_kernel(instance_.get());
+      kernel_time_ns_ = instance_->ComputeTimeNanoSeconds();
+    } else if (software_simulation_.valid()) {
+      kernel_time_ns_ = software_simulation_.get();
+    }
+  } catch (...) {
+    error_ = std::current_exception();
+  }
+}
+
+int64_t async_invocation::get() {
+  wait();
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  CHECK(kernel_time_ns_.has_value()) << "invalid tapa::async_invocation";
+  return *kernel_time_ns_;
+}
+
 task& task::invoke_frt(std::shared_ptr<fpga::Instance> instance) {
   instance->WriteToDevice();
   instance->Exec();
@@ -13,21 +13,61 @@
 #include <sys/wait.h>
 #include <unistd.h>
 #include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
 #include <frt.h>
+#include <frt/cosim_farm.h>
+#include <frt/worker_pool.h>
 
 namespace tapa {
 
+/// Handle of a kernel invocation launched by @c tapa::invoke_async.
+///
+/// The kernel runs while the handle is alive; destroying the handle waits for
+/// the kernel to finish.
+class async_invocation {
+ public:
+  explicit async_invocation(std::unique_ptr<fpga::Instance> instance);
+  explicit async_invocation(std::future<int64_t> software_simulation);
+  explicit async_invocation(std::exception_ptr error);
+
+  // Move-only.
+  async_invocation(async_invocation&&) = default;
+  async_invocation& operator=(async_invocation&& other);
+
+  ~async_invocation();
+
+  /// Returns whether the kernel has finished, without blocking.
+  bool ready() const;
+
+  /// Waits for the kernel to finish and its outputs to be read back.
+  void wait();
+
+  /// Waits for the kernel and returns the kernel time in nanoseconds. Rethrows
+  /// the error if the invocation failed.
+  int64_t get();
+
+ private:
+  std::unique_ptr<fpga::Instance> instance_;
+  std::future<int64_t> software_simulation_;
+  std::exception_ptr error_;
+  std::optional<int64_t> kernel_time_ns_;
+};
+
 namespace internal {
 
-extern fpga::Instance* frt_sync_kernel_instance;
-extern "C" void kill_frt_sync_kernel(int);
+// Registers a running kernel instance to be killed on SIGINT.
+void register_frt_kernel(fpga::Instance* instance);
+void unregister_frt_kernel(fpga::Instance* instance);
 
 template <typename Param, typename Arg>
 struct accessor {
@@ -150,6 +190,80 @@ struct invoker {
     }
   }
 
+  template <typename... Args>
+  static int64_t invoke(fpga::WorkerPool& pool, F&& f, Args&&... args) {
+    return pool
+        .Invoke([&](fpga::Instance& instance) {
+          set_fpga_args(instance, std::forward<F>(f),
+                        std::index_sequence_for<Args...>{},
+                        std::forward<Args>(args)...);
+        })
+        .compute_ns;
+  }
+
+  template <typename... Args>
+  static async_invocation invoke_async(F&& f, const std::string& bitstream,
+                                       int device_index, Args&&... args) {
+    // Unlike `invoke`, the caller may destroy arguments before the kernel
+    // finishes, so software kernels own copies of them.
+    if (bitstream.empty()) {
+      LOG(INFO) << "running software simulation with TAPA library";
+      auto kernel = [func = FuncType(f),
+                     copies = std::make_tuple(std::decay_t<Args>(
+                         std::forward<Args>(args))...)]() mutable {
+        const auto tic = std::chrono::steady_clock::now();
+        std::apply(func, copies);
+        const auto toc = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(toc - tic)
+            .count();
+      };
+      return async_invocation(
+          std::async(std::launch::async, std::move(kernel)));
+    }
+
+    std::unique_ptr<fpga::Instance> instance;
+    try {
+      instance = std::make_unique<fpga::Instance>(bitstream, device_index);
+      register_frt_kernel(instance.get());
+      // Copy the arguments only if the device runs the software kernel.
+      if (instance->UsesSoftwareKernel()) {
+        instance->SetSoftwareKernel(copy_kernel(f, args...));
+      }
+      set_fpga_args(*instance, std::forward<F>(f),
+                    std::index_sequence_for<Args...>{},
+                    std::forward<Args>(args)...);
+      instance->WriteToDevice();
+      instance->Exec();
+      instance->ReadFromDevice();
+    } catch (...) {
+      if (instance != nullptr) {
+        unregister_frt_kernel(instance.get());
+      }
+      return async_invocation(std::current_exception());
+    }
+    return async_invocation(std::move(instance));
+  }
+
+  template <typename... Args>
+  static async_invocation invoke_async(fpga::CosimFarm& farm, F&& f,
+                                       Args&&... args) {
+    // The run starts later, so it binds copies of the arguments.
+    auto set_args = [func = FuncType(f),
+                     copies = std::make_tuple(std::decay_t<Args>(args)...)](
+                        fpga::Instance& instance) mutable {
+      std::apply(
+          [&](auto&... copy) {
+            set_fpga_args(instance, func, std::index_sequence_for<Args...>{},
+                          std::move(copy)...);
+          },
+          copies);
+    };
+    return async_invocation(farm.Submit(
+        std::move(set_args), [](fpga::Instance& instance) {
+          return instance.ComputeTimeNanoSeconds();
+        }));
+  }
+
   template <typename Func, size_t... Is, typename... CapturedArgs>
   static void set_fpga_args(fpga::Instance& instance, Func&& func,
                             std::index_sequence<Is...>,
@@ -166,28 +280,40 @@ struct invoker {
   static int64_t invoke(F&& f, const std::string& bitstream, Args&&... args) {
     auto instance = fpga::Instance(bitstream);
 
-    // Register SIGINT handler to kill the kernel.
-    CHECK(frt_sync_kernel_instance == nullptr)
-        << "kernel instance already exists";
-    frt_sync_kernel_instance = &instance;
-    signal(SIGINT, &kill_frt_sync_kernel);
+    // Kill the kernel on SIGINT.
+    register_frt_kernel(&instance);
 
     set_fpga_args(instance, std::forward<F>(f),
                   std::index_sequence_for<Args...>{},
                   std::forward<Args>(args)...);
+    // Model devices may run the software simulation as the computation.
+    if (instance.UsesSoftwareKernel()) {
+      instance.SetSoftwareKernel([&] { f(args...); });
+    }
     instance.WriteToDevice();
     instance.Exec();
     instance.ReadFromDevice();
     instance.Finish();
 
-    // Unregister SIGINT handler.
-    signal(SIGINT, SIG_DFL);
-    CHECK(frt_sync_kernel_instance == &instance) << "kernel instance mismatch";
-    frt_sync_kernel_instance = nullptr;
+    unregister_frt_kernel(&instance);
 
     return instance.ComputeTimeNanoSeconds();
   }
 
+  // Returns a software kernel that runs `f` on copies of `args`.
+  template <typename... Args>
+  static std::function<void()> copy_kernel(F& f, const Args&... args) {
+    if constexpr ((std::is_copy_constructible_v<std::decay_t<Args>> && ...)) {
+      auto copies =
+          std::make_shared<std::tuple<std::decay_t<Args>...>>(args...);
+      return [func = FuncType(f), copies] { std::apply(func, *copies); };
+    } else {
+      LOG(FATAL) << "the device runs the software kernel, which needs copies "
+                    "of the arguments, but some of them are not copyable";
+      return {};
+    }
+  }
+
   template <typename Func, size_t... Is, typename... CapturedArgs>
   static auto functor_with_accessors(bool is_sequential, Func&& func,
                                      std::index_sequence<Is...>,
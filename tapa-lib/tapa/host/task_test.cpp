@@ -4,7 +4,12 @@
 
 #include "tapa/host/task.h"
 
+#include <fstream>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 
@@ -64,5 +69,140 @@ TEST(TaskTest, InvokingTemplatedTaskWorks) {
       .invoke(DataSource, data_q, kN);
 }
 
+void Double(tapa::mmap<int> data, int n) {
+  for (int i = 0; i < n; ++i) {
+    data[i] *= 2;
+  }
+}
+
+// Converts to the `int` param of `Double` but cannot be copied.
+class MoveOnlyInt {
+ public:
+  explicit MoveOnlyInt(int value) : value_(value) {}
+  MoveOnlyInt(MoveOnlyInt&&) = default;
+  MoveOnlyInt& operator=(MoveOnlyInt&&) = default;
+
+  operator int() const { return value_; }
+
+ private:
+  int value_;
+};
+
+TEST(TaskTest, InvokeAsyncAllowsOutstandingSoftwareSimulations) {
+  std::vector<int> first_data(kN, 1);
+  std::vector<int> second_data(kN, 2);
+  auto first = tapa::invoke_async(
+      Double, "", tapa::read_write_mmap<int>(first_data), kN);
+  auto second = tapa::invoke_async(
+      Double, "", tapa::read_write_mmap<int>(second_data), kN);
+  EXPECT_GE(second.get(), 0);
+  EXPECT_GE(first.get(), 0);
+  EXPECT_TRUE(first.ready());
+  EXPECT_EQ(first_data, std::vector<int>(kN, 2));
+  EXPECT_EQ(second_data, std::vector<int>(kN, 4));
+}
+
+TEST(TaskTest, InvokeAsyncTakesMoveOnlyArgs) {
+  std::vector<int> data(kN, 1);
+  auto invocation = tapa::invoke_async(
+      Double, "", tapa::read_write_mmap<int>(data), MoveOnlyInt(kN));
+  EXPECT_GE(invocation.get(), 0);
+  EXPECT_EQ(data, std::vector<int>(kN, 2));
+}
+
+TEST(TaskTest, InvokeAsyncAllowsOutstandingKernelInstances) {
+  const std::string manifest = testing::TempDir() + "model-device." +
+                               std::to_string(getpid()) + ".json";
+  std::ofstream(manifest) << R"({
+    "kind": "frt-model-device",
+    "compute": {"mode": "software"},
+    "device_count": 3
+  })";
+
+  std::vector<std::vector<int>> data(3, std::vector<int>(kN, 1));
+  std::vector<tapa::async_invocation> invocations;
+  for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+    invocations.push_back(tapa::invoke_async(
+        Double, tapa::fpga_device{manifest, /*index=*/i},
+        tapa::read_write_mmap<int>(data[i]), kN));
+  }
+  for (auto& invocation : invocations) {
+    EXPECT_GE(invocation.get(), 0);
+  }
+  for (const auto& datum : data) {
+    EXPECT_EQ(datum, std::vector<int>(kN, 2));
+  }
+  unlink(manifest.c_str());
+}
+
+TEST(TaskTest, InvokeAsyncAllowsManyOutstandingKernelInstances) {
+  const std::string manifest = testing::TempDir() + "model-device." +
+                               std::to_string(getpid()) + ".json";
+  std::ofstream(manifest) << R"({
+    "kind": "frt-model-device",
+    "compute": {"mode": "fixed", "duration_us": 0}
+  })";
+
+  // More than fit in the first chunk of the SIGINT kill list.
+  std::vector<int> data(kN, 1);
+  std::vector<tapa::async_invocation> invocations;
+  for (int i = 0; i < 300; ++i) {
+    invocations.push_back(tapa::invoke_async(
+        Double, manifest, tapa::read_write_mmap<int>(data), MoveOnlyInt(kN)));
+  }
+  for (auto& invocation : invocations) {
+    EXPECT_GE(invocation.get(), 0);
+  }
+  unlink(manifest.c_str());
+}
+
+TEST(TaskTest, InvokeAsyncRunsOnCosimFarm) {
+  const std::string manifest = testing::TempDir() + "model-device." +
+                               std::to_string(getpid()) + ".json";
+  std::ofstream(manifest) << R"({
+    "kind": "frt-model-device",
+    "compute": {"mode": "fixed", "duration_us": 1000}
+  })";
+
+  tapa::cosim_farm farm(manifest, /*max_parallel=*/2);
+  std::vector<int> data(kN, 1);
+  std::vector<tapa::async_invocation> invocations;
+  for (int i = 0; i < 4; ++i) {
+    invocations.push_back(tapa::invoke_async(
+        Double, farm, tapa::read_write_mmap<int>(data), kN));
+  }
+  for (auto& invocation : invocations) {
+    EXPECT_GE(invocation.get(), 1000000);
+  }
+  unlink(manifest.c_str());
+}
+
+TEST(TaskTest, InvokeInNewProcessReusesWorkerPool) {
+  const std::string manifest = testing::TempDir() + "model-device." +
+                               std::to_string(getpid()) + ".json";
+  std::ofstream(manifest) << R"({
+    "kind": "frt-model-device",
+    "compute": {"mode": "fixed", "duration_us": 1000}
+  })";
+
+  tapa::worker_pool pool(manifest);
+  std::vector<int> data(kN, 1);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_GE(tapa::invoke_in_new_process(
+                  Double, pool, tapa::read_write_mmap<int>(data), kN),
+              1000000);
+  }
+  EXPECT_EQ(pool.spawn_count(), 1);  // Both ran in the same worker process.
+  EXPECT_EQ(data, std::vector<int>(kN, 1));  // Fixed-duration compute.
+  unlink(manifest.c_str());
+}
+
+TEST(TaskTest, InvokeAsyncCarriesErrors) {
+  tapa::async_invocation invocation(
+      std::make_exception_ptr(std::runtime_error("failed")));
+  EXPECT_TRUE(invocation.ready());
+  EXPECT_THROW(invocation.get(), std::runtime_error);
+}
+
 }  // namespace
 }  // namespace tapa
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+`default_nettype none
+
+// Counts cycles in which each bit of `enable` is asserted, and serves the
+// 64-bit counters as read-only AXI-Lite registers. Counter `i` is at
+// `BaseAddr + 8 * i` (low word) and `BaseAddr + 8 * i + 4` (high word). Reads
+// below `BaseAddr` are forwarded to the control registers. `clear` resets all
+// counters.
+module perf_counters #(
+  parameter AddrWidth    = 12,
+  parameter BaseAddr     = 'h800,
+  parameter CounterCount = 1
+) (
+  input wire clk,
+  input wire rst,
+
+  input wire                    clear,
+  input wire [CounterCount-1:0] enable,
+
+  // read channels from the host
+  input  wire                 s_axi_ARVALID,
+  output wire                 s_axi_ARREADY,
+  input  wire [AddrWidth-1:0] s_axi_ARADDR,
+  output wire                 s_axi_RVALID,
+  input  wire                 s_axi_RREADY,
+  output wire [31:0]          s_axi_RDATA,
+  output wire [1:0]           s_axi_RRESP,
+
+  // read channels to the control registers
+  output wire                 m_axi_ARVALID,
+  input  wire                 m_axi_ARREADY,
+  output wire [AddrWidth-1:0] m_axi_ARADDR,
+  input  wire                 m_axi_RVALID,
+  output wire                 m_axi_RREADY,
+  input  wire [31:0]          m_axi_RDATA,
+  input  wire [1:0]           m_axi_RRESP
+);
+  reg [63:0] counters [0:CounterCount-1];
+
+  integer i;
+  always @(posedge clk) begin
+    for (i = 0; i < CounterCount; i = i + 1) begin
+      if (rst || clear) begin
+        counters[i] <= 64'd0;
+      end else if (enable[i]) begin
+        counters[i] <= counters[i] + 64'd1;
+      end
+    end
+  end
+
+  // Only one read is in flight at a time, either to the counters or to the
+  // control registers, so responses are returned in order.
+  reg        counter_pending;
+  reg        control_pending;
+  reg [31:0] counter_rdata;
+
+  wire                 is_counter = s_axi_ARADDR >= BaseAddr;
+  wire [AddrWidth-1:0] offset     = s_axi_ARADDR - BaseAddr;
+  wire [AddrWidth-4:0] index      = offset[AddrWidth-1:3];
+
+  wire counter_ar_hs =
+      s_axi_ARVALID && is_counter && !counter_pending && !control_pending;
+
+  assign m_axi_ARVALID = s_axi_ARVALID && !is_counter && !counter_pending;
+  assign m_axi_ARADDR  = s_axi_ARADDR;
+  assign m_axi_RREADY  = s_axi_RREADY && !counter_pending;
+  assign s_axi_ARREADY = is_counter ? !counter_pending && !control_pending :
+                                      m_axi_ARREADY && !counter_pending;
+  assign s_axi_RVALID  = counter_pending || m_axi_RVALID;
+  assign s_axi_RDATA   = counter_pending ? counter_rdata : m_axi_RDATA;
+  assign s_axi_RRESP   = counter_pending ? 2'b00 : m_axi_RRESP;
+
+  always @(posedge clk) begin
+    if (rst) begin
+      counter_pending <= 1'b0;
+      control_pending <= 1'b0;
+    end else begin
+      if (counter_ar_hs) begin
+        counter_pending <= 1'b1;
+      end else if (counter_pending && s_axi_RREADY) begin
+        counter_pending <= 1'b0;
+      end
+
+      if (m_axi_ARVALID && m_axi_ARREADY) begin
+        control_pending <= 1'b1;
+      end else if (m_axi_RVALID && m_axi_RREADY) begin
+        control_pending <= 1'b0;
+      end
+    end
+
+    if (counter_ar_hs) begin
+      if (index >= CounterCount) begin
+        counter_rdata <= 32'd0;
+      end else if (offset[2]) begin
+        counter_rdata <= counters[index][63:32];
+      end else begin
+        counter_rdata <= counters[index][31:0];
+      end
+    end
+  end
+
+endmodule  // perf_counters
+
+`default_nettype wire
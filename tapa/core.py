@@ -78,6 +78,12 @@ from tapa.verilog.xilinx.const import (
     TRUE,
 )
 from tapa.verilog.xilinx.module import Module, generate_m_axi_ports, get_streams_fifos
+from tapa.verilog.xilinx.perf_counters import (
+    PerfCounter,
+    add_perf_counters,
+    get_perf_counters,
+    get_perf_counters_offset,
+)
 
 _logger = logging.getLogger().getChild(__name__)
 
@@ -267,6 +273,7 @@ class Program(  # TODO: refactor this class
             "fifo_fwd.v",
             "fifo_srl.v",
             "generate_last.v",
+            "perf_counters.v",
             "priority_encoder.v",
             "relay_station.v",
             "a_axi_write_broadcastor_1_to_3.v",
@@ -307,23 +314,42 @@ class Program(  # TODO: refactor this class
     def generate_top_rtl(
         self,
         override_report_schema_version: str,
+        enable_perf_counters: bool = False,
     ) -> None:
         """Instrument HDL files generated from HLS.
 
         Args:
             override_report_schema_version: Override the schema version with the
                 given string, if non-empty.
+            enable_perf_counters: Count busy and blocked cycles of each task
+                instance and full and empty cycles of each FIFO in the top-level
+                task, readable as `s_axi_control` registers.
         """
         if self.top_task.name in self.gen_templates:
             msg = "top task cannot be a template"
             raise ValueError(msg)
 
+        perf_counters: list[PerfCounter] = []
+        perf_counters_offset = 0
+        if enable_perf_counters:
+            if self.target != Target.XILINX_VITIS or not self.top_task.is_upper:
+                msg = "performance counters require an upper-level top task in Vitis"
+                raise ValueError(msg)
+            perf_counters = get_perf_counters(self.top_task)
+            # Computed before instrumenting, which widens the control registers.
+            perf_counters_offset = get_perf_counters_offset(self.top_task.module)
+
         # instrument the top-level RTL if it is a upper-level task
         if self.top_task.is_upper:
-            self._instrument_upper_and_template_task(self.top_task)
+            self._instrument_upper_and_template_task(self.top_task, perf_counters)
 
         _logger.info("generating report")
         task_report = self.top_task.report
+        if perf_counters:
+            task_report["perf_counters"] = {
+                "offset": perf_counters_offset,
+                "counters": [x.report for x in perf_counters],
+            }
         if override_report_schema_version:
             task_report["schema"] = override_report_schema_version
         with open(self.report_paths.yaml, "w", encoding="utf-8") as fp:
@@ -666,12 +692,17 @@ class Program(  # TODO: refactor this class
 
         if task.is_upper:
             for arg, tag in async_mmap_args.items():
+                # burst engine configuration of `[[tapa::burst]]` mmaps
+                port = getattr(arg.instance.task, "ports", {}).get(arg.port)
+                burst_len = None if port is None else port.burst_len
                 task.module.add_async_mmap_instance(
                     name=arg.mmap_name,
                     tags=tag,
                     rst=RST,
                     data_width=width_table[arg.name],
                     addr_width=addr_width,
+                    buffer_size=None if port is None else port.max_outstanding,
+                    max_burst_len=None if burst_len is None else burst_len - 1,
                 )
 
             task.module.add_instance(
@@ -754,6 +785,7 @@ class Program(  # TODO: refactor this class
     def _instrument_upper_and_template_task(  # noqa: C901, PLR0912 # TODO: refactor this method
         self,
         task: Task,
+        perf_counters: list[PerfCounter] | None = None,
     ) -> None:
         """Codegen for the top task."""
         # assert task.is_upper
@@ -809,6 +841,8 @@ class Program(  # TODO: refactor this class
             width_table = {port.name: port.width for port in task.ports.values()}
             is_done_signals = self._instantiate_children_tasks(task, width_table)
             self._instantiate_global_fsm(task.fsm_module, is_done_signals)
+            if perf_counters:
+                add_perf_counters(task.module, perf_counters)
 
             with open(
                 self.get_rtl_path(task.fsm_module.name),
@@ -8,11 +8,12 @@ import logging
 import os
 import os.path
 import re
+import shutil
 import signal
 import subprocess
 import sys
 from collections import defaultdict
-from collections.abc import Sequence
+from collections.abc import Collection, Sequence
 from contextlib import suppress
 from io import TextIOWrapper
 from pathlib import Path
@@ -21,8 +22,16 @@ import click
 import psutil
 
 from tapa import __version__
-from tapa.cosim.common import AXI, Arg
+from tapa.cosim.common import AXI, DEFAULT_STREAM_BATCH_SIZE, Arg
 from tapa.cosim.config_preprocess import preprocess_config
+from tapa.cosim.memory_model import get_memory_model
+from tapa.cosim.snapshot_cache import (
+    get_plusargs,
+    get_snapshot_key,
+    link_snapshot,
+    locked_snapshot_dir,
+    mark_ready,
+)
 from tapa.cosim.templates import (
     get_axi_ram_inst,
     get_axi_ram_module,
@@ -32,11 +41,17 @@ from tapa.cosim.templates import (
     get_fifo,
     get_hls_dut,
     get_hls_test_signals,
+    get_perf_counters,
     get_s_axi_control,
     get_srl_fifo_template,
     get_vitis_dut,
     get_vitis_test_signals,
 )
+from tapa.cosim.verilator import (
+    copy_memory_init_files,
+    get_verilator_binary,
+    get_verilator_command,
+)
 from tapa.cosim.vivado import get_vivado_tcl
 
 [logging.root.removeHandler(handler) for handler in logging.root.handlers]
@@ -110,23 +125,51 @@ def get_cosim_tb(  # noqa: PLR0913,PLR0917
     args: Sequence[Arg],
     scalar_to_val: dict[str, str],
     mode: str,
+    stream_batch_size: int = DEFAULT_STREAM_BATCH_SIZE,
+    perf_counters_path: str | None = None,
+    rtl_perf_counters: dict | None = None,
+    host_buffer_axis: Collection[str] = (),
 ) -> str:
-    """Generate a lightweight testbench to test the HLS RTL."""
+    """Generate a lightweight testbench to test the HLS RTL.
+
+    AXI ports in `host_buffer_axis` access the host buffers in place and use
+    their full address width.
+
+    If `perf_counters_path` is not None, the testbench counts performance
+    counters and writes them to the path as JSON when the kernel finishes,
+    including `rtl_perf_counters` instantiated in the kernel, if any.
+    """
     tb = get_begin() + "\n"
 
     for axi in axi_list:
-        tb += get_axi_ram_inst(axi) + "\n"
+        if axi.name in host_buffer_axis:
+            tb += get_axi_ram_inst(axi, axi.addr_width) + "\n"
+        else:
+            tb += get_axi_ram_inst(axi) + "\n"
 
     if mode == "vitis":
         arg_to_reg_addrs = parse_register_addr(s_axi_control_path)
         tb += get_s_axi_control() + "\n"
         tb += get_axis(args) + "\n"
         tb += get_vitis_dut(top_name, args) + "\n"
-        tb += get_vitis_test_signals(arg_to_reg_addrs, scalar_to_val, args)
+        tb += get_vitis_test_signals(
+            arg_to_reg_addrs,
+            scalar_to_val,
+            args,
+            stream_batch_size,
+            perf_counters_path is not None,
+        )
     else:
         tb += get_fifo(args) + "\n"
         tb += get_hls_dut(top_name, top_is_leaf_task, args, scalar_to_val) + "\n"
-        tb += get_hls_test_signals(args)
+        tb += get_hls_test_signals(
+            args, stream_batch_size, perf_counters_path is not None
+        )
+
+    if perf_counters_path is not None:
+        tb += get_perf_counters(
+            axi_list, args, mode, perf_counters_path, rtl_perf_counters
+        )
 
     tb += get_end() + "\n"
 
@@ -157,13 +200,44 @@ def set_default_nettype(verilog_path: str) -> None:
 @click.option("--launch-simulation / --no-launch-simulation", type=bool, default=False)
 @click.option("--save-waveform / --no-save-waveform", type=bool, default=False)
 @click.option("--start-gui / --no-start-gui", type=bool, default=False)
-def main(  # noqa: PLR0913, PLR0917
+@click.option(
+    "--snapshot-cache-dir",
+    type=str,
+    default=None,
+    help="Cache compiled simulation snapshots in this directory and reuse them "
+    "for runs of the same kernel with different scalars and data.",
+)
+@click.option(
+    "--simulator",
+    type=click.Choice(["xsim", "verilator"]),
+    default="xsim",
+    help="Simulate with Vivado xsim, or with Verilator which needs no Vivado "
+    "but does not support Xilinx IP cores, waveforms, or the GUI.",
+)
+@click.option(
+    "--verilator-threads",
+    type=click.IntRange(min=1),
+    default=1,
+    help="Number of threads of the Verilator simulation.",
+)
+@click.option(
+    "--perf-counters-path",
+    type=str,
+    default=None,
+    help="Count cycles of the kernel and its top-level ports, and write the "
+    "counters to this path as JSON when the kernel finishes.",
+)
+def main(  # noqa: PLR0913, PLR0917, PLR0914
     config_path: str,
     tb_output_dir: str,
     part_num: str | None,
     launch_simulation: bool,
     save_waveform: bool,
     start_gui: bool,
+    snapshot_cache_dir: str | None,
+    simulator: str,
+    verilator_threads: int,
+    perf_counters_path: str | None,
 ) -> None:
     """Main entry point for the TAPA fast cosim tool."""
     _logger.info("TAPA fast cosim version: %s", __version__)
@@ -174,6 +248,16 @@ def main(  # noqa: PLR0913, PLR0917
     _logger.debug("   Launch simulation: %s", launch_simulation)
     _logger.debug("   Save waveform: %s", save_waveform)
     _logger.debug("   Start GUI: %s", start_gui)
+    _logger.debug("   Snapshot cache: %s", snapshot_cache_dir)
+    _logger.debug("   Simulator: %s", simulator)
+    _logger.debug("   Performance counters: %s", perf_counters_path)
+
+    if simulator == "verilator" and start_gui:
+        msg = "--start-gui is not supported with Verilator"
+        raise click.UsageError(msg)
+    if simulator == "verilator" and save_waveform:
+        _logger.warning("waveform is not supported with Verilator, ignored")
+        save_waveform = False
 
     config = preprocess_config(config_path, tb_output_dir, part_num)
 
@@ -185,6 +269,19 @@ def main(  # noqa: PLR0913, PLR0917
     # add default nettype to all rtl
     set_default_nettype(verilog_path)
 
+    # A cached snapshot must not depend on the inputs, so the testbench reads
+    # scalars and data bindings from plusargs at run time instead.
+    use_snapshot_cache = snapshot_cache_dir is not None and launch_simulation
+    if use_snapshot_cache and (save_waveform or start_gui):
+        _logger.warning("snapshot cache is disabled with waveform or GUI")
+        use_snapshot_cache = False
+
+    if perf_counters_path is not None:
+        perf_counters_path = os.path.abspath(perf_counters_path)
+        config["perf_counters_path"] = perf_counters_path
+        if use_snapshot_cache:
+            perf_counters_path = ""
+
     axi_list = parse_m_axi_interfaces(top_path)
     tb = get_cosim_tb(
         top_name,
@@ -192,25 +289,66 @@ def main(  # noqa: PLR0913, PLR0917
         ctrl_path,
         axi_list,
         config["args"],
-        config["scalar_to_val"],
+        {} if use_snapshot_cache else config["scalar_to_val"],
         config["mode"],
+        config.get("stream_batch_size", DEFAULT_STREAM_BATCH_SIZE),
+        perf_counters_path,
+        config.get("rtl_perf_counters"),
+        config["axi_to_host_buffer"].keys(),
     )
+    tb_sources = {
+        "tb.sv": tb,
+        "fifo_srl_tb.v": get_srl_fifo_template(),
+    }
 
     # generate test bench RTL files
     Path(tb_output_dir).mkdir(parents=True, exist_ok=True)
     for bin_file in Path(tb_output_dir).glob("*.bin"):
         bin_file.unlink()
-    with open(f"{tb_output_dir}/tb.sv", "w", encoding="utf-8") as fp:
-        fp.write(tb)
-    with open(f"{tb_output_dir}/fifo_srl_tb.v", "w", encoding="utf-8") as fp:
-        fp.write(get_srl_fifo_template())
+    for ram_file in Path(tb_output_dir).glob("axi_ram_*.*v"):
+        ram_file.unlink()
 
     for axi in axi_list:
-        source_data_path = config["axi_to_data_file"][axi.name]
         c_array_size = config["axi_to_c_array_size"][axi.name]
-        ram_module = get_axi_ram_module(axi, source_data_path, c_array_size)
-        with open(f"{tb_output_dir}/axi_ram_{axi.name}.v", "w", encoding="utf-8") as fp:
-            fp.write(ram_module)
+        memory_model = get_memory_model(config, axi.name)
+        host_buffer = config["axi_to_host_buffer"].get(axi.name)
+        if host_buffer:
+            # The buffer is accessed in place in host memory through DPI.
+            if use_snapshot_cache:
+                host_buffer = ""
+            ram_module = get_axi_ram_module(
+                axi, "", c_array_size, host_buffer, memory_model
+            )
+            tb_sources[f"axi_ram_{axi.name}.sv"] = ram_module
+        else:
+            source_data_path = config["axi_to_data_file"][axi.name]
+            if use_snapshot_cache:
+                source_data_path = ""
+            ram_module = get_axi_ram_module(
+                axi, source_data_path, c_array_size, memory_model=memory_model
+            )
+            tb_sources[f"axi_ram_{axi.name}.v"] = ram_module
+
+    for name, content in tb_sources.items():
+        with open(f"{tb_output_dir}/{name}", "w", encoding="utf-8") as fp:
+            fp.write(content)
+
+    if use_snapshot_cache:
+        assert snapshot_cache_dir is not None
+        _run_with_snapshot_cache(
+            config,
+            snapshot_cache_dir,
+            tb_sources,
+            tb_output_dir,
+            simulator,
+            verilator_threads,
+        )
+        return
+
+    if simulator == "verilator":
+        if launch_simulation:
+            _run_verilator(config, tb_output_dir, verilator_threads)
+        return
 
     # generate vivado script
     Path(f"{tb_output_dir}/run").mkdir(parents=True, exist_ok=True)
@@ -244,6 +382,129 @@ def main(  # noqa: PLR0913, PLR0917
             _launch_simulation(config, start_gui, tb_output_dir, stdout_fp, stderr_fp)
 
 
+def _run_verilator(config: dict, tb_output_dir: str, threads: int) -> None:
+    """Builds and runs the Verilator simulation in the output directory."""
+    run_dir = Path(f"{tb_output_dir}/run")
+    run_dir.mkdir(parents=True, exist_ok=True)
+    build_dir = (run_dir / "verilator").as_posix()
+    with (
+        open(f"{tb_output_dir}/cosim.stdout.log", "w", encoding="utf-8") as stdout_fp,
+        open(f"{tb_output_dir}/cosim.stderr.log", "w", encoding="utf-8") as stderr_fp,
+    ):
+        command = get_verilator_command(config, tb_output_dir, build_dir, threads)
+        _run_command(config, command, run_dir, run_dir, stdout_fp, stderr_fp)
+        copy_memory_init_files(config, run_dir.as_posix())
+        command = [get_verilator_binary(build_dir)]
+        _run_command(config, command, run_dir, run_dir, stdout_fp, stderr_fp)
+
+
+def _run_with_snapshot_cache(  # noqa: PLR0913, PLR0917
+    config: dict,
+    snapshot_cache_dir: str,
+    tb_sources: dict[str, str],
+    tb_output_dir: str,
+    simulator: str,
+    verilator_threads: int,
+) -> None:
+    """Simulates with a cached snapshot, building the snapshot if missing."""
+    key = get_snapshot_key(
+        config["xo_path"],
+        config["part_num"] or "",
+        tb_sources,
+        (simulator, str(verilator_threads) if simulator == "verilator" else ""),
+    )
+    run_dir = Path(f"{tb_output_dir}/run")
+    run_dir.mkdir(parents=True, exist_ok=True)
+    with (
+        open(f"{tb_output_dir}/cosim.stdout.log", "w", encoding="utf-8") as stdout_fp,
+        open(f"{tb_output_dir}/cosim.stderr.log", "w", encoding="utf-8") as stderr_fp,
+    ):
+        with locked_snapshot_dir(snapshot_cache_dir, key) as (snapshot_dir, ready):
+            if not ready:
+                rtl_dir, tb_dir = _copy_snapshot_sources(
+                    config, snapshot_dir, tb_sources
+                )
+                if simulator == "verilator":
+                    command = get_verilator_command(
+                        config | {"verilog_path": rtl_dir.as_posix()},
+                        tb_dir.as_posix(),
+                        (snapshot_dir / "verilator").as_posix(),
+                        verilator_threads,
+                    )
+                    _run_command(
+                        config, command, snapshot_dir, run_dir, stdout_fp, stderr_fp
+                    )
+                else:
+                    _build_snapshot(
+                        config, snapshot_dir, rtl_dir, tb_dir, stdout_fp, stderr_fp
+                    )
+                mark_ready(snapshot_dir)
+
+        # Runs share the snapshot but not the working directory.
+        if simulator == "verilator":
+            copy_memory_init_files(config, run_dir.as_posix())
+            binary = get_verilator_binary((snapshot_dir / "verilator").as_posix())
+            command = [binary, *(f"+{x}" for x in get_plusargs(config))]
+            _run_command(config, command, run_dir, run_dir, stdout_fp, stderr_fp)
+            return
+
+        sim_dir = _get_snapshot_sim_dir(snapshot_dir)
+        link_snapshot(sim_dir / "xsim.dir", run_dir / "xsim.dir")
+
+        command = ["xsim", "test_behav", "-R"]
+        for plusarg in get_plusargs(config):
+            command += ["-testplusarg", plusarg]
+        _run_command(config, command, run_dir, run_dir, stdout_fp, stderr_fp)
+
+
+def _get_snapshot_sim_dir(snapshot_dir: Path) -> Path:
+    return snapshot_dir / "run/vivado/tapa-fast-cosim.sim/sim_1/behav/xsim"
+
+
+def _copy_snapshot_sources(
+    config: dict, snapshot_dir: Path, tb_sources: dict[str, str]
+) -> tuple[Path, Path]:
+    """Copies the RTL and testbench sources into `snapshot_dir`.
+
+    The snapshot outlives the output directory, so it keeps its own sources.
+    Returns the RTL and testbench directories.
+    """
+    rtl_dir = snapshot_dir / "rtl"
+    shutil.copytree(config["verilog_path"], rtl_dir)
+    tb_dir = snapshot_dir / "tb"
+    tb_dir.mkdir()
+    for name, content in tb_sources.items():
+        (tb_dir / name).write_text(content, encoding="utf-8")
+    return rtl_dir, tb_dir
+
+
+def _build_snapshot(  # noqa: PLR0913, PLR0917
+    config: dict,
+    snapshot_dir: Path,
+    rtl_dir: Path,
+    tb_dir: Path,
+    stdout_fp: TextIOWrapper,
+    stderr_fp: TextIOWrapper,
+) -> None:
+    """Compiles and elaborates the xsim snapshot into `snapshot_dir`."""
+    home = snapshot_dir / "run"
+    vivado_script = get_vivado_tcl(
+        config | {"verilog_path": rtl_dir.as_posix()},
+        tb_dir.as_posix(),
+        save_waveform=False,
+        start_gui=False,
+        scripts_only=True,
+    )
+    home.mkdir()
+    (home / "run_cosim.tcl").write_text("\n".join(vivado_script), encoding="utf-8")
+    command = ["vivado", "-mode", "batch", "-source", "run_cosim.tcl"]
+    _run_command(config, command, home, home, stdout_fp, stderr_fp)
+
+    sim_dir = _get_snapshot_sim_dir(snapshot_dir)
+    for script in ("compile.sh", "elaborate.sh"):
+        _run_command(config, ["bash", script], sim_dir, home, stdout_fp, stderr_fp)
+
+
 def _launch_simulation(
     config: dict,
     start_gui: bool,
@@ -253,22 +514,33 @@ def _launch_simulation(
 ) -> None:
     mode = "gui" if start_gui else "batch"
     command = ["vivado", "-mode", mode, "-source", "run_cosim.tcl"]
+    run_dir = Path(f"{tb_output_dir}/run")
+    _run_command(config, command, run_dir, run_dir, stdout_fp, stderr_fp)
 
-    _logger.info("Starting Vivado:")
+
+def _run_command(  # noqa: PLR0913, PLR0917
+    config: dict,
+    command: list[str],
+    cwd: Path,
+    home: Path,
+    stdout_fp: TextIOWrapper,
+    stderr_fp: TextIOWrapper,
+) -> None:
+    _logger.info("Starting %s:", command[0])
     _logger.info("   Command: %s", " ".join(command))
-    _logger.info("   Working directory: %s/run", tb_output_dir)
-    _logger.info("   Stdout: %s/cosim.stdout.log", tb_output_dir)
-    _logger.info("   Stderr: %s/cosim.stderr.log", tb_output_dir)
+    _logger.info("   Working directory: %s", cwd)
+    _logger.info("   Stdout: %s", stdout_fp.name)
+    _logger.info("   Stderr: %s", stderr_fp.name)
 
     with subprocess.Popen(
         command,
-        cwd=Path(f"{tb_output_dir}/run").resolve(),
+        cwd=cwd.resolve(),
         env=os.environ
         | {
             # Vivado generates garbage files in the user home directory.
             # We ask Vivado to dump garbages to the current directory instead
             # of the user home to avoid collisions.
-            "HOME": Path(f"{tb_output_dir}/run").resolve().as_posix(),
+            "HOME": home.resolve().as_posix(),
             "TAPA_FAST_COSIM_DPI_ARGS": ",".join(
                 f"{k}:{v}" for k, v in config["axis_to_data_file"].items()
             ),
@@ -292,11 +564,11 @@ def _launch_simulation(
         process.wait()
         if process.returncode != 0:
             _logger.error(
-                "Vivado simulation failed with error code %d", process.returncode
+                "%s failed with error code %d", command[0], process.returncode
             )
             sys.exit(process.returncode)
         else:
-            _logger.info("Vivado simulation finished successfully")
+            _logger.info("%s finished successfully", command[0])
 
 
 if __name__ == "__main__":
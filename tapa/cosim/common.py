@@ -78,3 +78,14 @@ class Arg(NamedTuple):
 
 
 MAX_AXI_BRAM_ADDR_WIDTH = 32
+
+
+def get_output_data_path(input_data_path: str) -> str:
+    """Returns the path the AXI RAM dumps the data loaded from a path to."""
+    return input_data_path.replace(".bin", "_out.bin")
+
+
+# Maximum number of tokens the testbench exchanges with a host stream per DPI
+# call, unless the config says otherwise. Keep in sync with the default of
+# `--xosim_stream_batch_size` in the fast cosim device.
+DEFAULT_STREAM_BATCH_SIZE = 16
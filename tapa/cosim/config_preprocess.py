@@ -117,10 +117,11 @@ def _parse_and_update_config(config: dict, tb_output_dir: str) -> None:
     for entry in (
         "scalar_to_val",
         "axi_to_data_file",
+        "axi_to_host_buffer",
         "axis_to_data_file",
         "axi_to_c_array_size",
     ):
-        config[entry] = change_id_to_name(config[entry] or {})
+        config[entry] = change_id_to_name(config.get(entry) or {})
 
 
 def _parse_xo_update_config(config: dict, tmp_path: str) -> None:
@@ -169,6 +170,12 @@ def _parse_xo_update_config(config: dict, tmp_path: str) -> None:
 
     config["part_num"] = parse_part_num(tmp_path)
 
+    # counters instantiated by `tapa synth --enable-perf-counters`
+    report_path = Path(tmp_path) / "report.json"
+    if report_path.is_file():
+        with report_path.open(encoding="utf-8") as f:
+            config["rtl_perf_counters"] = json.load(f).get("perf_counters")
+
 
 def _parse_zip_update_config(config: dict, tmp_path: str) -> None:
     """Parse the zip file and update the config file with the extracted information.
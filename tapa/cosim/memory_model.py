@@ -0,0 +1,130 @@
+"""Timing models of the memory behind the cosim AXI RAMs."""
+
+__copyright__ = """
+Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+from dataclasses import dataclass, fields, replace
+
+
+@dataclass(frozen=True)
+class Latency:
+    """Latency in cycles, uniformly distributed in [min, max]."""
+
+    min: int
+    max: int
+
+    @classmethod
+    def parse(cls, spec: int | dict) -> "Latency":
+        """Parses a fixed latency or a `{"min": ..., "max": ...}` range."""
+        if isinstance(spec, int):
+            latency = cls(spec, spec)
+        else:
+            latency = cls(int(spec["min"]), int(spec["max"]))
+        if not 0 <= latency.min <= latency.max:
+            msg = f"invalid latency: {spec}"
+            raise ValueError(msg)
+        return latency
+
+
+@dataclass(frozen=True)
+class MemoryModel:
+    """Timing of one memory channel, in kernel clock cycles.
+
+    Reads are answered `read_latency` cycles after the address is accepted,
+    with up to `max_outstanding_reads` bursts in flight. Write responses are
+    returned `write_latency` cycles after the last beat, with up to
+    `max_outstanding_writes` responses pending. If `banks` is nonzero, bursts
+    to a bank wait until the previous burst to the same bank finishes, and
+    bursts that miss the open row of `row_bytes` bytes pay `row_miss_penalty`
+    more cycles. If `bytes_per_cycle` is nonzero, read and write beats share
+    that bandwidth.
+    """
+
+    read_latency: Latency = Latency(0, 0)
+    write_latency: Latency = Latency(0, 0)
+    max_outstanding_reads: int = 1
+    max_outstanding_writes: int = 1
+    banks: int = 0
+    row_bytes: int = 1024
+    row_miss_penalty: int = 0
+    bytes_per_cycle: float = 0
+
+
+# Approximate channels at a 300 MHz kernel clock.
+PRESETS = {
+    # A DDR4-2400 channel with 16 banks of 8 KiB rows; 19.2 GB/s.
+    "ddr4": MemoryModel(
+        read_latency=Latency(35, 70),
+        write_latency=Latency(20, 20),
+        max_outstanding_reads=32,
+        max_outstanding_writes=32,
+        banks=16,
+        row_bytes=8192,
+        row_miss_penalty=14,
+        bytes_per_cycle=64,
+    ),
+    # An HBM2 pseudo channel with 16 banks of 1 KiB rows; 14.4 GB/s.
+    "hbm": MemoryModel(
+        read_latency=Latency(40, 90),
+        write_latency=Latency(24, 24),
+        max_outstanding_reads=64,
+        max_outstanding_writes=64,
+        banks=16,
+        row_bytes=1024,
+        row_miss_penalty=12,
+        bytes_per_cycle=48,
+    ),
+}
+
+
+def parse_memory_model(spec: str | dict) -> MemoryModel:
+    """Parses a preset name, or an object of `MemoryModel` fields.
+
+    The object may name a `preset` whose fields it overrides.
+    """
+    if isinstance(spec, str):
+        spec = {"preset": spec}
+    spec = dict(spec)
+
+    preset = spec.pop("preset", None)
+    if preset is None:
+        model = MemoryModel()
+    elif preset in PRESETS:
+        model = PRESETS[preset]
+    else:
+        msg = f"unknown memory model preset `{preset}`, expect one of {[*PRESETS]}"
+        raise ValueError(msg)
+
+    known_fields = {field.name for field in fields(MemoryModel)}
+    if unknown_fields := spec.keys() - known_fields:
+        msg = f"unknown memory model fields: {sorted(unknown_fields)}"
+        raise ValueError(msg)
+    for name in ("read_latency", "write_latency"):
+        if name in spec:
+            spec[name] = Latency.parse(spec[name])
+    model = replace(model, **spec)
+
+    if model.max_outstanding_reads < 1 or model.max_outstanding_writes < 1:
+        msg = "memory models need at least 1 outstanding read and write"
+        raise ValueError(msg)
+    if model.banks < 0 or model.row_bytes < 1 or model.bytes_per_cycle < 0:
+        msg = f"invalid memory model: {model}"
+        raise ValueError(msg)
+    return model
+
+
+def get_memory_model(config: dict, axi_name: str) -> MemoryModel | None:
+    """Returns the memory model of AXI interface `axi_name`, if any.
+
+    `axi_to_memory_model` in `config` maps interface names to memory models;
+    `*` applies to interfaces that are not listed. Interfaces without a memory
+    model respond with idealized timing.
+    """
+    models = config.get("axi_to_memory_model") or {}
+    spec = models.get(axi_name, models.get("*"))
+    if spec is None:
+        return None
+    return parse_memory_model(spec)
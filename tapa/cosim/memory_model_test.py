@@ -0,0 +1,81 @@
+"""Unit tests for tapa.cosim.memory_model."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import pytest
+
+from tapa.cosim.memory_model import (
+    PRESETS,
+    Latency,
+    MemoryModel,
+    get_memory_model,
+    parse_memory_model,
+)
+
+
+def test_latency_parse() -> None:
+    assert Latency.parse(0) == Latency(0, 0)
+    assert Latency.parse(20) == Latency(20, 20)
+    assert Latency.parse({"min": 40, "max": 120}) == Latency(40, 120)
+    assert Latency.parse({"min": "5", "max": "5"}) == Latency(5, 5)
+
+
+@pytest.mark.parametrize("spec", [-1, {"min": -1, "max": 5}, {"min": 6, "max": 5}])
+def test_latency_parse_rejects_invalid(spec: int | dict) -> None:
+    with pytest.raises(ValueError, match="invalid latency"):
+        Latency.parse(spec)
+
+
+def test_parse_preset() -> None:
+    assert parse_memory_model("ddr4") == PRESETS["ddr4"]
+    assert parse_memory_model({"preset": "hbm"}) == PRESETS["hbm"]
+
+
+def test_parse_overrides_preset() -> None:
+    model = parse_memory_model(
+        {"preset": "ddr4", "read_latency": {"min": 40, "max": 120}, "banks": 4}
+    )
+    assert model.read_latency == Latency(40, 120)
+    assert model.banks == 4
+    assert model.write_latency == PRESETS["ddr4"].write_latency
+    assert model.row_bytes == PRESETS["ddr4"].row_bytes
+
+
+def test_parse_without_preset_uses_defaults() -> None:
+    assert parse_memory_model({}) == MemoryModel()
+    assert parse_memory_model({"write_latency": 20}) == MemoryModel(
+        write_latency=Latency(20, 20)
+    )
+
+
+@pytest.mark.parametrize(
+    ("spec", "match"),
+    [
+        ("ddr5", "unknown memory model preset"),
+        ({"latency": 3}, "unknown memory model fields"),
+        ({"max_outstanding_reads": 0}, "at least 1 outstanding"),
+        ({"max_outstanding_writes": 0}, "at least 1 outstanding"),
+        ({"banks": -1}, "invalid memory model"),
+        ({"row_bytes": 0}, "invalid memory model"),
+        ({"bytes_per_cycle": -1}, "invalid memory model"),
+        ({"read_latency": -3}, "invalid latency"),
+    ],
+)
+def test_parse_rejects_invalid(spec: str | dict, match: str) -> None:
+    with pytest.raises(ValueError, match=match):
+        parse_memory_model(spec)
+
+
+def test_get_memory_model() -> None:
+    config = {"axi_to_memory_model": {"*": "hbm", "edges": {"preset": "ddr4"}}}
+    assert get_memory_model(config, "edges") == PRESETS["ddr4"]
+    assert get_memory_model(config, "nodes") == PRESETS["hbm"]
+
+    config = {"axi_to_memory_model": {"edges": "ddr4"}}
+    assert get_memory_model(config, "nodes") is None
+    assert get_memory_model({}, "edges") is None
+    assert get_memory_model({"axi_to_memory_model": None}, "edges") is None
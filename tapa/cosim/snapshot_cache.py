@@ -0,0 +1,131 @@
+"""Cache of compiled simulation snapshots shared by cosim runs."""
+
+__copyright__ = """
+Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import fcntl
+import fnmatch
+import hashlib
+import logging
+import os
+import shutil
+from collections.abc import Iterator, Sequence
+from contextlib import contextmanager
+from pathlib import Path
+
+from tapa import __version__
+from tapa.cosim.common import get_output_data_path
+
+_logger = logging.getLogger().getChild(__name__)
+
+_READY_STAMP = "snapshot.ready"
+
+# Files and directories that the simulator writes in the snapshot directory when
+# it runs, which each run must have its own copies of.
+_RUN_OUTPUTS = ("*.log", "*.pb", "*.wdb", "webtalk")
+
+
+def get_snapshot_key(
+    xo_path: str,
+    part_num: str,
+    sources: dict[str, str],
+    simulator_options: Sequence[str] = (),
+) -> str:
+    """Returns the cache key of a snapshot.
+
+    The key covers everything compiled into the snapshot: the kernel, the part
+    number, the simulator and its `simulator_options`, and the generated
+    testbench `sources`. The testbench must read scalars and data bindings from
+    plusargs so that they do not change the key.
+    """
+    digest = hashlib.sha256()
+    vivado = os.environ.get("XILINX_VIVADO", "")
+    for field in (__version__, part_num, vivado, *simulator_options):
+        digest.update(field.encode())
+        digest.update(b"\0")
+    with open(xo_path, "rb") as fp:
+        for chunk in iter(lambda: fp.read(1 << 20), b""):
+            digest.update(chunk)
+    for name, content in sorted(sources.items()):
+        digest.update(f"\0{name}\0{len(content)}\0".encode())
+        digest.update(content.encode())
+    return digest.hexdigest()
+
+
+@contextmanager
+def locked_snapshot_dir(cache_dir: str, key: str) -> Iterator[tuple[Path, bool]]:
+    """Locks the snapshot directory of `key` and yields it.
+
+    Also yields whether the snapshot is ready to use. If not, the caller should
+    build it in the directory, which is emptied, and call `mark_ready`. Other
+    processes building the same snapshot wait for the lock.
+    """
+    Path(cache_dir).mkdir(parents=True, exist_ok=True)
+    snapshot_dir = Path(cache_dir) / key
+    with open(f"{snapshot_dir}.lock", "w", encoding="utf-8") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        try:
+            is_ready = (snapshot_dir / _READY_STAMP).is_file()
+            if is_ready:
+                _logger.info("reusing simulation snapshot in %s", snapshot_dir)
+            else:
+                _logger.info("building simulation snapshot in %s", snapshot_dir)
+                # Remove leftovers of an interrupted build.
+                shutil.rmtree(snapshot_dir, ignore_errors=True)
+                snapshot_dir.mkdir()
+            yield snapshot_dir, is_ready
+        finally:
+            fcntl.flock(lock, fcntl.LOCK_UN)
+
+
+def mark_ready(snapshot_dir: Path) -> None:
+    """Marks the snapshot in `snapshot_dir` as completely built.
+
+    Files of the snapshot become read-only so that runs cannot modify them.
+    """
+    for path in snapshot_dir.rglob("*"):
+        if path.is_file() and not path.is_symlink():
+            path.chmod(path.stat().st_mode & ~0o222)
+    (snapshot_dir / _READY_STAMP).touch()
+
+
+def link_snapshot(snapshot_dir: Path, work_dir: Path) -> None:
+    """Mirrors `snapshot_dir` in `work_dir` for a run.
+
+    Directories are created, and files are symlinked except those that the
+    simulator writes when it runs. The run thus writes only in `work_dir`.
+    """
+    shutil.rmtree(work_dir, ignore_errors=True)
+    for root, dirs, files in os.walk(snapshot_dir):
+        dirs[:] = [x for x in dirs if not _is_run_output(x)]
+        target_dir = work_dir / Path(root).relative_to(snapshot_dir)
+        target_dir.mkdir(parents=True, exist_ok=True)
+        for name in files:
+            if not _is_run_output(name):
+                (target_dir / name).symlink_to(Path(root) / name)
+
+
+def _is_run_output(name: str) -> bool:
+    return any(fnmatch.fnmatch(name, pattern) for pattern in _RUN_OUTPUTS)
+
+
+def get_plusargs(config: dict) -> list[str]:
+    """Returns the plusargs that bind scalars, data, and outputs of `config`."""
+    plusargs = [
+        f"TAPA_SCALAR_{name}={val.removeprefix(chr(39) + 'h')}"
+        for name, val in config["scalar_to_val"].items()
+    ]
+    host_buffers = config["axi_to_host_buffer"]
+    for name, buffer in host_buffers.items():
+        plusargs.append(f"TAPA_AXI_{name}_HOST_BUFFER={buffer}")
+    for name, path in config["axi_to_data_file"].items():
+        if name not in host_buffers:
+            plusargs.append(f"TAPA_AXI_{name}_DATA={path}")
+            output_path = get_output_data_path(path)
+            plusargs.append(f"TAPA_AXI_{name}_DATA_OUT={output_path}")
+    if perf_counters_path := config.get("perf_counters_path"):
+        plusargs.append(f"TAPA_PERF_COUNTERS={perf_counters_path}")
+    return plusargs
@@ -0,0 +1,116 @@
+"""Unit tests for tapa.cosim.snapshot_cache."""
+
+__copyright__ = """
+Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+from pathlib import Path
+
+import pytest
+
+from tapa.cosim.snapshot_cache import (
+    get_plusargs,
+    get_snapshot_key,
+    link_snapshot,
+    locked_snapshot_dir,
+    mark_ready,
+)
+
+
+@pytest.fixture
+def xo_path(tmp_path: Path) -> str:
+    path = tmp_path / "kernel.xo"
+    path.write_bytes(b"PK\3\4 kernel")
+    return path.as_posix()
+
+
+def test_snapshot_key_is_stable(xo_path: str) -> None:
+    sources = {"tb.sv": "module tb; endmodule", "fifo.v": "module fifo;"}
+    key = get_snapshot_key(xo_path, "part", sources, ("xsim",))
+    assert key == get_snapshot_key(
+        xo_path, "part", dict(reversed(sources.items())), ("xsim",)
+    )
+
+
+def test_snapshot_key_covers_inputs(xo_path: str, tmp_path: Path) -> None:
+    sources = {"tb.sv": "module tb; endmodule"}
+    key = get_snapshot_key(xo_path, "part", sources, ("xsim",))
+
+    other_xo = tmp_path / "other.xo"
+    other_xo.write_bytes(b"PK\3\4 other kernel")
+    assert key != get_snapshot_key(other_xo.as_posix(), "part", sources, ("xsim",))
+    assert key != get_snapshot_key(xo_path, "other", sources, ("xsim",))
+    assert key != get_snapshot_key(xo_path, "part", sources, ("verilator",))
+    assert key != get_snapshot_key(
+        xo_path, "part", {"tb.sv": "module tb; wire x; endmodule"}, ("xsim",)
+    )
+    # Moving content between sources changes the key.
+    assert get_snapshot_key(
+        xo_path, "part", {"a.v": "xy", "b.v": "z"}
+    ) != get_snapshot_key(xo_path, "part", {"a.v": "x", "b.v": "yz"})
+
+
+def test_snapshot_dir_is_rebuilt_until_ready(tmp_path: Path) -> None:
+    cache_dir = (tmp_path / "cache").as_posix()
+    with locked_snapshot_dir(cache_dir, "key") as (snapshot_dir, is_ready):
+        assert not is_ready
+        (snapshot_dir / "leftover").touch()
+
+    # Interrupted builds are cleaned up.
+    with locked_snapshot_dir(cache_dir, "key") as (snapshot_dir, is_ready):
+        assert not is_ready
+        assert not (snapshot_dir / "leftover").exists()
+        (snapshot_dir / "xsimk").write_text("snapshot")
+        mark_ready(snapshot_dir)
+
+    with locked_snapshot_dir(cache_dir, "key") as (snapshot_dir, is_ready):
+        assert is_ready
+        assert (snapshot_dir / "xsimk").read_text() == "snapshot"
+        assert not (snapshot_dir / "xsimk").stat().st_mode & 0o222
+
+
+def test_link_snapshot_isolates_runs(tmp_path: Path) -> None:
+    snapshot_dir = tmp_path / "snapshot"
+    (snapshot_dir / "test_behav" / "webtalk").mkdir(parents=True)
+    (snapshot_dir / "test_behav" / "xsimk").write_text("binary")
+    (snapshot_dir / "test_behav" / "xsimkernel.log").write_text("build log")
+    (snapshot_dir / "test_behav" / "webtalk" / "usage.xml").write_text("usage")
+    mark_ready(snapshot_dir)
+
+    for run in ("run0", "run1"):
+        work_dir = tmp_path / run / "xsim.dir"
+        link_snapshot(snapshot_dir, work_dir)
+        assert not work_dir.is_symlink()
+        assert not (work_dir / "test_behav").is_symlink()
+        assert (work_dir / "test_behav" / "xsimk").is_symlink()
+        assert (work_dir / "test_behav" / "xsimk").read_text() == "binary"
+        # Each run writes its own logs.
+        assert not (work_dir / "test_behav" / "xsimkernel.log").exists()
+        assert not (work_dir / "test_behav" / "webtalk").exists()
+        (work_dir / "test_behav" / "xsimkernel.log").write_text(run)
+
+    build_log = snapshot_dir / "test_behav" / "xsimkernel.log"
+    assert build_log.read_text() == "build log"
+
+    # Linking again replaces the previous run.
+    work_dir = tmp_path / "run0" / "xsim.dir"
+    link_snapshot(snapshot_dir, work_dir)
+    assert not (work_dir / "test_behav" / "xsimkernel.log").exists()
+
+
+def test_plusargs_bind_data_and_host_buffers() -> None:
+    config = {
+        "scalar_to_val": {"n": "'h10"},
+        "axi_to_data_file": {"a": "/work/0.bin", "b": "/work/1.bin"},
+        "axi_to_host_buffer": {"b": "123:4096:64:rw"},
+        "perf_counters_path": "/work/perf.json",
+    }
+    assert get_plusargs(config) == [
+        "TAPA_SCALAR_n=10",
+        "TAPA_AXI_b_HOST_BUFFER=123:4096:64:rw",
+        "TAPA_AXI_a_DATA=/work/0.bin",
+        "TAPA_AXI_a_DATA_OUT=/work/0_out.bin",
+        "TAPA_PERF_COUNTERS=/work/perf.json",
+    ]
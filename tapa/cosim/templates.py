@@ -9,16 +9,26 @@ import os
 import sys
 from collections.abc import Sequence
 
-from tapa.cosim.common import AXI, MAX_AXI_BRAM_ADDR_WIDTH, Arg
+from tapa.cosim.common import (
+    AXI,
+    DEFAULT_STREAM_BATCH_SIZE,
+    MAX_AXI_BRAM_ADDR_WIDTH,
+    Arg,
+    get_output_data_path,
+)
+from tapa.cosim.memory_model import Latency, MemoryModel
 
 _logger = logging.getLogger().getChild(__name__)
 
+# Number of cycles an empty input or a stalled output waits at most before
+# the testbench polls the host stream again.
+_MAX_STREAM_POLL_INTERVAL = 64
+
 
-def get_axi_ram_inst(axi_obj: AXI) -> str:
-    # FIXME: test if using addr_width = 64 will cause problem in simulation
+def get_axi_ram_inst(axi_obj: AXI, addr_width: int = MAX_AXI_BRAM_ADDR_WIDTH) -> str:
     return f"""
   parameter AXI_RAM_{axi_obj.name.upper()}_DATA_WIDTH = {axi_obj.data_width};
-  parameter AXI_RAM_{axi_obj.name.upper()}_ADDR_WIDTH = {MAX_AXI_BRAM_ADDR_WIDTH};
+  parameter AXI_RAM_{axi_obj.name.upper()}_ADDR_WIDTH = {addr_width};
   parameter AXI_RAM_{axi_obj.name.upper()}_STRB_WIDTH =
       AXI_RAM_{axi_obj.name.upper()}_DATA_WIDTH/8;
   parameter AXI_RAM_{axi_obj.name.upper()}_ID_WIDTH = 8;
@@ -136,7 +146,7 @@ def get_s_axi_control() -> str:
   wire [C_S_AXI_CONTROL_WSTRB_WIDTH-1:0]  s_axi_control_wstrb;
   reg                                     s_axi_control_arvalid = 0;
   wire                                    s_axi_control_arready;
-  wire [C_S_AXI_CONTROL_ADDR_WIDTH-1:0]   s_axi_control_araddr;
+  reg  [C_S_AXI_CONTROL_ADDR_WIDTH-1:0]   s_axi_control_araddr = 0;
   wire                                    s_axi_control_rvalid;
   wire                                    s_axi_control_rready;
   wire [C_S_AXI_CONTROL_DATA_WIDTH-1:0]   s_axi_control_rdata;
@@ -212,13 +222,10 @@ def get_axis(args: Sequence[Arg]) -> str:
   logic axis_{arg.name}_tlast;
 
   // data ports connected to testbench
-  unpacked_uint{arg.port.data_width + 1}_t axis_{arg.name}_tdata_unpacked;
-  unpacked_uint{arg.port.data_width + 1}_t axis_{arg.name}_tdata_unpacked_next;
+  packed_uint{arg.port.data_width + 1}_t axis_{arg.name}_token;
 
-  logic axis_{arg.name}_tvalid = 0;
-  logic axis_{arg.name}_tready = 0;
-  logic axis_{arg.name}_tvalid_next = 0;
-  logic axis_{arg.name}_tready_next = 0;
+  logic axis_{arg.name}_tvalid;
+  logic axis_{arg.name}_tready;
 """
         )
     return "\n".join(lines)
@@ -230,17 +237,11 @@ def get_fifo(args: Sequence[Arg]) -> str:
     for arg in fifo_args:
         lines.append(
             f"""
-  // data ports connected to DUT
+  // data ports connected to DUT and testbench
   packed_uint{arg.port.data_width + 1}_t fifo_{arg.qualified_name}_data;
 
-  // data ports connected to testbench
-  unpacked_uint{arg.port.data_width + 1}_t fifo_{arg.qualified_name}_data_unpacked;
-  unpacked_uint{arg.port.data_width + 1}_t fifo_{arg.qualified_name}_data_unpacked_next;
-
-  logic fifo_{arg.qualified_name}_valid = 0;
-  logic fifo_{arg.qualified_name}_ready = 0;
-  logic fifo_{arg.qualified_name}_valid_next = 0;
-  logic fifo_{arg.qualified_name}_ready_next = 0;
+  logic fifo_{arg.qualified_name}_valid;
+  logic fifo_{arg.qualified_name}_ready;
 """
         )
     return "\n".join(lines)
@@ -263,7 +264,6 @@ def get_stream_typedef(args: Sequence[Arg]) -> str:
     for width in widths:
         lines.append(
             f"""
-  typedef logic unpacked_uint{width}_t[{width - 1}:0];
   typedef logic [{width - 1}:0] packed_uint{width}_t;
 """
         )
@@ -328,7 +328,7 @@ def get_vitis_dut(top_name: str, args: Sequence[Arg]) -> str:
     // keep polling the control registers
     .s_axi_control_ARVALID (s_axi_control_arvalid),
     .s_axi_control_ARREADY (s_axi_control_arready),
-    .s_axi_control_ARADDR  ('h00 ),
+    .s_axi_control_ARADDR  (s_axi_control_araddr ),
 
     .s_axi_control_RVALID  (s_axi_control_rvalid ),
     .s_axi_control_RREADY  (1 ),
@@ -361,19 +361,41 @@ def get_vitis_dut(top_name: str, args: Sequence[Arg]) -> str:
     return dut
 
 
+def get_scalar_regs(names: Sequence[str], scalar_to_val: dict[str, str]) -> str:
+    """Declares a register for each scalar set by a plusarg at run time.
+
+    `+TAPA_SCALAR_<name>=<hex>` overrides the value in `scalar_to_val`, so a
+    compiled testbench can be reused with different scalars.
+    """
+    regs = ""
+    for name in names:
+        regs += f"""
+  reg [63:0] scalar_{name};
+  initial begin
+    if (!$value$plusargs("TAPA_SCALAR_{name}=%h", scalar_{name})) begin
+      scalar_{name} = {scalar_to_val.get(name, 0)};
+    end
+  end
+"""
+    return regs
+
+
 def get_hls_dut(
     top_name: str,
     top_is_leaf_task: bool,
     args: Sequence[Arg],
     scalar_to_val: dict[str, str],
 ) -> str:
-    dut = f"\n  {top_name} dut (\n"
+    dut = get_scalar_regs(
+        [arg.name for arg in args if arg.is_mmap or arg.is_scalar], scalar_to_val
+    )
+    dut += f"\n  {top_name} dut (\n"
 
     for arg in args:
         if arg.is_mmap:
             dut += get_m_axi_connections(arg.name)
             dut += f"""
-    .{arg.name}_offset({scalar_to_val.get(arg.name, 0)}),\n
+    .{arg.name}_offset(scalar_{arg.name}),\n
 """
 
         if arg.is_stream and arg.port.is_istream:
@@ -397,7 +419,7 @@ def get_hls_dut(
 
         if arg.is_scalar:
             dut += f"""
-    .{arg.name}({scalar_to_val.get(arg.name, 0)}),\n
+    .{arg.name}(scalar_{arg.name}),\n
 """
 
     dut += """
@@ -413,61 +435,91 @@ def get_hls_dut(
     return dut
 
 
+def get_dpi_stream_inst(  # noqa: PLR0913,PLR0917
+    arg: Arg,
+    inst_name: str,
+    token: str,
+    valid: str,
+    ready: str,
+    batch_size: int,
+) -> str:
+    """Instantiates the testbench buffer that connects `arg` to the host stream.
+
+    The buffer exchanges up to `batch_size` tokens with the host per DPI call.
+    """
+    if arg.port.is_istream:
+        module, data_port, valid_port, ready_port = (
+            "tapa_dpi_istream",
+            "dout",
+            "empty_n",
+            "read",
+        )
+    elif arg.port.is_ostream:
+        module, data_port, valid_port, ready_port = (
+            "tapa_dpi_ostream",
+            "din",
+            "write",
+            "full_n",
+        )
+    else:
+        msg = f"unexpected arg.port.mode: {arg.port.mode}"
+        raise ValueError(msg)
+    return f"""
+  {module} #(
+    .ID("{arg.qualified_name}"),
+    .WIDTH({arg.port.data_width + 1}),
+    .DEPTH({batch_size}),
+    .MAX_POLL_INTERVAL({_MAX_STREAM_POLL_INTERVAL})
+  ) {inst_name} (
+    .clk(ap_clk),
+    .enable(kernel_started),
+    .{data_port}({token}),
+    .{valid_port}({valid}),
+    .{ready_port}({ready})
+  );
+"""
+
+
 def get_vitis_test_signals(
     arg_to_reg_addrs: dict[str, list[str]],
     scalar_arg_to_val: dict[str, str],
     args: Sequence[Arg],
+    stream_batch_size: int = DEFAULT_STREAM_BATCH_SIZE,
+    perf_counters: bool = False,
 ) -> str:
-    axis_dpi_calls = []
+    axis_instances = []
     axis_assignments = []
     for arg in args:
         if not arg.is_stream:
             continue
-        if arg.port.is_istream:
-            axis_dpi_calls.append(
-                f"""
-    tapa::istream(
-        axis_{arg.name}_tdata_unpacked_next,
-        axis_{arg.name}_tvalid_next,
-        axis_{arg.name}_tready,
-        "{arg.qualified_name}"
-    );
-
-    axis_{arg.name}_tdata_unpacked <= axis_{arg.name}_tdata_unpacked_next;
-    axis_{arg.name}_tvalid <= axis_{arg.name}_tvalid_next;
-"""
+        axis_instances.append(
+            get_dpi_stream_inst(
+                arg,
+                f"axis_{arg.name}_dpi",
+                f"axis_{arg.name}_token",
+                f"axis_{arg.name}_tvalid",
+                f"axis_{arg.name}_tready",
+                stream_batch_size,
             )
+        )
+        if arg.port.is_istream:
             axis_assignments.append(
                 f"""
     assign {{axis_{arg.name}_tlast, axis_{arg.name}_tdata}} =
-        packed_uint{arg.port.data_width + 1}_t'(axis_{arg.name}_tdata_unpacked);
-"""
-            )
-        elif arg.port.is_ostream:
-            axis_dpi_calls.append(
-                f"""
-    tapa::ostream(
-        axis_{arg.name}_tdata_unpacked,
-        axis_{arg.name}_tready_next,
-        axis_{arg.name}_tvalid,
-        "{arg.qualified_name}"
-    );
-
-    axis_{arg.name}_tready <= axis_{arg.name}_tready_next;
+        axis_{arg.name}_token;
 """
             )
+        else:
             axis_assignments.append(
                 f"""
-    assign axis_{arg.name}_tdata_unpacked =
-        unpacked_uint{arg.port.data_width + 1}_t'
-            ({{axis_{arg.name}_tlast, axis_{arg.name}_tdata}});
+    assign axis_{arg.name}_token =
+        {{axis_{arg.name}_tlast, axis_{arg.name}_tdata}};
 """
             )
-        else:
-            _logger.fatal("unexpected arg.port.mode: %s", arg.port.mode)
 
     newline = "\n"
-    test = f"""
+    test = get_scalar_regs(list(arg_to_reg_addrs), scalar_arg_to_val)
+    test += f"""
   parameter HALF_CLOCK_PERIOD = 2;
   parameter CLOCK_PERIOD = HALF_CLOCK_PERIOD * 2;
 
@@ -480,11 +532,7 @@ def get_vitis_test_signals(
   end
 
   // axis signals
-  always @(posedge ap_clk) begin
-    if (kernel_started) begin
-      {newline.join(axis_dpi_calls)}
-    end
-  end
+{newline.join(axis_instances)}
 
 {newline.join(axis_assignments)}
 
@@ -500,7 +548,7 @@ def get_vitis_test_signals(
 """
 
     for arg, addrs in arg_to_reg_addrs.items():
-        val = scalar_arg_to_val.get(arg, 0)
+        val = f"scalar_{arg}"
         test += (
             f"    s_axi_aw_write <= 1; s_axi_aw_din <= {addrs[0]}; "
             "s_axi_w_write <= 1; "
@@ -541,6 +589,7 @@ def get_vitis_test_signals(
     dump_signals = "\n".join(
         f"          axi_ram_{arg.name}_dump_mem <= 1;" for arg in args if arg.is_mmap
     )
+    write_perf_counters = "          write_perf_counters();" if perf_counters else ""
     test += f"""
   // polling on ap_done
   always @(posedge ap_clk) begin
@@ -549,8 +598,10 @@ def get_vitis_test_signals(
     else begin
       if (s_axi_control_rvalid) begin
         if (s_axi_control_rdata[1]) begin
+          kernel_done <= 1'b1;
 {dump_signals}
           #(CLOCK_PERIOD*100)
+{write_perf_counters}
           $finish;
         end
       end
@@ -561,56 +612,31 @@ def get_vitis_test_signals(
     return test
 
 
-def get_hls_test_signals(args: Sequence[Arg]) -> str:
-    fifo_dpi_calls = []
-    fifo_assignments = []
-
+def get_hls_test_signals(
+    args: Sequence[Arg],
+    stream_batch_size: int = DEFAULT_STREAM_BATCH_SIZE,
+    perf_counters: bool = False,
+) -> str:
     # build signals for FIFOs
-    for arg in args:
-        if not arg.is_stream:
-            continue
-        if arg.port.is_istream:
-            fifo_dpi_calls.append(f"""
-    tapa::istream(
-        fifo_{arg.qualified_name}_data_unpacked_next,
-        fifo_{arg.qualified_name}_valid_next,
-        fifo_{arg.qualified_name}_ready,
-        "{arg.qualified_name}"
-    );
-
-    fifo_{arg.qualified_name}_data_unpacked <=
-        fifo_{arg.qualified_name}_data_unpacked_next;
-    fifo_{arg.qualified_name}_valid <= fifo_{arg.qualified_name}_valid_next;
-""")
-            fifo_assignments.append(f"""
-    assign fifo_{arg.qualified_name}_data =
-        packed_uint{arg.port.data_width + 1}_t'(
-            fifo_{arg.qualified_name}_data_unpacked);
-""")
-        elif arg.port.is_ostream:
-            fifo_dpi_calls.append(f"""
-    tapa::ostream(
-        fifo_{arg.qualified_name}_data_unpacked,
-        fifo_{arg.qualified_name}_ready_next,
-        fifo_{arg.qualified_name}_valid,
-        "{arg.qualified_name}"
-    );
-
-    fifo_{arg.qualified_name}_ready <= fifo_{arg.qualified_name}_ready_next;
-""")
-            fifo_assignments.append(f"""
-    assign fifo_{arg.qualified_name}_data_unpacked =
-        unpacked_uint{arg.port.data_width + 1}_t'(fifo_{arg.qualified_name}_data);
-""")
-        else:
-            msg = f"unexpected arg.port.mode: {arg.port.mode}"
-            raise ValueError(msg)
+    fifo_instances = [
+        get_dpi_stream_inst(
+            arg,
+            f"fifo_{arg.qualified_name}_dpi",
+            f"fifo_{arg.qualified_name}_data",
+            f"fifo_{arg.qualified_name}_valid",
+            f"fifo_{arg.qualified_name}_ready",
+            stream_batch_size,
+        )
+        for arg in args
+        if arg.is_stream
+    ]
 
     dump_signals = [
         f"    axi_ram_{arg.name}_dump_mem <= 1;" for arg in args if arg.is_mmap
     ]
 
     newline = "\n"
+    write_perf_counters = "    write_perf_counters();" if perf_counters else ""
 
     return f"""
   parameter HALF_CLOCK_PERIOD = 2;
@@ -625,10 +651,9 @@ def get_hls_test_signals(args: Sequence[Arg]) -> str:
   end
 
   // fifo signals
+{newline.join(fifo_instances)}
+
   always @(posedge ap_clk) begin
-    if (kernel_started) begin
-      {newline.join(fifo_dpi_calls)}
-    end
     if (ap_done) begin
       kernel_done <= 1'b1;
     end
@@ -637,8 +662,6 @@ def get_hls_test_signals(args: Sequence[Arg]) -> str:
     end
   end
 
-{newline.join(fifo_assignments)}
-
   initial begin
     // reset the DUT
     ap_rst_n = 1'b0;
@@ -660,30 +683,293 @@ def get_hls_test_signals(args: Sequence[Arg]) -> str:
 {newline.join(dump_signals)}
 
     #(CLOCK_PERIOD*100);
+{write_perf_counters}
     $finish;
   end
 """
 
 
+def get_perf_counters(
+    axi_list: Sequence[AXI],
+    args: Sequence[Arg],
+    mode: str,
+    perf_counters_path: str,
+    rtl_perf_counters: dict | None = None,
+) -> str:
+    """Counts cycles of the kernel and its ports while the kernel runs.
+
+    `write_perf_counters` writes the counters as JSON to `perf_counters_path`,
+    or to `+TAPA_PERF_COUNTERS` if set. Streams count cycles with valid and
+    ready asserted; stall cycles are valid but not ready. Memory-mapped ports
+    report the statistics of their AXI RAM.
+
+    In Vitis mode, `rtl_perf_counters` are the `perf_counters` in the TAPA
+    report of kernels built with `--enable-perf-counters`; they are read from
+    `s_axi_control` after the kernel finishes.
+    """
+    decls = []
+    updates = []
+    writes = []
+    for arg in args:
+        if not arg.is_stream:
+            continue
+        if mode == "vitis":
+            name, prefix = arg.name, f"axis_{arg.name}"
+            valid, ready = f"{prefix}_tvalid", f"{prefix}_tready"
+        else:
+            name, prefix = arg.qualified_name, f"fifo_{arg.qualified_name}"
+            valid, ready = f"{prefix}_valid", f"{prefix}_ready"
+        kind = "istream" if arg.port.is_istream else "ostream"
+        counter = f"perf_{prefix}"
+        decls.append(f"""
+  reg [63:0] {counter}_valid_cycles = 0;
+  reg [63:0] {counter}_ready_cycles = 0;
+  reg [63:0] {counter}_transfers = 0;""")
+        updates.append(f"""
+      if ({valid}) {counter}_valid_cycles <= {counter}_valid_cycles + 1;
+      if ({ready}) {counter}_ready_cycles <= {counter}_ready_cycles + 1;
+      if ({valid} && {ready}) {counter}_transfers <= {counter}_transfers + 1;""")
+        writes.append(f"""
+      $fwrite(fp, "%s\\n    {{\\"name\\": \\"{name}\\", \\"kind\\": \\"{kind}\\", ",
+              sep);
+      $fwrite(fp, "\\"valid_cycles\\": %0d, \\"ready_cycles\\": %0d, ",
+              {counter}_valid_cycles, {counter}_ready_cycles);
+      $fwrite(fp, "\\"transfers\\": %0d, \\"stall_cycles\\": %0d}}",
+              {counter}_transfers, {counter}_valid_cycles - {counter}_transfers);
+      sep = ",";""")
+    for axi in axi_list:
+        ram = f"axi_ram_{axi.name}_unit"
+        strb_width = f"AXI_RAM_{axi.name.upper()}_STRB_WIDTH"
+        writes.append(f"""
+      $fwrite(fp, "%s\\n    {{\\"name\\": \\"{axi.name}\\", \\"kind\\": \\"mmap\\", ",
+              sep);
+      $fwrite(fp, "\\"transfers\\": %0d, \\"stall_cycles\\": %0d, ",
+              {ram}.stat_read_beats + {ram}.stat_write_beats,
+              {ram}.stat_stall_cycles);
+      $fwrite(fp, "\\"read_bytes\\": %0d, \\"write_bytes\\": %0d, ",
+              {ram}.stat_read_beats * {strb_width},
+              {ram}.stat_write_beats * {strb_width});
+      $fwrite(fp, "\\"max_outstanding_reads\\": %0d, ",
+              {ram}.stat_max_outstanding_reads);
+      $fwrite(fp, "\\"max_outstanding_writes\\": %0d}}",
+              {ram}.stat_max_outstanding_writes);
+      sep = ",";""")
+
+    reads = []
+    if mode == "vitis" and rtl_perf_counters:
+        offset = rtl_perf_counters["offset"]
+        for i, counter in enumerate(rtl_perf_counters["counters"]):
+            addr = offset + 8 * i
+            reads.append(f"""
+      read_control_register('h{addr:x}, perf_rtl_lo);
+      read_control_register('h{addr + 4:x}, perf_rtl_hi);
+      $fwrite(fp, "%s\\n    {{\\"name\\": \\"{counter["name"]}\\", ", sep);
+      $fwrite(fp, "\\"kind\\": \\"{counter["kind"]}\\", ");
+      $fwrite(fp, "\\"event\\": \\"{counter["event"]}\\", ");
+      $fwrite(fp, "\\"value\\": %0d}}", {{perf_rtl_hi, perf_rtl_lo}});
+      sep = ",";""")
+    if reads:
+        # stop polling `ap_done` and wait for outstanding reads
+        reads.insert(
+            0,
+            """
+      s_axi_control_arvalid <= 1'b0;
+      repeat (16) @(posedge ap_clk);
+      sep = "";
+      $fwrite(fp, "\\n  ], \\"counters\\": [");""",
+        )
+        read_control_register = """
+  task read_control_register(input [63:0] addr, output [31:0] data);
+    begin
+      s_axi_control_araddr <= addr;
+      s_axi_control_arvalid <= 1'b1;
+      do @(posedge ap_clk); while (!s_axi_control_arready);
+      s_axi_control_arvalid <= 1'b0;
+      do @(posedge ap_clk); while (!s_axi_control_rvalid);
+      data = s_axi_control_rdata;
+    end
+  endtask
+"""
+    else:
+        read_control_register = ""
+
+    return f"""
+  // performance counters
+  reg [63:0] perf_kernel_cycles = 0;{"".join(decls)}
+
+  always @(posedge ap_clk) begin
+    if (kernel_started && !kernel_done) begin
+      perf_kernel_cycles <= perf_kernel_cycles + 1;{"".join(updates)}
+    end
+  end
+{read_control_register}
+  task write_perf_counters;
+    reg [8*4096-1:0] path;
+    reg [31:0] perf_rtl_lo;
+    reg [31:0] perf_rtl_hi;
+    integer fp;
+    string sep;
+    begin
+      if (!$value$plusargs("TAPA_PERF_COUNTERS=%s", path)) begin
+        path = "{perf_counters_path}";
+      end
+      fp = $fopen(path, "w");
+      sep = "";
+      $fwrite(fp, "{{\\"kernel_cycles\\": %0d, \\"ports\\": [",
+              perf_kernel_cycles);{"".join(writes)}{"".join(reads)}
+      $fwrite(fp, "\\n  ]}}\\n");
+      $fclose(fp);
+    end
+  endtask
+"""
+
+
 def get_begin() -> str:
     return """
 `timescale 1 ns / 1 ps
 
 package tapa;
-  import "DPI-C" function void istream(
-    output logic  dout[],
-    output logic  empty_n,
-    input  logic  read,
-    input  string id
+  import "DPI-C" tapa_stream_open = function int open_stream(input string id);
+  import "DPI-C" tapa_istream_batch = function int istream_batch(
+    input  int        handle,
+    output bit [31:0] words[],
+    input  int        token_words
   );
-  import "DPI-C" function void ostream(
-    input  logic  din[],
-    output logic  full_n,
-    input  logic  write,
-    input  string id
+  import "DPI-C" tapa_ostream_batch = function int ostream_batch(
+    input  int        handle,
+    input  bit [31:0] words[],
+    input  int        token_words,
+    input  int        count
   );
 endpackage
 
+// Feeds tokens of host stream `ID` to the DUT. Up to `DEPTH` tokens are
+// prefetched per DPI call. If the host stream is empty, the interval between
+// polls doubles up to `MAX_POLL_INTERVAL` cycles.
+module tapa_dpi_istream #(
+  parameter string ID = "",
+  parameter int WIDTH = 1,
+  parameter int DEPTH = 1,
+  parameter int MAX_POLL_INTERVAL = 1
+) (
+  input  logic             clk,
+  input  logic             enable,
+  output logic [WIDTH-1:0] dout,
+  output logic             empty_n,
+  input  logic             read
+);
+
+  localparam int WORDS = (WIDTH + 31) / 32;
+
+  int handle;
+  bit [31:0] words[DEPTH * WORDS];
+  bit [WORDS * 32 - 1:0] token;
+  int count = 0;  // number of tokens in `words`
+  int index = 0;  // index of the token at the output
+  int poll_interval = 1;
+  int poll_wait = 0;
+
+  initial begin
+    handle = tapa::open_stream(ID);
+    empty_n = 1'b0;
+  end
+
+  always @(posedge clk) begin
+    if (enable) begin
+      if (empty_n && read) begin
+        index = index + 1;
+      end
+
+      if (index == count) begin
+        if (poll_wait > 0) begin
+          poll_wait = poll_wait - 1;
+        end else begin
+          count = tapa::istream_batch(handle, words, WORDS);
+          index = 0;
+          poll_interval = count > 0 ? 1 :
+              poll_interval * 2 > MAX_POLL_INTERVAL ? MAX_POLL_INTERVAL :
+              poll_interval * 2;
+          poll_wait = poll_interval - 1;
+        end
+      end
+
+      if (index < count) begin
+        for (int i = 0; i < WORDS; i = i + 1) begin
+          token[i * 32 +: 32] = words[index * WORDS + i];
+        end
+        dout <= token[WIDTH-1:0];
+      end
+      empty_n <= index < count;
+    end
+  end
+
+endmodule
+
+// Drains tokens written by the DUT to host stream `ID`. Up to `DEPTH` tokens
+// are sent per DPI call, either when the buffer is full or when the DUT stops
+// writing. If the host stream is full, the interval between retries doubles up
+// to `MAX_POLL_INTERVAL` cycles.
+module tapa_dpi_ostream #(
+  parameter string ID = "",
+  parameter int WIDTH = 1,
+  parameter int DEPTH = 1,
+  parameter int MAX_POLL_INTERVAL = 1
+) (
+  input  logic             clk,
+  input  logic             enable,
+  input  logic [WIDTH-1:0] din,
+  output logic             full_n,
+  input  logic             write
+);
+
+  localparam int WORDS = (WIDTH + 31) / 32;
+
+  int handle;
+  bit [31:0] words[DEPTH * WORDS];
+  bit [WORDS * 32 - 1:0] token;
+  bit written;
+  int count = 0;  // number of tokens in `words`
+  int pushed;
+  int poll_interval = 1;
+  int poll_wait = 0;
+
+  initial begin
+    handle = tapa::open_stream(ID);
+    full_n = 1'b0;
+  end
+
+  always @(posedge clk) begin
+    if (enable) begin
+      written = full_n && write;
+      if (written) begin
+        token = din;
+        for (int i = 0; i < WORDS; i = i + 1) begin
+          words[count * WORDS + i] = token[i * 32 +: 32];
+        end
+        count = count + 1;
+      end
+
+      if (count == DEPTH || (count > 0 && !written)) begin
+        if (poll_wait > 0) begin
+          poll_wait = poll_wait - 1;
+        end else begin
+          pushed = tapa::ostream_batch(handle, words, WORDS, count);
+          for (int i = 0; i < (count - pushed) * WORDS; i = i + 1) begin
+            words[i] = words[pushed * WORDS + i];
+          end
+          count = count - pushed;
+          poll_interval = pushed > 0 ? 1 :
+              poll_interval * 2 > MAX_POLL_INTERVAL ? MAX_POLL_INTERVAL :
+              poll_interval * 2;
+          poll_wait = poll_interval - 1;
+        end
+      end
+      full_n <= count < DEPTH;
+    end
+  end
+
+endmodule
+
 module test();
 
   reg ap_clk = 0;
@@ -708,17 +994,427 @@ endmodule
 """
 
 
-def get_axi_ram_module(axi: AXI, input_data_path: str, c_array_size: int) -> str:
-    """Generate the AXI RAM module for cosimulation."""
-    if axi.data_width / 8 * c_array_size > 2**MAX_AXI_BRAM_ADDR_WIDTH:
-        _logger.error(
-            "The current cosim data size is larger than the template "
-            "threshold (32-bit address). Please reduce cosim data size."
-        )
-        sys.exit(1)
+def _get_axi_ram_file_storage(
+    name: str, input_data_path: str, c_array_size: int
+) -> str:
+    """Memory array of the AXI RAM loaded from and dumped to data files.
+
+    `+TAPA_AXI_<name>_DATA` and `+TAPA_AXI_<name>_DATA_OUT` override the paths.
+    """
+    output_data_path = get_output_data_path(input_data_path)
+    return f"""
+reg [DATA_WIDTH-1:0] mem[(2**VALID_ADDR_WIDTH)-1:0];
+integer fp;
+integer read_size;
+reg [7:0] temp;
+reg [8*4096-1:0] data_path;
+reg [8*4096-1:0] data_out_path;
+
+integer i_rd, j_rd;
+initial begin
+  if (!$value$plusargs("TAPA_AXI_{name}_DATA=%s", data_path)) begin
+    data_path = "{input_data_path}";
+  end
+  if (!$value$plusargs("TAPA_AXI_{name}_DATA_OUT=%s", data_out_path)) begin
+    data_out_path = "{output_data_path}";
+  end
+  fp = $fopen(data_path, "rb");
+  for (i_rd = 0; i_rd < {c_array_size} ; i_rd = i_rd + 1) begin
+    for (j_rd = 0; j_rd < DATA_WIDTH / 8; j_rd = j_rd + 1) begin
+      $fread(temp, fp);
+      mem[i_rd][j_rd*8 +: 8] = temp;
+    end
+  end
+  $fclose(fp);
+end
+
+integer i_wr, j_wr;
+always @* begin
+  if (dump_mem) begin
+    fp = $fopen(data_out_path, "wb");
+    for (i_wr = 0; i_wr < {c_array_size}; i_wr = i_wr + 1) begin
+      for (j_wr = 0; j_wr < DATA_WIDTH / 8; j_wr = j_wr + 1) begin
+        $fwrite(fp, "%c", mem[i_wr][j_wr * 8 +: 8] );
+      end
+    end
+    $fclose(fp);
+  end
+end
+"""
+
 
-    if input_data_path:
-        assert os.path.exists(input_data_path)
+def _get_axi_ram_host_storage(name: str, host_buffer: str) -> str:
+    """Memory of the AXI RAM accessed in place in host memory via DPI.
+
+    `+TAPA_AXI_<name>_HOST_BUFFER` overrides the host buffer.
+    """
+    return f"""
+import "DPI-C" function chandle tapa_axi_mem_open(input string buffer);
+import "DPI-C" function void tapa_axi_mem_read(
+  input  chandle            mem,
+  input  longint unsigned   offset,
+  output byte unsigned      data[]
+);
+import "DPI-C" function void tapa_axi_mem_write(
+  input  chandle            mem,
+  input  longint unsigned   offset,
+  input  byte unsigned      data[],
+  input  byte unsigned      strb[]
+);
+
+chandle mem_handle;
+string host_buffer;
+byte unsigned mem_rd_bytes[STRB_WIDTH];
+integer j;
+
+// A write is queued at the clock edge and committed at the next edge before
+// the read of that cycle, so that a read at the same edge as the write sees
+// the old data, like a nonblocking write to a memory array.
+logic mem_wr_pending = 1'b0;
+longint unsigned mem_wr_offset;
+byte unsigned mem_wr_bytes[STRB_WIDTH];
+byte unsigned mem_wr_strb[STRB_WIDTH];
+
+// The host buffer is updated in place; nothing to dump.
+initial begin
+  if (!$value$plusargs("TAPA_AXI_{name}_HOST_BUFFER=%s", host_buffer)) begin
+    host_buffer = "{host_buffer}";
+  end
+  mem_handle = tapa_axi_mem_open(host_buffer);
+end
+
+final begin
+  if (mem_wr_pending) begin
+    tapa_axi_mem_write(mem_handle, mem_wr_offset, mem_wr_bytes, mem_wr_strb);
+  end
+end
+"""
+
+
+_AXI_RAM_FILE_WRITE = """
+    for (i = 0; i < WORD_WIDTH; i = i + 1) begin
+        if (mem_wr_en & s_axi_wstrb[i]) begin
+            mem[write_addr_valid][WORD_SIZE*i +: WORD_SIZE] <=
+                s_axi_wdata[WORD_SIZE*i +: WORD_SIZE];
+        end
+    end
+"""
+
+_AXI_RAM_HOST_WRITE = """
+    mem_wr_pending <= mem_wr_en;
+    if (mem_wr_en) begin
+        mem_wr_offset <= longint'(write_addr_valid) * STRB_WIDTH;
+        for (i = 0; i < WORD_WIDTH; i = i + 1) begin
+            mem_wr_bytes[i] <= s_axi_wdata[WORD_SIZE*i +: WORD_SIZE];
+            mem_wr_strb[i] <= s_axi_wstrb[i];
+        end
+    end
+"""
+
+_AXI_RAM_FILE_READ = """
+    if (mem_rd_en) begin
+        s_axi_rdata_reg <= mem[read_addr_valid];
+    end
+"""
+
+_AXI_RAM_HOST_READ = """
+    if (mem_wr_pending) begin
+        tapa_axi_mem_write(mem_handle, mem_wr_offset, mem_wr_bytes, mem_wr_strb);
+    end
+    if (mem_rd_en) begin
+        tapa_axi_mem_read(mem_handle, longint'(read_addr_valid) * STRB_WIDTH,
+                          mem_rd_bytes);
+        for (j = 0; j < WORD_WIDTH; j = j + 1) begin
+            s_axi_rdata_reg[WORD_SIZE*j +: WORD_SIZE] <= mem_rd_bytes[j];
+        end
+    end
+"""
+
+
+# Snippets of the AXI RAM that respond with idealized timing: one burst in
+# flight per direction, with data and responses as soon as possible.
+_AXI_RAM_IDEAL_TIMING = {
+    "decl": "",
+    "body": "",
+    "beat_ok": "",
+    "ar_assign": "assign s_axi_arready = s_axi_arready_reg;",
+    "ar_issue": "s_axi_arready && s_axi_arvalid",
+    "ar": "s_axi_ar",
+    "b_assign": "assign s_axi_bid = s_axi_bid_reg;\n"
+    "assign s_axi_bvalid = s_axi_bvalid_reg;",
+    "b_can_push": "s_axi_bready || !s_axi_bvalid",
+    "busy": "",
+}
+
+
+def _get_random_latency(latency: Latency) -> str:
+    if latency.min == latency.max:
+        return str(latency.min)
+    return f"({latency.min} + {{$random(seed)}} % {latency.max - latency.min + 1})"
+
+
+def _get_axi_ram_model_timing(model: MemoryModel) -> dict[str, str]:
+    """Snippets of the AXI RAM that respond with the timing of `model`.
+
+    Read addresses are queued until their latency elapses, and write responses
+    are queued until theirs does. Bank state is updated when addresses are
+    accepted. Read and write beats take credits of a shared token bucket.
+    """
+    read_latency = _get_random_latency(model.read_latency)
+    write_latency = _get_random_latency(model.write_latency)
+    decl = f"""
+// memory timing model
+localparam RD_OUTSTANDING = {model.max_outstanding_reads};
+localparam WR_OUTSTANDING = {model.max_outstanding_writes};
+localparam BANKS = {max(model.banks, 1)};
+localparam BANK_MODEL = {int(model.banks > 0)};
+localparam ROW_BYTES = {model.row_bytes};
+localparam ROW_MISS_PENALTY = {model.row_miss_penalty};
+// bandwidth in 1/256 bytes per cycle, 0 if unlimited
+localparam BW_RATE = {round(model.bytes_per_cycle * 256)};
+localparam BEAT_COST = STRB_WIDTH * 256;
+localparam BW_CAP = BW_RATE > 2 * BEAT_COST ? BW_RATE : 2 * BEAT_COST;
+
+reg [63:0] cycle = 0;
+integer seed = 1;
+integer bw_credit = 0;
+wire bw_ok = BW_RATE == 0 || bw_credit >= BEAT_COST;
+
+reg [ID_WIDTH-1:0] ar_q_id[0:RD_OUTSTANDING-1];
+reg [ADDR_WIDTH-1:0] ar_q_addr[0:RD_OUTSTANDING-1];
+reg [7:0] ar_q_len[0:RD_OUTSTANDING-1];
+reg [2:0] ar_q_size[0:RD_OUTSTANDING-1];
+reg [1:0] ar_q_burst[0:RD_OUTSTANDING-1];
+reg [63:0] ar_q_time[0:RD_OUTSTANDING-1];
+integer ar_q_head = 0, ar_q_tail = 0, ar_q_count = 0;
+wire [ID_WIDTH-1:0] ar_q_head_id = ar_q_id[ar_q_head];
+wire [ADDR_WIDTH-1:0] ar_q_head_addr = ar_q_addr[ar_q_head];
+wire [7:0] ar_q_head_len = ar_q_len[ar_q_head];
+wire [2:0] ar_q_head_size = ar_q_size[ar_q_head];
+wire [1:0] ar_q_head_burst = ar_q_burst[ar_q_head];
+wire ar_q_issue = ar_q_count > 0 && ar_q_time[ar_q_head] <= cycle;
+
+reg [ID_WIDTH-1:0] b_q_id[0:WR_OUTSTANDING-1];
+reg [63:0] b_q_time[0:WR_OUTSTANDING-1];
+integer b_q_head = 0, b_q_tail = 0, b_q_count = 0;
+reg [63:0] aw_delay = 0;
+
+reg [63:0] bank_free[0:BANKS-1];
+reg [63:0] bank_row[0:BANKS-1];
+integer i_bank;
+initial begin
+    for (i_bank = 0; i_bank < BANKS; i_bank = i_bank + 1) begin
+        bank_free[i_bank] = 0;
+        bank_row[i_bank] = {{64{{1'b1}}}};
+    end
+end
+
+// Returns the cycles a burst waits for its bank, and occupies the bank.
+task bank_access;
+    input [ADDR_WIDTH-1:0] addr;
+    input [8:0] beats;
+    output [63:0] delay;
+    integer bank;
+    reg [63:0] row;
+    begin
+        delay = 0;
+        if (BANK_MODEL) begin
+            bank = (addr / ROW_BYTES) % BANKS;
+            row = addr / (ROW_BYTES * BANKS);
+            if (bank_free[bank] > cycle) begin
+                delay = bank_free[bank] - cycle;
+            end
+            if (bank_row[bank] != row) begin
+                delay = delay + ROW_MISS_PENALTY;
+                bank_row[bank] = row;
+            end
+            bank_free[bank] = cycle + delay + beats;
+        end
+    end
+endtask
+"""
+    body = f"""
+reg [63:0] rd_delay, wr_delay;
+integer bw_credit_next;
+always @(posedge clk) begin
+    cycle <= cycle + 1;
+
+    if (BW_RATE != 0) begin
+        bw_credit_next = bw_credit + BW_RATE;
+        if (mem_rd_en) bw_credit_next = bw_credit_next - BEAT_COST;
+        if (mem_wr_en) bw_credit_next = bw_credit_next - BEAT_COST;
+        bw_credit <= bw_credit_next > BW_CAP ? BW_CAP : bw_credit_next;
+    end
+
+    if (s_axi_arvalid && s_axi_arready) begin
+        bank_access(s_axi_araddr, s_axi_arlen + 1, rd_delay);
+        ar_q_id[ar_q_tail] <= s_axi_arid;
+        ar_q_addr[ar_q_tail] <= s_axi_araddr;
+        ar_q_len[ar_q_tail] <= s_axi_arlen;
+        ar_q_size[ar_q_tail] <= s_axi_arsize;
+        ar_q_burst[ar_q_tail] <= s_axi_arburst;
+        ar_q_time[ar_q_tail] <= cycle + {read_latency} + rd_delay;
+        ar_q_tail <= (ar_q_tail + 1) % RD_OUTSTANDING;
+    end
+    if (read_state_reg == READ_STATE_IDLE && ar_q_issue) begin
+        ar_q_head <= (ar_q_head + 1) % RD_OUTSTANDING;
+    end
+    ar_q_count <= ar_q_count
+        + (s_axi_arvalid && s_axi_arready)
+        - (read_state_reg == READ_STATE_IDLE && ar_q_issue);
+
+    if (s_axi_awvalid && s_axi_awready) begin
+        bank_access(s_axi_awaddr, s_axi_awlen + 1, wr_delay);
+        aw_delay <= wr_delay;
+    end
+    if (b_push) begin
+        b_q_id[b_q_tail] <= write_id_reg;
+        b_q_time[b_q_tail] <= cycle + {write_latency} + aw_delay;
+        b_q_tail <= (b_q_tail + 1) % WR_OUTSTANDING;
+    end
+    if (s_axi_bvalid && s_axi_bready) begin
+        b_q_head <= (b_q_head + 1) % WR_OUTSTANDING;
+    end
+    b_q_count <= b_q_count + b_push - (s_axi_bvalid && s_axi_bready);
+
+    if (rst) begin
+        ar_q_head <= 0;
+        ar_q_tail <= 0;
+        ar_q_count <= 0;
+        b_q_head <= 0;
+        b_q_tail <= 0;
+        b_q_count <= 0;
+    end
+end
+"""
+    return {
+        "decl": decl,
+        "body": body,
+        "beat_ok": " && bw_ok",
+        "ar_assign": "assign s_axi_arready = ar_q_count < RD_OUTSTANDING;",
+        "ar_issue": "ar_q_issue",
+        "ar": "ar_q_head_",
+        "b_assign": "assign s_axi_bid = b_q_id[b_q_head];\n"
+        "assign s_axi_bvalid = b_q_count > 0 && b_q_time[b_q_head] <= cycle;",
+        "b_can_push": "b_q_count < WR_OUTSTANDING",
+        "busy": " || ar_q_count > 0 || b_q_count > 0",
+    }
+
+
+def _get_axi_ram_stats(name: str, busy: str) -> str:
+    """Statistics of the AXI RAM displayed when the memory is dumped.
+
+    Stall cycles are cycles with outstanding transactions but no data beat.
+    Outstanding reads count accepted addresses whose last beat is not returned;
+    outstanding writes count accepted addresses whose response is not returned.
+    """
+    return f"""
+// port statistics
+reg [63:0] stat_cycle = 0;
+reg [63:0] stat_first_cycle = 0;
+reg [63:0] stat_last_cycle = 0;
+reg [63:0] stat_read_beats = 0;
+reg [63:0] stat_write_beats = 0;
+reg [63:0] stat_stall_cycles = 0;
+reg [63:0] stat_outstanding_reads = 0;
+reg [63:0] stat_outstanding_writes = 0;
+reg [63:0] stat_max_outstanding_reads = 0;
+reg [63:0] stat_max_outstanding_writes = 0;
+reg stat_started = 1'b0;
+wire stat_ar_fire = s_axi_arvalid && s_axi_arready;
+wire stat_r_done = s_axi_rvalid && s_axi_rready && s_axi_rlast;
+wire stat_aw_fire = s_axi_awvalid && s_axi_awready;
+wire stat_b_fire = s_axi_bvalid && s_axi_bready;
+wire [63:0] stat_next_outstanding_reads =
+    stat_outstanding_reads + stat_ar_fire - stat_r_done;
+wire [63:0] stat_next_outstanding_writes =
+    stat_outstanding_writes + stat_aw_fire - stat_b_fire;
+wire stat_busy = s_axi_arvalid || s_axi_awvalid || s_axi_rvalid ||
+    s_axi_bvalid || read_state_reg != READ_STATE_IDLE ||
+    write_state_reg != WRITE_STATE_IDLE{busy};
+always @(posedge clk) begin
+    stat_cycle <= stat_cycle + 1;
+    if (!rst && stat_busy) begin
+        if (!stat_started) begin
+            stat_started <= 1'b1;
+            stat_first_cycle <= stat_cycle;
+        end
+        stat_last_cycle <= stat_cycle;
+        if (mem_rd_en) stat_read_beats <= stat_read_beats + 1;
+        if (mem_wr_en) stat_write_beats <= stat_write_beats + 1;
+        if (!mem_rd_en && !mem_wr_en) begin
+            stat_stall_cycles <= stat_stall_cycles + 1;
+        end
+        stat_outstanding_reads <= stat_next_outstanding_reads;
+        stat_outstanding_writes <= stat_next_outstanding_writes;
+        if (stat_next_outstanding_reads > stat_max_outstanding_reads) begin
+            stat_max_outstanding_reads <= stat_next_outstanding_reads;
+        end
+        if (stat_next_outstanding_writes > stat_max_outstanding_writes) begin
+            stat_max_outstanding_writes <= stat_next_outstanding_writes;
+        end
+    end
+end
+
+reg [63:0] stat_active_cycles;
+reg [63:0] stat_centibytes_per_cycle;
+always @(posedge dump_mem) begin
+    stat_active_cycles =
+        stat_started ? stat_last_cycle - stat_first_cycle + 1 : 0;
+    stat_centibytes_per_cycle = stat_active_cycles == 0 ? 0 :
+        (stat_read_beats + stat_write_beats) * STRB_WIDTH * 100 /
+        stat_active_cycles;
+    $write("[tapa-cosim] m_axi {name}: read %0d bytes, wrote %0d bytes, ",
+           stat_read_beats * STRB_WIDTH, stat_write_beats * STRB_WIDTH);
+    $display("%0d active cycles, %0d.%02d bytes/cycle, %0d stall cycles",
+             stat_active_cycles, stat_centibytes_per_cycle / 100,
+             stat_centibytes_per_cycle % 100, stat_stall_cycles);
+end
+"""
+
+
+def get_axi_ram_module(
+    axi: AXI,
+    input_data_path: str,
+    c_array_size: int,
+    host_buffer: str | None = None,
+    memory_model: MemoryModel | None = None,
+) -> str:
+    """Generate the AXI RAM module for cosimulation.
+
+    If `host_buffer` is not None, the RAM reads and writes the buffer in host
+    memory in place through DPI instead of loading `input_data_path` and dumping
+    it back. The module is SystemVerilog and uses the full address width of
+    `axi` in that case. Empty paths must be given by plusargs at run time.
+
+    If `memory_model` is not None, the RAM responds with its timing instead of
+    idealized timing. Either way, the RAM displays the bandwidth and stall
+    cycles of the port at the end of simulation.
+    """
+    if host_buffer is not None:
+        addr_width = axi.addr_width
+        storage = _get_axi_ram_host_storage(axi.name, host_buffer)
+        mem_write = _AXI_RAM_HOST_WRITE
+        mem_read = _AXI_RAM_HOST_READ
+    else:
+        if axi.data_width / 8 * c_array_size > 2**MAX_AXI_BRAM_ADDR_WIDTH:
+            _logger.error(
+                "The current cosim data size is larger than the template "
+                "threshold (32-bit address). Please reduce cosim data size."
+            )
+            sys.exit(1)
+        addr_width = MAX_AXI_BRAM_ADDR_WIDTH
+        if input_data_path:
+            assert os.path.exists(input_data_path)
+        storage = _get_axi_ram_file_storage(axi.name, input_data_path, c_array_size)
+        mem_write = _AXI_RAM_FILE_WRITE
+        mem_read = _AXI_RAM_FILE_READ
+
+    if memory_model is None:
+        timing = _AXI_RAM_IDEAL_TIMING
+    else:
+        timing = _get_axi_ram_model_timing(memory_model)
+    stats = _get_axi_ram_stats(axi.name, timing["busy"])
 
     return f"""
 /*
@@ -759,7 +1455,7 @@ module axi_ram_{axi.name} #
     // Width of data bus in bits
     parameter DATA_WIDTH = {axi.data_width},
     // Width of address bus in bits
-    parameter ADDR_WIDTH = {MAX_AXI_BRAM_ADDR_WIDTH},
+    parameter ADDR_WIDTH = {addr_width},
     // Width of wstrb (width of data bus in words)
     parameter STRB_WIDTH = (DATA_WIDTH/8),
     // Width of ID signal
@@ -814,35 +1510,7 @@ parameter WORD_WIDTH = STRB_WIDTH;
 parameter WORD_SIZE = DATA_WIDTH/WORD_WIDTH;
 
 //////////////////////////////////////////////////////////////////////
-
-reg [DATA_WIDTH-1:0] mem[(2**VALID_ADDR_WIDTH)-1:0];
-integer fp;
-integer read_size;
-reg [7:0] temp;
-
-integer i_rd, j_rd;
-initial begin
-  fp = $fopen("{input_data_path}", "rb");
-  for (i_rd = 0; i_rd < {c_array_size} ; i_rd = i_rd + 1) begin
-    for (j_rd = 0; j_rd < DATA_WIDTH / 8; j_rd = j_rd + 1) begin
-      $fread(temp, fp);
-      mem[i_rd][j_rd*8 +: 8] = temp;
-    end
-  end
-end
-
-integer i_wr, j_wr;
-always @* begin
-  if (dump_mem) begin
-    fp = $fopen("{input_data_path.replace(".bin", "_out.bin")}", "wb");
-    for (i_wr = 0; i_wr < {c_array_size}; i_wr = i_wr + 1) begin
-      for (j_wr = 0; j_wr < DATA_WIDTH / 8; j_wr = j_wr + 1) begin
-        $fwrite(fp, "%c", mem[i_wr][j_wr * 8 +: 8] );
-      end
-    end
-  end
-end
-
+{storage}
 //////////////////////////////////////////////////////////////////////
 
 // bus width assertions
@@ -873,6 +1541,7 @@ reg [1:0] write_state_reg = WRITE_STATE_IDLE, write_state_next;
 
 reg mem_wr_en;
 reg mem_rd_en;
+reg b_push;  // a write burst completes and its response is due
 
 reg [ID_WIDTH-1:0] read_id_reg = {{ID_WIDTH{{1'b0}}}}, read_id_next;
 reg [ADDR_WIDTH-1:0] read_addr_reg = {{ADDR_WIDTH{{1'b0}}}}, read_addr_next;
@@ -910,12 +1579,12 @@ wire [VALID_ADDR_WIDTH-1:0] read_addr_valid =
 wire [VALID_ADDR_WIDTH-1:0] write_addr_valid =
     write_addr_reg >> (ADDR_WIDTH - VALID_ADDR_WIDTH);
 
+{timing["decl"]}
 assign s_axi_awready = s_axi_awready_reg;
-assign s_axi_wready = s_axi_wready_reg;
-assign s_axi_bid = s_axi_bid_reg;
+assign s_axi_wready = s_axi_wready_reg{timing["beat_ok"]};
+{timing["b_assign"]}
 assign s_axi_bresp = 2'b00;
-assign s_axi_bvalid = s_axi_bvalid_reg;
-assign s_axi_arready = s_axi_arready_reg;
+{timing["ar_assign"]}
 assign s_axi_rid = PIPELINE_OUTPUT ? s_axi_rid_pipe_reg : s_axi_rid_reg;
 assign s_axi_rdata = PIPELINE_OUTPUT ? s_axi_rdata_pipe_reg : s_axi_rdata_reg;
 assign s_axi_rresp = 2'b00;
@@ -927,6 +1596,7 @@ always @* begin
     write_state_next = WRITE_STATE_IDLE;
 
     mem_wr_en = 1'b0;
+    b_push = 1'b0;
 
     write_id_next = write_id_reg;
     write_addr_next = write_addr_reg;
@@ -972,7 +1642,8 @@ always @* begin
                     write_state_next = WRITE_STATE_BURST;
                 end else begin
                     s_axi_wready_next = 1'b0;
-                    if (s_axi_bready || !s_axi_bvalid) begin
+                    if ({timing["b_can_push"]}) begin
+                        b_push = 1'b1;
                         s_axi_bid_next = write_id_reg;
                         s_axi_bvalid_next = 1'b1;
                         s_axi_awready_next = 1'b1;
@@ -986,7 +1657,8 @@ always @* begin
             end
         end
         WRITE_STATE_RESP: begin
-            if (s_axi_bready || !s_axi_bvalid) begin
+            if ({timing["b_can_push"]}) begin
+                b_push = 1'b1;
                 s_axi_bid_next = write_id_reg;
                 s_axi_bvalid_next = 1'b1;
                 s_axi_awready_next = 1'b1;
@@ -1012,14 +1684,7 @@ always @(posedge clk) begin
     s_axi_wready_reg <= s_axi_wready_next;
     s_axi_bid_reg <= s_axi_bid_next;
     s_axi_bvalid_reg <= s_axi_bvalid_next;
-
-    for (i = 0; i < WORD_WIDTH; i = i + 1) begin
-        if (mem_wr_en & s_axi_wstrb[i]) begin
-            mem[write_addr_valid][WORD_SIZE*i +: WORD_SIZE] <=
-                s_axi_wdata[WORD_SIZE*i +: WORD_SIZE];
-        end
-    end
-
+{mem_write}
     if (rst) begin
         write_state_reg <= WRITE_STATE_IDLE;
 
@@ -1052,14 +1717,14 @@ always @* begin
         READ_STATE_IDLE: begin
             s_axi_arready_next = 1'b1;
 
-            if (s_axi_arready && s_axi_arvalid) begin
-                read_id_next = s_axi_arid;
-                read_addr_next = s_axi_araddr;
-                read_count_next = s_axi_arlen;
-                read_size_next = s_axi_arsize < $clog2(STRB_WIDTH)
-                                    ? s_axi_arsize
+            if ({timing["ar_issue"]}) begin
+                read_id_next = {timing["ar"]}id;
+                read_addr_next = {timing["ar"]}addr;
+                read_count_next = {timing["ar"]}len;
+                read_size_next = {timing["ar"]}size < $clog2(STRB_WIDTH)
+                                    ? {timing["ar"]}size
                                     : $clog2(STRB_WIDTH);
-                read_burst_next = s_axi_arburst;
+                read_burst_next = {timing["ar"]}burst;
 
                 s_axi_arready_next = 1'b0;
                 read_state_next = READ_STATE_BURST;
@@ -1068,9 +1733,9 @@ always @* begin
             end
         end
         READ_STATE_BURST: begin
-            if (s_axi_rready ||
-                (PIPELINE_OUTPUT && !s_axi_rvalid_pipe_reg) ||
-                !s_axi_rvalid_reg) begin
+            if ((s_axi_rready ||
+                 (PIPELINE_OUTPUT && !s_axi_rvalid_pipe_reg) ||
+                 !s_axi_rvalid_reg){timing["beat_ok"]}) begin
                 mem_rd_en = 1'b1;
                 s_axi_rvalid_next = 1'b1;
                 s_axi_rid_next = read_id_reg;
@@ -1105,11 +1770,7 @@ always @(posedge clk) begin
     s_axi_rid_reg <= s_axi_rid_next;
     s_axi_rlast_reg <= s_axi_rlast_next;
     s_axi_rvalid_reg <= s_axi_rvalid_next;
-
-    if (mem_rd_en) begin
-        s_axi_rdata_reg <= mem[read_addr_valid];
-    end
-
+{mem_read}
     if (!s_axi_rvalid_pipe_reg || s_axi_rready) begin
         s_axi_rid_pipe_reg <= s_axi_rid_reg;
         s_axi_rdata_pipe_reg <= s_axi_rdata_reg;
@@ -1125,7 +1786,8 @@ always @(posedge clk) begin
         s_axi_rvalid_pipe_reg <= 1'b0;
     end
 end
-
+{timing["body"]}
+{stats}
 endmodule
 
 """
@@ -0,0 +1,89 @@
+"""Generate Verilator commands for cosimulation."""
+
+__copyright__ = """
+Copyright (c) 2024 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import logging
+import shutil
+from pathlib import Path
+
+from tapa.common import paths
+
+_logger = logging.getLogger().getChild(__name__)
+
+_DPI_LIBRARY = "tapa_fast_cosim_dpi_verilator.so"
+
+
+def _glob_rtl_files(path: str, locs: tuple[str, ...]) -> list[str]:
+    files = []
+    for loc in locs:
+        for suffix in (".v", ".sv"):
+            files.extend(sorted(str(x) for x in Path(path).glob(loc + suffix)))
+    return files
+
+
+def get_verilator_command(
+    config: dict,
+    tb_rtl_path: str,
+    build_dir: str,
+    threads: int,
+) -> list[str]:
+    """Generate a Verilator command that builds the cosimulation binary.
+
+    The binary is `get_verilator_binary(build_dir)`. Unlike xsim, Verilator
+    cannot simulate Xilinx IP cores, so RTL that instantiates any is rejected.
+    """
+    tapa_hdl_path = config["verilog_path"]
+    for loc in ("*", "*/*"):
+        for suffix in (".tcl", ".xci"):
+            if ip_files := list(Path(tapa_hdl_path).glob(loc + suffix)):
+                msg = (
+                    f"Verilator does not support Xilinx IP cores, found {ip_files[0]};"
+                    " please use xsim instead"
+                )
+                raise ValueError(msg)
+
+    dpi_library_dir = paths.find_resource("tapa-fast-cosim-dpi-lib")
+    _logger.debug("DPI directory: %s", dpi_library_dir)
+    library_dirs = {dpi_library_dir} | paths.find_external_lib_in_runfiles()
+    ldflags = [f"{dpi_library_dir}/{_DPI_LIBRARY}"]
+    ldflags += [f"-Wl,-rpath,{x}" for x in sorted(library_dirs)]
+
+    return [
+        "verilator",
+        "--binary",
+        "--timing",
+        "--top-module",
+        "test",
+        "--Mdir",
+        build_dir,
+        "--threads",
+        str(threads),
+        "-j",
+        "0",
+        # HLS RTL is not lint-clean.
+        "-Wno-fatal",
+        "-Wno-lint",
+        "-Wno-style",
+        "-LDFLAGS",
+        " ".join(ldflags),
+        *_glob_rtl_files(tapa_hdl_path, ("*", "*/*")),
+        *_glob_rtl_files(tb_rtl_path, ("*",)),
+    ]
+
+
+def get_verilator_binary(build_dir: str) -> str:
+    """Return the cosimulation binary built in `build_dir`."""
+    return f"{build_dir}/Vtest"
+
+
+def copy_memory_init_files(config: dict, run_dir: str) -> None:
+    """Copy memory initialization files of the RTL to `run_dir`.
+
+    HLS RTL loads ROMs from `.dat` files relative to the working directory.
+    """
+    for dat_file in Path(config["verilog_path"]).glob("**/*.dat"):
+        shutil.copy(dat_file, run_dir)
@@ -0,0 +1,90 @@
+"""Unit tests for tapa.cosim.verilator."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+from pathlib import Path
+
+import pytest
+
+from tapa.cosim import verilator
+from tapa.cosim.verilator import (
+    copy_memory_init_files,
+    get_verilator_binary,
+    get_verilator_command,
+)
+
+
+@pytest.fixture
+def dpi_library_dir(tmp_path: Path, monkeypatch: pytest.MonkeyPatch) -> Path:
+    path = tmp_path / "lib"
+    monkeypatch.setattr(verilator.paths, "find_resource", lambda _: path)
+    monkeypatch.setattr(
+        verilator.paths,
+        "find_external_lib_in_runfiles",
+        lambda: {tmp_path / "glog"},
+    )
+    return path
+
+
+def _make_design(tmp_path: Path) -> tuple[dict, Path]:
+    hdl_dir = tmp_path / "hdl"
+    (hdl_dir / "sub").mkdir(parents=True)
+    (hdl_dir / "top.v").write_text("module top; endmodule")
+    (hdl_dir / "sub" / "fifo.sv").write_text("module fifo; endmodule")
+    (hdl_dir / "notes.txt").write_text("not rtl")
+    tb_dir = tmp_path / "tb"
+    tb_dir.mkdir()
+    (tb_dir / "test.sv").write_text("module test; endmodule")
+    return {"verilog_path": hdl_dir.as_posix()}, tb_dir
+
+
+def test_command_builds_testbench_with_dpi_library(
+    tmp_path: Path, dpi_library_dir: Path
+) -> None:
+    config, tb_dir = _make_design(tmp_path)
+    command = get_verilator_command(
+        config, tb_dir.as_posix(), (tmp_path / "build").as_posix(), 4
+    )
+
+    assert command[0] == "verilator"
+    assert command[command.index("--top-module") + 1] == "test"
+    assert command[command.index("--Mdir") + 1] == (tmp_path / "build").as_posix()
+    assert command[command.index("--threads") + 1] == "4"
+    ldflags = command[command.index("-LDFLAGS") + 1].split()
+    assert ldflags == [
+        f"{dpi_library_dir}/tapa_fast_cosim_dpi_verilator.so",
+        f"-Wl,-rpath,{tmp_path / 'glog'}",
+        f"-Wl,-rpath,{dpi_library_dir}",
+    ]
+    assert command[-3:] == [
+        (tmp_path / "hdl" / "top.v").as_posix(),
+        (tmp_path / "hdl" / "sub" / "fifo.sv").as_posix(),
+        (tb_dir / "test.sv").as_posix(),
+    ]
+    assert get_verilator_binary("build") == "build/Vtest"
+
+
+@pytest.mark.parametrize("ip_file", ["ip.tcl", "ip/ip.xci"])
+def test_command_rejects_ip_cores(
+    tmp_path: Path, dpi_library_dir: Path, ip_file: str
+) -> None:
+    config, tb_dir = _make_design(tmp_path)
+    (tmp_path / "hdl" / ip_file).parent.mkdir(exist_ok=True)
+    (tmp_path / "hdl" / ip_file).touch()
+    with pytest.raises(ValueError, match="does not support Xilinx IP cores"):
+        get_verilator_command(config, tb_dir.as_posix(), tmp_path.as_posix(), 1)
+
+
+def test_memory_init_files_are_copied(tmp_path: Path) -> None:
+    config, _ = _make_design(tmp_path)
+    (tmp_path / "hdl" / "sub" / "rom.dat").write_text("00\n01\n")
+    run_dir = tmp_path / "run"
+    run_dir.mkdir()
+
+    copy_memory_init_files(config, run_dir.as_posix())
+
+    assert (run_dir / "rom.dat").read_text() == "00\n01\n"
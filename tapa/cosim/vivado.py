@@ -44,8 +44,13 @@ def get_vivado_tcl(
     tb_rtl_path: str,
     save_waveform: bool,
     start_gui: bool,
+    scripts_only: bool = False,
 ) -> list[str]:
-    """Generate a Vivado TCL script for cosimulation."""
+    """Generate a Vivado TCL script for cosimulation.
+
+    If `scripts_only` is set, the script only generates the compile, elaborate,
+    and simulate scripts of xsim without running them.
+    """
     dpi_version = (
         "tapa_fast_cosim_dpi_xv"
         if get_vivado_version() >= "2024.2"
@@ -129,7 +134,10 @@ def get_vivado_tcl(
             r"-value {wave.wdb} -objects [get_filesets sim_1]"
         )
 
-    script.append(r"launch_simulation")
-    script.append(r"run all")
+    if scripts_only:
+        script.append(r"launch_simulation -scripts_only")
+    else:
+        script.append(r"launch_simulation")
+        script.append(r"run all")
 
     return script
@@ -416,6 +416,9 @@ class Port:
         self.width = as_type(int, obj["width"])
         self.chan_count = as_type_or_none(int, obj.get("chan_count"))
         self.chan_size = as_type_or_none(int, obj.get("chan_size"))
+        # only set for mmaps accessed in `[[tapa::burst]]` loops
+        self.burst_len = as_type_or_none(int, obj.get("burst_len"))
+        self.max_outstanding = as_type_or_none(int, obj.get("max_outstanding"))
 
     def __str__(self) -> str:
         return ", ".join(f"{k}: {v}" for k, v in self.__dict__.items())
@@ -50,6 +50,11 @@ class ProgramDirectoryInterface:
     def report_paths(self) -> ReportPaths:
         pass
 
+    @property
+    @abstractmethod
+    def job_history_path(self) -> str:
+        pass
+
     @abstractmethod
     def get_cpp_path(self, name: str) -> str:
         pass
@@ -108,6 +113,11 @@ class ProgramDirectoryMixin(ProgramDirectoryInterface):
             yaml=os.path.join(self.work_dir, "report.yaml"),
         )
 
+    @property
+    def job_history_path(self) -> str:
+        """Returns the path of the recorded durations and memory of tool jobs."""
+        return os.path.join(self.work_dir, "job_history.json")
+
     def get_cpp_path(self, name: str) -> str:
         return os.path.join(self.cpp_dir, name + ".cpp")
 
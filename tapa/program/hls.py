@@ -4,12 +4,11 @@ All rights reserved. The contributor(s) of this file has/have agreed to the
 RapidStream Contributor License Agreement.
 """
 
-import itertools
+import functools
 import logging
 import os
 import os.path
 import sys
-from concurrent import futures
 from typing import Literal
 
 from psutil import cpu_count
@@ -18,6 +17,13 @@ from tapa.backend.xilinx import RunAie, RunHls
 from tapa.common.paths import find_resource, get_xpfm_path
 from tapa.program.abc import ProgramInterface
 from tapa.program.directory import ProgramDirectoryInterface
+from tapa.program.hls_cache import (
+    get_hls_cache_key,
+    load_hls_result,
+    store_hls_result,
+)
+from tapa.program.hls_dedup import clone_hls_tarball, get_dedup_key
+from tapa.program.scheduler import JobScheduler
 from tapa.safety_check import check_mmap_arg_name
 from tapa.task import Task
 from tapa.util import clang_format
@@ -159,6 +165,21 @@ class ProgramHlsMixin(
             pass
         return False
 
+    def _get_hls_clones(self) -> dict[str, str]:
+        """Returns tasks whose HLS results can be cloned, and their sources."""
+        sources: dict[str, str] = {}
+        clones = {}
+        for task in self._tasks.values():
+            if task.name == self.top:
+                continue
+            key = get_dedup_key(task.name, task.code)
+            if key is None:
+                continue
+            source = sources.setdefault(key, task.name)
+            if source != task.name:
+                clones[task.name] = source
+        return clones
+
     def run_hls(  # noqa: PLR0913, PLR0917
         self,
         clock_period: str,
@@ -167,12 +188,24 @@ class ProgramHlsMixin(
         other_configs: str,
         jobs: int | None,
         keep_hls_work_dir: bool,
+        hls_cache_dir: str | None = None,
+        deduplicate: bool = True,
     ) -> None:
-        """Run HLS with extracted HLS C++ files and generate tarballs."""
+        """Run HLS with extracted HLS C++ files and generate tarballs.
+
+        If `hls_cache_dir` is not None, HLS results are looked up in and stored
+        to the directory, keyed by the content of the task and the HLS options.
+        If `deduplicate` is set, HLS runs once for tasks that differ only in
+        name, and the results are renamed for the others.
+        """
         self._extract_cpp("hls")
+        clones = self._get_hls_clones() if deduplicate else {}
+        tasks = [task for task in self._tasks.values() if task.name not in clones]
 
         _logger.info("running hls")
         work_dir = os.path.join(self.work_dir, "hls") if keep_hls_work_dir else None
+        jobs = jobs or cpu_count(logical=False)
+        scheduler = JobScheduler(self.job_history_path, "hls", jobs)
 
         def worker(task: Task, idx: int) -> None:
             _logger.info("start worker for %s, target: %s", task.name, task.target_type)
@@ -183,6 +216,23 @@ class ProgramHlsMixin(
             # WORKAROUND: Vitis HLS requires -I or gflags cannot be found...
             hls_includes = f"-I{find_resource('tapa-extra-runtime-include')}"
             hls_cflags = f"{self.cflags} {hls_defines} {hls_includes}"
+
+            cache_key = None
+            if hls_cache_dir is not None:
+                with open(self.get_cpp_path(task.name), encoding="utf-8") as fp:
+                    cache_key = get_hls_cache_key(
+                        task.name,
+                        fp.read(),
+                        f"{self.cflags} {hls_defines}",
+                        clock_period,
+                        part_num,
+                        other_configs,
+                    )
+                if load_hls_result(
+                    hls_cache_dir, cache_key, self.get_tar_path(task.name)
+                ):
+                    return
+
             with (
                 open(self.get_tar_path(task.name), "wb") as tarfileobj,
                 RunHls(
@@ -197,6 +247,7 @@ class ProgramHlsMixin(
                     std="c++14",
                     other_configs=other_configs,
                 ) as proc,
+                scheduler.track(task.name, proc),
             ):
                 stdout, stderr = proc.communicate()
 
@@ -213,12 +264,19 @@ class ProgramHlsMixin(
                 msg = f"HLS failed for {task.name}"
                 raise RuntimeError(msg)
 
-        jobs = jobs or cpu_count(logical=False)
+            if cache_key is not None:
+                store_hls_result(hls_cache_dir, cache_key, self.get_tar_path(task.name))
+
         _logger.info("spawn %d workers for parallel HLS synthesis of the tasks", jobs)
+        if clones:
+            _logger.info(
+                "skipping HLS for %d tasks identical to other tasks", len(clones)
+            )
 
         try:
-            with futures.ThreadPoolExecutor(max_workers=jobs) as executor:
-                any(executor.map(worker, self._tasks.values(), itertools.count(0)))
+            scheduler.run({
+                task.name: functools.partial(worker, task) for task in tasks
+            })
         except RuntimeError:
             if keep_hls_work_dir:
                 _logger.error(
@@ -233,6 +291,12 @@ class ProgramHlsMixin(
                 )
             sys.exit(1)
 
+        for name, source in clones.items():
+            _logger.info("reusing HLS result of %s for %s", source, name)
+            clone_hls_tarball(
+                self.get_tar_path(source), source, self.get_tar_path(name), name
+            )
+
     def run_aie(
         self,
         clock_period: str,
@@ -0,0 +1,119 @@
+"""Content-addressed cache of HLS results shared across builds."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import functools
+import hashlib
+import logging
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import tempfile
+from pathlib import Path
+
+from tapa import __version__
+from tapa.backend.xilinx import get_cmd_args
+
+_logger = logging.getLogger().getChild(__name__)
+
+# Options whose directory tapa-cpp searches for headers to inline.
+_INLINED_INCLUDE_OPTIONS = ("-I", "-iquote")
+
+
+@functools.cache
+def get_vitis_hls_version() -> str:
+    """Returns the version and builds reported by `vitis_hls -version`."""
+    kwargs = {}
+    cmd_args = get_cmd_args(
+        ["vitis_hls", "-version"], ["XILINX_HLS", "XILINX_VITIS"], kwargs
+    )
+    output = subprocess.check_output(
+        cmd_args, stderr=subprocess.STDOUT, text=True, **kwargs
+    )
+    # e.g., "... OpenCL v2024.2 (64-bit)" and "SW Build 5238294 on ..."
+    version = re.findall(r"\bv\d+\.\d+(?:\.\d+)?\b|\bBuild \d+\b", output)
+    if not version:
+        msg = f"failed to parse Vitis HLS version from:\n{output}"
+        raise ValueError(msg)
+    return " ".join(version)
+
+
+def normalize_cflags(cflags: str) -> str:
+    """Drops `-I` and `-iquote` directories from `cflags`.
+
+    tapa-cpp inlines headers found in those directories into the task code,
+    so the directories do not affect the HLS result beyond the code, and
+    checkouts at different paths can share cache entries. System include
+    directories are kept since their headers are not inlined.
+    """
+    normalized = []
+    args = iter(shlex.split(cflags))
+    for arg in args:
+        if arg in _INLINED_INCLUDE_OPTIONS:
+            next(args, None)
+        elif not arg.startswith(_INLINED_INCLUDE_OPTIONS):
+            normalized.append(arg)
+    return shlex.join(normalized)
+
+
+def get_hls_cache_key(  # noqa: PLR0913,PLR0917
+    task_name: str,
+    code: str,
+    cflags: str,
+    clock_period: str,
+    part_num: str,
+    other_configs: str,
+) -> str:
+    """Returns the cache key of the HLS result of a task.
+
+    The key covers everything the HLS result depends on: the task `code` after
+    tapacc, which has user headers expanded, the HLS options, and the versions
+    of TAPA and Vitis HLS.
+    """
+    digest = hashlib.sha256()
+    for field in (
+        __version__,
+        get_vitis_hls_version(),
+        task_name,
+        normalize_cflags(cflags),
+        str(clock_period),
+        part_num,
+        other_configs,
+        code,
+    ):
+        digest.update(f"{len(field)}\0".encode())
+        digest.update(field.encode())
+    return digest.hexdigest()
+
+
+def load_hls_result(cache_dir: str, key: str, tar_path: str) -> bool:
+    """Copies the cached HLS tarball of `key` to `tar_path`, if any."""
+    cached_path = Path(cache_dir) / f"{key}.tar"
+    try:
+        shutil.copyfile(cached_path, tar_path)
+    except FileNotFoundError:
+        return False
+    _logger.info("reusing cached HLS result %s", cached_path)
+    return True
+
+
+def store_hls_result(cache_dir: str, key: str, tar_path: str) -> None:
+    """Stores the HLS tarball at `tar_path` as the cached result of `key`.
+
+    The tarball is published atomically so that concurrent builds sharing the
+    cache directory never see a partial result.
+    """
+    Path(cache_dir).mkdir(parents=True, exist_ok=True)
+    with (
+        open(tar_path, "rb") as src,
+        tempfile.NamedTemporaryFile(dir=cache_dir, suffix=".tmp", delete=False) as fp,
+    ):
+        shutil.copyfileobj(src, fp)
+    os.replace(fp.name, Path(cache_dir) / f"{key}.tar")
+    _logger.debug("cached HLS result %s", tar_path)
@@ -0,0 +1,134 @@
+"""Unit tests for tapa.program.hls_cache."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import subprocess
+from pathlib import Path
+
+import pytest
+
+from tapa.program import hls_cache
+from tapa.program.hls_cache import (
+    get_hls_cache_key,
+    get_vitis_hls_version,
+    load_hls_result,
+    normalize_cflags,
+    store_hls_result,
+)
+
+_VERSION_OUTPUT = """
+****** Vitis HLS - High-Level Synthesis from C, C++ and OpenCL v2024.2 (64-bit)
+  **** SW Build 5238294 on Nov  8 2024
+  **** IP Build 5239520 on Sun Nov 10 16:12:51 MST 2024
+    ** Copyright 1986-2022 Xilinx, Inc. All Rights Reserved.
+"""
+
+_KEY_ARGS = {
+    "task_name": "Add",
+    "code": "void Add(tapa::istream<int>& in) { in.read(); }",
+    "cflags": "-I/home/a/proj/include -isystem /opt/tapa/include -DN=4",
+    "clock_period": "3.33",
+    "part_num": "xcu250-figd2104-2L-e",
+    "other_configs": "",
+}
+
+
+@pytest.fixture(autouse=True)
+def vitis_hls_version(monkeypatch: pytest.MonkeyPatch) -> None:
+    monkeypatch.setattr(hls_cache, "get_vitis_hls_version", lambda: "v2024.2")
+
+
+def test_vitis_hls_version_is_parsed(monkeypatch: pytest.MonkeyPatch) -> None:
+    monkeypatch.delenv("XILINX_HLS", raising=False)
+    monkeypatch.delenv("XILINX_VITIS", raising=False)
+    commands = []
+
+    def check_output(cmd_args: list[str], **_: object) -> str:
+        commands.append(cmd_args)
+        return _VERSION_OUTPUT
+
+    monkeypatch.setattr(subprocess, "check_output", check_output)
+    get_vitis_hls_version.cache_clear()
+    try:
+        version = get_vitis_hls_version()
+    finally:
+        get_vitis_hls_version.cache_clear()
+
+    assert commands == [["vitis_hls", "-version"]]
+    assert version == "v2024.2 Build 5238294 Build 5239520"
+
+
+def test_vitis_hls_version_fails_on_unknown_output(
+    monkeypatch: pytest.MonkeyPatch,
+) -> None:
+    monkeypatch.setattr(subprocess, "check_output", lambda *_, **__: "vitis_hls")
+    get_vitis_hls_version.cache_clear()
+    try:
+        with pytest.raises(ValueError, match="failed to parse Vitis HLS version"):
+            get_vitis_hls_version()
+    finally:
+        get_vitis_hls_version.cache_clear()
+
+
+def test_normalize_cflags_drops_inlined_include_dirs() -> None:
+    assert (
+        normalize_cflags(
+            "-I/a/include -I /b/include -iquote /c -iquote/d -isystem /opt/tapa"
+            " -include config.h -DN=4 -std=c++14"
+        )
+        == "-isystem /opt/tapa -include config.h -DN=4 -std=c++14"
+    )
+
+
+def test_key_is_stable_across_include_paths() -> None:
+    key = get_hls_cache_key(**_KEY_ARGS)
+    assert key == get_hls_cache_key(**_KEY_ARGS)
+    cflags = "-I /work/b/include -isystem /opt/tapa/include -DN=4"
+    assert key == get_hls_cache_key(**(_KEY_ARGS | {"cflags": cflags}))
+
+
+@pytest.mark.parametrize(
+    ("field", "value"),
+    [
+        ("task_name", "Sub"),
+        ("code", "void Add(tapa::istream<int>& in) { in.read(); in.read(); }"),
+        ("cflags", "-I/home/a/proj/include -isystem /opt/tapa/include -DN=8"),
+        ("cflags", "-I/home/a/proj/include -isystem /opt/other -DN=4"),
+        ("clock_period", "4"),
+        ("part_num", "xcu280-fsvh2892-2L-e"),
+        ("other_configs", "config_compile -pipeline_loops 0"),
+    ],
+)
+def test_key_covers_inputs(field: str, value: str) -> None:
+    assert get_hls_cache_key(**_KEY_ARGS) != get_hls_cache_key(
+        **(_KEY_ARGS | {field: value})
+    )
+
+
+def test_key_covers_tool_versions(monkeypatch: pytest.MonkeyPatch) -> None:
+    key = get_hls_cache_key(**_KEY_ARGS)
+
+    monkeypatch.setattr(hls_cache, "get_vitis_hls_version", lambda: "v2025.1")
+    assert key != get_hls_cache_key(**_KEY_ARGS)
+
+    monkeypatch.setattr(hls_cache, "get_vitis_hls_version", lambda: "v2024.2")
+    monkeypatch.setattr(hls_cache, "__version__", "0.0.0")
+    assert key != get_hls_cache_key(**_KEY_ARGS)
+
+
+def test_results_are_stored_and_loaded(tmp_path: Path) -> None:
+    cache_dir = (tmp_path / "cache").as_posix()
+    tar_path = tmp_path / "Add.tar"
+    assert not load_hls_result(cache_dir, "key", tar_path.as_posix())
+
+    tar_path.write_bytes(b"hls result")
+    store_hls_result(cache_dir, "key", tar_path.as_posix())
+    tar_path.unlink()
+
+    assert load_hls_result(cache_dir, "key", tar_path.as_posix())
+    assert tar_path.read_bytes() == b"hls result"
+    assert [x.name for x in (tmp_path / "cache").iterdir()] == ["key.tar"]
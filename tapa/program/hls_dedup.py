@@ -0,0 +1,131 @@
+"""Deduplication of HLS runs for tasks that differ only in name."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import copy
+import hashlib
+import io
+import re
+import tarfile
+
+_BRACKETS = {"(": ")", "{": "}"}
+
+
+def get_dedup_key(name: str, code: str) -> str | None:
+    """Returns a key that is equal for tasks whose HLS results differ only in name.
+
+    `code` is the code of task `name` generated by tapacc, in which the other
+    tasks are declared without bodies. Tasks with the same key have the same
+    parameters and body at different locations of the same file, so running HLS
+    for one of them and renaming the result gives the results of the others.
+
+    Returns None if the task cannot be deduplicated, e.g., if its name is used
+    in its parameters or body, where renaming could change the ports.
+    """
+    definition = _find_definition(name, code)
+    if definition is None:
+        return None
+    params_begin, body_begin, body_end = definition
+    params = code[params_begin:body_begin]
+    body = code[body_begin:body_end]
+    if _get_name_pattern(name).search(params + body):
+        return None
+
+    # Other tasks are declared as `name(params) ;` in place of their bodies.
+    context = f"{code[:body_begin]};{code[body_end:]}"
+    digest = hashlib.sha256()
+    for field in (context, params, body):
+        digest.update(f"{len(field)}\0".encode())
+        digest.update(field.encode())
+    return digest.hexdigest()
+
+
+def clone_hls_tarball(
+    src_path: str, src_name: str, dst_path: str, dst_name: str
+) -> None:
+    """Writes the HLS tarball of `src_name` as if it were generated for `dst_name`.
+
+    The task name is renamed in file names and contents, including the module
+    name prefixes added by HLS.
+    """
+    name_pattern = _get_name_pattern(src_name)
+    data_pattern = re.compile(name_pattern.pattern.encode())
+    with tarfile.open(src_path) as src, tarfile.open(dst_path, "w") as dst:
+        for member in src.getmembers():
+            cloned = copy.copy(member)
+            cloned.name = name_pattern.sub(dst_name, member.name)
+            fileobj = None
+            if member.isfile():
+                extracted = src.extractfile(member)
+                assert extracted is not None
+                data = data_pattern.sub(dst_name.encode(), extracted.read())
+                cloned.size = len(data)
+                fileobj = io.BytesIO(data)
+            dst.addfile(cloned, fileobj)
+
+
+def _get_name_pattern(name: str) -> re.Pattern[str]:
+    """Matches `name` as an identifier or an identifier prefix before `_`."""
+    return re.compile(rf"(?<![A-Za-z0-9_$]){re.escape(name)}(?![A-Za-z0-9$])")
+
+
+def _find_definition(name: str, code: str) -> tuple[int, int, int] | None:
+    """Returns the ranges of the parameters and body of function `name`.
+
+    Returns None unless there is exactly one definition.
+    """
+    definitions = []
+    for match in re.finditer(rf"(?<![A-Za-z0-9_$]){re.escape(name)}\s*\(", code):
+        params_begin = match.end() - 1
+        params_end = _find_closing(code, params_begin)
+        if params_end is None:
+            return None
+        body_begin = params_end
+        while body_begin < len(code) and code[body_begin].isspace():
+            body_begin += 1
+        if code.startswith("{", body_begin):
+            body_end = _find_closing(code, body_begin)
+            if body_end is None:
+                return None
+            definitions.append((params_begin, body_begin, body_end))
+    if len(definitions) != 1:
+        return None
+    return definitions[0]
+
+
+def _find_closing(code: str, begin: int) -> int | None:
+    """Returns the index after the bracket that closes `code[begin]`.
+
+    Comments and string and character literals are skipped.
+    """
+    opening = code[begin]
+    closing = _BRACKETS[opening]
+    depth = 0
+    i = begin
+    while i < len(code):
+        if code.startswith("//", i):
+            i = code.find("\n", i)
+            if i < 0:
+                return None
+        elif code.startswith("/*", i):
+            i = code.find("*/", i)
+            if i < 0:
+                return None
+            i += 1
+        elif code[i] in "\"'":
+            quote = code[i]
+            i += 1
+            while i < len(code) and code[i] != quote:
+                i += 2 if code[i] == "\\" else 1
+        elif code[i] == opening:
+            depth += 1
+        elif code[i] == closing:
+            depth -= 1
+            if depth == 0:
+                return i + 1
+        i += 1
+    return None
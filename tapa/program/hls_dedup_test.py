@@ -0,0 +1,77 @@
+"""Unit tests for tapa.program.hls_dedup."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import io
+import tarfile
+from pathlib import Path
+
+from tapa.program.hls_dedup import clone_hls_tarball, get_dedup_key
+
+_CODE = """
+#include <tapa.h>
+void PeA(tapa::istream<int>& in, tapa::ostream<int>& out) {BODY_A}
+void PeB(tapa::istream<int>& in, tapa::ostream<int>& out) {BODY_B}
+"""
+
+
+def _get_code(task: str, body: str) -> str:
+    body_a = body if task == "PeA" else ";"
+    body_b = body if task == "PeB" else ";"
+    # tapacc replaces the bodies of other tasks with `;`.
+    return _CODE.replace("{BODY_A}", body_a).replace("{BODY_B}", body_b)
+
+
+def test_identical_tasks_have_the_same_key() -> None:
+    body = "{\n  // '}'\n  out.write(in.read() + '}');\n}"
+
+    key_a = get_dedup_key("PeA", _get_code("PeA", body))
+    key_b = get_dedup_key("PeB", _get_code("PeB", body))
+
+    assert key_a is not None
+    assert key_a == key_b
+
+
+def test_different_tasks_have_different_keys() -> None:
+    key_a = get_dedup_key("PeA", _get_code("PeA", "{ out.write(in.read()); }"))
+    key_b = get_dedup_key("PeB", _get_code("PeB", "{ out.write(-in.read()); }"))
+
+    assert key_a != key_b
+
+
+def test_task_using_its_name_is_not_deduplicated() -> None:
+    code = _get_code("PeA", "{ int PeA_count = in.read(); out.write(PeA_count); }")
+
+    assert get_dedup_key("PeA", code) is None
+
+
+def test_clone_hls_tarball_renames_task(tmp_path: Path) -> None:
+    src_path = tmp_path / "PeA.tar"
+    dst_path = tmp_path / "PeB.tar"
+    files = {
+        "hdl/PeA.v": b"module PeA; PeA_sub PeA_sub_U0(); endmodule  // xPeA",
+        "hdl/PeA_sub.v": b"module PeA_sub; endmodule",
+        "report/PeA/PeA_csynth.xml": b"<TopModelName>PeA</TopModelName>",
+    }
+    with tarfile.open(src_path, "w") as tar:
+        for name, data in files.items():
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            tar.addfile(info, io.BytesIO(data))
+
+    clone_hls_tarball(str(src_path), "PeA", str(dst_path), "PeB")
+
+    with tarfile.open(dst_path) as tar:
+        cloned = {
+            member.name: tar.extractfile(member).read()  # type: ignore[union-attr]
+            for member in tar.getmembers()
+        }
+    assert cloned == {
+        "hdl/PeB.v": b"module PeB; PeB_sub PeB_sub_U0(); endmodule  // xPeA",
+        "hdl/PeB_sub.v": b"module PeB_sub; endmodule",
+        "report/PeB/PeB_csynth.xml": b"<TopModelName>PeB</TopModelName>",
+    }
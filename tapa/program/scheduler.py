@@ -0,0 +1,199 @@
+"""Scheduling of parallel tool jobs using their historical costs."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import json
+import logging
+import os
+import subprocess
+import threading
+import time
+from collections.abc import Callable, Iterator, Mapping
+from concurrent import futures
+from contextlib import contextmanager
+from typing import NamedTuple, TypeVar
+
+import psutil
+
+_logger = logging.getLogger().getChild(__name__)
+
+_T = TypeVar("_T")
+
+# Interval of sampling the memory usage of running jobs.
+_MEMORY_SAMPLING_SECONDS = 1.0
+
+# Fraction of the available memory that jobs may use together.
+_MEMORY_BUDGET_RATIO = 0.9
+
+
+class JobRecord(NamedTuple):
+    seconds: float
+    peak_memory_bytes: int
+
+
+class JobScheduler:
+    """Runs named jobs in parallel, longest first, within a memory budget.
+
+    The duration and peak memory of each job are recorded in a JSON file under
+    `kind`, e.g., `hls`, and used to schedule the same jobs in later runs. Jobs
+    without history are started first, since they may be long. A job is only
+    started if the recorded peak memory of the running jobs and itself fits in
+    the available memory; at least one job always runs.
+    """
+
+    def __init__(self, history_path: str, kind: str, max_workers: int) -> None:
+        self._history_path = history_path
+        self._kind = kind
+        self._max_workers = max_workers
+        self._lock = threading.Lock()
+        self._history: dict[str, dict[str, dict[str, float]]] = {}
+        try:
+            with open(history_path, encoding="utf-8") as fp:
+                self._history = json.load(fp)
+        except (OSError, ValueError):
+            pass
+
+    def get_record(self, name: str) -> JobRecord | None:
+        """Returns the recorded cost of job `name`, if any."""
+        record = self._history.get(self._kind, {}).get(name)
+        if record is None:
+            return None
+        return JobRecord(
+            seconds=float(record["seconds"]),
+            peak_memory_bytes=int(record["peak_memory_bytes"]),
+        )
+
+    @contextmanager
+    def track(self, name: str, proc: subprocess.Popen) -> Iterator[None]:
+        """Records the duration and peak memory of `proc` as the cost of `name`.
+
+        The memory of `proc` and all its descendants is sampled until the
+        context exits. Nothing is recorded if `proc` fails.
+        """
+        start = time.monotonic()
+        peak_memory = 0
+        stopped = threading.Event()
+
+        def sample() -> None:
+            nonlocal peak_memory
+            while not stopped.is_set():
+                peak_memory = max(peak_memory, _get_tree_memory(proc.pid))
+                stopped.wait(_MEMORY_SAMPLING_SECONDS)
+
+        sampler = threading.Thread(target=sample, daemon=True)
+        sampler.start()
+        try:
+            yield
+        finally:
+            stopped.set()
+            sampler.join()
+        if proc.returncode == 0:
+            with self._lock:
+                self._history.setdefault(self._kind, {})[name] = {
+                    "seconds": time.monotonic() - start,
+                    "peak_memory_bytes": peak_memory,
+                }
+
+    def run(self, jobs: Mapping[str, Callable[[int], _T]]) -> dict[str, _T]:
+        """Runs `jobs` and returns their results.
+
+        Each job is called with the number of jobs started before it. If a job
+        raises, no more jobs are started and the exception is re-raised after
+        the running jobs finish. The history is saved in any case.
+        """
+        pending = self._sort(jobs)
+        budget = int(psutil.virtual_memory().available * _MEMORY_BUDGET_RATIO)
+        # Jobs without history are assumed to be as large as the largest known.
+        default_memory = max(
+            (x.peak_memory_bytes for x in map(self.get_record, jobs) if x), default=0
+        )
+        memory = {
+            name: record.peak_memory_bytes if record else default_memory
+            for name, record in zip(pending, map(self.get_record, pending))
+        }
+        running: dict[futures.Future[_T], str] = {}
+        results: dict[str, _T] = {}
+        error: Exception | None = None
+        started = 0
+
+        try:
+            with futures.ThreadPoolExecutor(max_workers=self._max_workers) as pool:
+                while pending or running:
+                    while error is None and len(running) < self._max_workers:
+                        reserved = sum(memory[x] for x in running.values())
+                        name = _pop_first_fitting(
+                            pending, memory, budget - reserved, force=not running
+                        )
+                        if name is None:
+                            break
+                        _logger.debug("starting job %s", name)
+                        running[pool.submit(jobs[name], started)] = name
+                        started += 1
+                    if not running:
+                        break
+
+                    done, _ = futures.wait(
+                        running, return_when=futures.FIRST_COMPLETED
+                    )
+                    for future in done:
+                        name = running.pop(future)
+                        try:
+                            results[name] = future.result()
+                        except Exception as e:  # noqa: BLE001
+                            error = error or e
+        finally:
+            self._save()
+
+        if error is not None:
+            raise error
+        return results
+
+    def _sort(self, jobs: Mapping[str, object]) -> list[str]:
+        """Returns job names, unknown jobs first and then the longest first."""
+
+        def priority(name: str) -> tuple[bool, float]:
+            record = self.get_record(name)
+            return record is not None, -record.seconds if record else 0.0
+
+        return sorted(jobs, key=priority)
+
+    def _save(self) -> None:
+        with self._lock:
+            tmp_path = f"{self._history_path}.tmp"
+            with open(tmp_path, "w", encoding="utf-8") as fp:
+                json.dump(self._history, fp, indent=2, sort_keys=True)
+            os.replace(tmp_path, self._history_path)
+
+
+def _pop_first_fitting(
+    pending: list[str], memory: Mapping[str, int], budget: int, force: bool
+) -> str | None:
+    """Removes and returns the first pending job that fits in `budget`.
+
+    If `force`, the first pending job is returned even if it does not fit.
+    """
+    for idx, name in enumerate(pending):
+        if force or memory[name] <= budget:
+            del pending[idx]
+            return name
+    return None
+
+
+def _get_tree_memory(pid: int) -> int:
+    """Returns the resident memory of process `pid` and its descendants."""
+    try:
+        process = psutil.Process(pid)
+        processes = [process, *process.children(recursive=True)]
+    except psutil.Error:
+        return 0
+    memory = 0
+    for process in processes:
+        try:
+            memory += process.memory_info().rss
+        except psutil.Error:
+            pass
+    return memory
@@ -0,0 +1,103 @@
+"""Unit tests for tapa.program.scheduler."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import functools
+import json
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+import pytest
+
+from tapa.program.scheduler import JobScheduler
+
+_TIB = 1 << 40
+
+
+def _write_history(path: Path, history: dict[str, tuple[float, int]]) -> None:
+    path.write_text(
+        json.dumps({
+            "hls": {
+                name: {"seconds": seconds, "peak_memory_bytes": memory}
+                for name, (seconds, memory) in history.items()
+            }
+        })
+    )
+
+
+def test_run_starts_longest_jobs_first(tmp_path: Path) -> None:
+    history_path = tmp_path / "history.json"
+    _write_history(history_path, {"short": (1.0, 0), "long": (100.0, 0)})
+    scheduler = JobScheduler(str(history_path), "hls", max_workers=1)
+    order = []
+
+    def job(name: str, idx: int) -> int:
+        order.append(name)
+        return idx
+
+    results = scheduler.run({
+        name: functools.partial(job, name) for name in ("short", "long", "new")
+    })
+
+    assert order == ["new", "long", "short"]
+    assert results == {"new": 0, "long": 1, "short": 2}
+
+
+def test_run_serializes_jobs_exceeding_memory_budget(tmp_path: Path) -> None:
+    history_path = tmp_path / "history.json"
+    _write_history(history_path, {"a": (1.0, 1024 * _TIB), "b": (1.0, 1024 * _TIB)})
+    scheduler = JobScheduler(str(history_path), "hls", max_workers=2)
+    running = 0
+    max_running = 0
+
+    def job(idx: int) -> None:
+        nonlocal running, max_running
+        running += 1
+        max_running = max(max_running, running)
+        time.sleep(0.1)
+        running -= 1
+        del idx
+
+    scheduler.run({"a": job, "b": job})
+
+    assert max_running == 1
+
+
+def test_run_reraises_job_error(tmp_path: Path) -> None:
+    scheduler = JobScheduler(str(tmp_path / "history.json"), "hls", max_workers=2)
+
+    def job(idx: int) -> None:
+        msg = f"job {idx} failed"
+        raise RuntimeError(msg)
+
+    with pytest.raises(RuntimeError):
+        scheduler.run({"a": job})
+
+
+def test_track_records_successful_jobs(tmp_path: Path) -> None:
+    history_path = tmp_path / "history.json"
+    scheduler = JobScheduler(str(history_path), "hls", max_workers=1)
+
+    def job(args: list[str], idx: int) -> None:
+        del idx
+        with subprocess.Popen(args) as proc, scheduler.track(args[-1], proc):
+            proc.communicate()
+
+    scheduler.run({
+        "ok": functools.partial(job, [sys.executable, "-c", "pass", "ok"]),
+        "failed": functools.partial(
+            job, [sys.executable, "-c", "exit(1)", "failed"]
+        ),
+    })
+
+    reloaded = JobScheduler(str(history_path), "hls", max_workers=1)
+    record = reloaded.get_record("ok")
+    assert record is not None
+    assert record.seconds > 0
+    assert reloaded.get_record("failed") is None
@@ -4,11 +4,10 @@ All rights reserved. The contributor(s) of this file has/have agreed to the
 RapidStream Contributor License Agreement.
 """
 
-import itertools
+import functools
 import logging
 import os
 import sys
-from concurrent import futures
 
 import psutil
 
@@ -19,6 +18,7 @@ from tapa.backend.report.xilinx.rtl.parser import (
 )
 from tapa.program.abc import ProgramInterface
 from tapa.program.directory import ProgramDirectoryInterface
+from tapa.program.scheduler import JobScheduler
 
 _logger = logging.getLogger().getChild(__name__)
 
@@ -40,6 +40,8 @@ class ProgramSynthesisMixin(
             part_num (str): Part number of the target device.
             jobs (int | None): Number of parallel jobs. If None, infer from core count.
         """
+        worker_num = jobs or psutil.cpu_count(logical=False) or 8
+        scheduler = JobScheduler(self.job_history_path, "synth", worker_num)
 
         def worker(module_name: str, idx: int) -> HierarchicalUtilization:
             _logger.debug("synthesizing %s", module_name)
@@ -52,13 +54,16 @@ class ProgramSynthesisMixin(
             # generate report if and only if C++ source is newer than report.
             if os.path.getmtime(self.get_cpp_path(module_name)) > rpt_path_mtime:
                 os.nice(idx % 19)
-                with ReportDirUtil(
-                    self.rtl_dir,
-                    rpt_path,
-                    module_name,
-                    part_num,
-                    synth_kwargs={"mode": "out_of_context"},
-                ) as proc:
+                with (
+                    ReportDirUtil(
+                        self.rtl_dir,
+                        rpt_path,
+                        module_name,
+                        part_num,
+                        synth_kwargs={"mode": "out_of_context"},
+                    ) as proc,
+                    scheduler.track(module_name, proc),
+                ):
                     stdout, stderr = proc.communicate()
 
                 # err if output report does not exist or is not newer than previous
@@ -74,7 +79,6 @@ class ProgramSynthesisMixin(
             with open(rpt_path, encoding="utf-8") as rpt_file:
                 return parse_hierarchical_utilization_report(rpt_file)
 
-        worker_num = jobs or psutil.cpu_count(logical=False) or 8
         _logger.info("generating post-synthesis resource utilization reports")
         _logger.info(
             "this step runs logic synthesis of each task "
@@ -84,18 +88,17 @@ class ProgramSynthesisMixin(
             "spawn %d workers for parallel logic synthesis",
             worker_num,
         )
-        with futures.ThreadPoolExecutor(max_workers=worker_num) as executor:
-            for utilization in executor.map(
-                worker,
-                {x.task.name for x in self.top_task.instances},
-                itertools.count(0),
-            ):
-                # override self_area populated from HLS report
-                bram = int(utilization["RAMB36"]) * 2 + int(utilization["RAMB18"])
-                self.get_task(utilization.instance).total_area = {
-                    "BRAM_18K": bram,
-                    "DSP": int(utilization["DSP Blocks"]),
-                    "FF": int(utilization["FFs"]),
-                    "LUT": int(utilization["Total LUTs"]),
-                    "URAM": int(utilization["URAM"]),
-                }
+        modules = dict.fromkeys(x.task.name for x in self.top_task.instances)
+        utilizations = scheduler.run({
+            name: functools.partial(worker, name) for name in modules
+        })
+        for utilization in utilizations.values():
+            # override self_area populated from HLS report
+            bram = int(utilization["RAMB36"]) * 2 + int(utilization["RAMB18"])
+            self.get_task(utilization.instance).total_area = {
+                "BRAM_18K": bram,
+                "DSP": int(utilization["DSP Blocks"]),
+                "FF": int(utilization["FFs"]),
+                "LUT": int(utilization["Total LUTs"]),
+                "URAM": int(utilization["URAM"]),
+            }
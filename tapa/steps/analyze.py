@@ -19,6 +19,7 @@ from pathlib import Path
 
 import click
 
+from tapa import __version__
 from tapa.common.graph import Graph as TapaGraph
 from tapa.common.paths import find_resource, get_system_cflags, get_tapacc_cflags
 from tapa.common.target import Target
@@ -79,12 +80,22 @@ _logger = logging.getLogger().getChild(__name__)
     help="Target flow of TAPA compiler, default to `xilinx-vitis`.",
     default=Target.XILINX_VITIS.value,
 )
+@click.option(
+    "--perf-lint",
+    is_flag=True,
+    default=False,
+    help=(
+        "Warn about code patterns that limit the throughput of tasks, such as "
+        "stream accesses in loops that are not pipelined."
+    ),
+)
 def analyze(
     input_files: tuple[str, ...],
     top: str,
     cflags: tuple[str, ...],
     flatten_hierarchy: bool,
     target: str,
+    perf_lint: bool,
 ) -> None:
     """Analyze TAPA program and store the program description."""
     tapacc = find_clang_binary("tapacc-binary")
@@ -109,8 +120,13 @@ def analyze(
         top,
         all_cflags,
         target,
+        cache_dir=os.path.join(work_dir, "tapacc", __version__),
+        output_dir=os.path.join(work_dir, "tapacc", "tasks"),
+        jobs=os.cpu_count() or 1,
+        perf_lint=perf_lint,
     )
     graph_dict["cflags"] = cflags
+    log_changed_tasks(os.path.join(work_dir, "graph.json"), graph_dict)
 
     # Flatten the graph if flatten_hierarchy is set
     tapa_graph = TapaGraph(None, graph_dict)
@@ -296,6 +312,10 @@ def run_tapacc(
     top: str,
     cflags: tuple[str, ...],
     target: str,
+    cache_dir: str | None = None,
+    output_dir: str | None = None,
+    jobs: int = 1,
+    perf_lint: bool = False,
 ) -> dict:
     """Execute tapacc and return the program description.
 
@@ -305,6 +325,12 @@ def run_tapacc(
       top: Top task name.
       cflags: User specified CFLAGS with TAPA specific headers.
       target: Target flow of TAPA compiler, e.g., `xilinx-vitis`.
+      cache_dir: Directory to cache the output of each task by its fingerprint,
+        so that unchanged tasks are reused instead of rewritten.
+      output_dir: Directory for tapacc to write each task to, instead of
+        printing all tasks as a single document.
+      jobs: Number of tapacc worker processes generating tasks in parallel.
+      perf_lint: Whether tapacc warns about code patterns limiting throughput.
 
     Returns:
       Output description of the TAPA program.
@@ -314,6 +340,11 @@ def run_tapacc(
         top,
         "--target",
         target,
+        *(("-cache-dir", cache_dir) if cache_dir is not None else ()),
+        *(("-output-dir", output_dir) if output_dir is not None else ()),
+        "-jobs",
+        str(jobs),
+        *(("-perf-lint",) if perf_lint else ()),
         "--",
         *cflags,
         "-DTAPA_TARGET_DEVICE_",
@@ -323,4 +354,40 @@ def run_tapacc(
     quoted_cmd = " ".join(f'"{arg}"' if " " in arg else arg for arg in tapacc_cmd)
     _logger.info("running tapacc command: %s", quoted_cmd)
 
-    return json.loads(run_and_check(tapacc_cmd))
+    if output_dir is None:
+        return json.loads(run_and_check(tapacc_cmd))
+
+    # Remove tasks of previous runs, which may no longer exist.
+    shutil.rmtree(output_dir, ignore_errors=True)
+    program = json.loads(run_and_check(tapacc_cmd))
+    for name, path in program["tasks"].items():
+        with open(path, encoding="utf-8") as fp:
+            program["tasks"][name] = json.load(fp)
+    return program
+
+
+def log_changed_tasks(old_graph_path: str, graph: dict) -> list[str]:
+    """Logs and returns tasks whose fingerprints differ from the old graph.
+
+    Unchanged tasks have the same code and metadata as in the previous run, so
+    the downstream steps can reuse their results.
+    """
+    try:
+        with open(old_graph_path, encoding="utf-8") as fp:
+            old_tasks = json.load(fp)["tasks"]
+    except (OSError, ValueError, KeyError):
+        return list(graph["tasks"])
+
+    changed_tasks = [
+        name
+        for name, task in graph["tasks"].items()
+        if task.get("fingerprint") is None
+        or task.get("fingerprint") != old_tasks.get(name, {}).get("fingerprint")
+    ]
+    _logger.info(
+        "%d of %d tasks changed since the last analysis: %s",
+        len(changed_tasks),
+        len(graph["tasks"]),
+        ", ".join(changed_tasks) or "none",
+    )
+    return changed_tasks
@@ -60,6 +60,24 @@ from tapa.steps.common import (
         "This can lead to incorrect results; use at your own risk."
     ),
 )
+@click.option(
+    "--hls-cache-dir",
+    type=click.Path(file_okay=False),
+    default=None,
+    help=(
+        "Cache HLS results in this directory, keyed by the content of each task "
+        "and the HLS options, and reuse them across builds and work directories."
+    ),
+)
+@click.option(
+    "--deduplicate-hls / --no-deduplicate-hls",
+    type=bool,
+    default=True,
+    help=(
+        "Run HLS once for tasks that differ only in name, e.g., copies of a "
+        "processing element, and rename the results for the others."
+    ),
+)
 @click.option(
     "--other-hls-configs",
     type=str,
@@ -79,6 +97,16 @@ from tapa.steps.common import (
     default="",
     help="If non-empty, overrides the schema version in generated reports.",
 )
+@click.option(
+    "--enable-perf-counters / --disable-perf-counters",
+    type=bool,
+    default=False,
+    help=(
+        "Count busy and blocked cycles of each task instance and full and empty "
+        "cycles of each FIFO in the top-level task, readable as `s_axi_control` "
+        "registers.  Requires the Vitis target."
+    ),
+)
 @click.option(
     "--nonpipeline-fifos",
     type=click.Path(dir_okay=False, writable=True),
@@ -124,9 +152,12 @@ def synth(  # noqa: PLR0913,PLR0917
     jobs: int | None,
     keep_hls_work_dir: bool,
     skip_hls_based_on_mtime: bool,
+    hls_cache_dir: str | None,
+    deduplicate_hls: bool,
     other_hls_configs: str,
     enable_synth_util: bool,
     override_report_schema_version: str,
+    enable_perf_counters: bool,
     nonpipeline_fifos: Path | None,
     gen_ab_graph: bool,
     gen_graphir: bool,
@@ -174,11 +205,13 @@ def synth(  # noqa: PLR0913,PLR0917
             other_hls_configs,
             jobs,
             keep_hls_work_dir,
+            hls_cache_dir,
+            deduplicate_hls,
         )
         program.generate_task_rtl()
         if enable_synth_util:
             program.generate_post_synth_util(part_num, jobs)
-        program.generate_top_rtl(override_report_schema_version)
+        program.generate_top_rtl(override_report_schema_version, enable_perf_counters)
 
         if nonpipeline_fifos:
             with open(nonpipeline_fifos, encoding="utf-8") as fifo_file:
@@ -575,6 +575,53 @@ endmodule
             if module_name.startswith(prefix) and module_name.endswith(suffix):
                 self._rewriter.remove(instance.sourceRange)
 
+    def rewire_instance(self, instance_name: str, port_to_arg: dict[str, str]) -> None:
+        """Reconnects named ports of an existing instance to new arguments.
+
+        Args:
+          instance_name (str): Name of the instance.
+          port_to_arg (dict[str, str]): New argument of each port to reconnect.
+
+        Raises:
+          ValueError: Module does not have the instance or the instance does not
+            connect all the ports.
+        """
+        # Parse pending edits so that added instances can be rewired.
+        self._syntax_tree = self._rewriter.commit()
+        self._parse_syntax_tree()
+        remaining_ports = set(port_to_arg)
+        for instantiation in self._instances:
+            for instance in instantiation.instances:
+                if (
+                    not isinstance(instance, pyslang.HierarchicalInstanceSyntax)
+                    or instance.decl.name.valueText != instance_name
+                ):
+                    continue
+                for connection in instance.connections:
+                    if (
+                        not isinstance(connection, pyslang.NamedPortConnectionSyntax)
+                        or connection.expr is None
+                        or connection.name.valueText not in remaining_ports
+                    ):
+                        continue
+                    port = connection.name.valueText
+                    remaining_ports.remove(port)
+                    # Additions at the start of a removed range are dropped.
+                    self._rewriter.remove(connection.expr.sourceRange)
+                    self._rewriter.add_before(
+                        connection.expr.sourceRange.end, [port_to_arg[port]]
+                    )
+                if remaining_ports:
+                    msg = (
+                        f"instance {instance_name} in module {self.name} does not "
+                        f"connect ports {sorted(remaining_ports)}"
+                    )
+                    raise ValueError(msg)
+                return
+
+        msg = f"no instance {instance_name} found in module {self.name}"
+        raise ValueError(msg)
+
     def add_rs_pragmas(self) -> "Module":
         """Add RapidStream pragmas for existing ports.
 
@@ -451,6 +451,33 @@ def test_del_instances_succeeds() -> None:
     assert "bar" not in module.code
 
 
+@pytest.mark.usefixtures("options")
+def test_rewire_instance_succeeds() -> None:
+    module = Module(name="foo")
+    module.add_instance(
+        module_name="Bar",
+        instance_name="bar",
+        ports=[
+            ast.PortArg("port", ast.Identifier("old_arg")),
+            ast.PortArg("other_port", ast.Identifier("other_arg")),
+        ],
+    )
+
+    module.rewire_instance("bar", {"port": "new_arg"})
+
+    assert ".port(new_arg)" in module.code
+    assert "old_arg" not in module.code
+    assert ".other_port(other_arg)" in module.code
+
+
+@pytest.mark.usefixtures("options")
+def test_rewire_nonexistent_instance_fails() -> None:
+    module = Module(name="foo")
+
+    with pytest.raises(ValueError, match="no instance bar found"):
+        module.rewire_instance("bar", {"port": "new_arg"})
+
+
 @pytest.mark.usefixtures("options")
 def test_del_nonexistent_instance_succeeds() -> None:
     module = Module(name="foo")
@@ -0,0 +1,200 @@
+"""Cycle counters of task instances and FIFOs in the top-level RTL."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import logging
+from typing import TYPE_CHECKING, Literal, NamedTuple
+
+from pyverilog.vparser.ast import Constant, ParamArg
+
+from tapa.verilog.ast.logic import Assign
+from tapa.verilog.ast.parameter import Parameter
+from tapa.verilog.ast.signal import Wire
+from tapa.verilog.ast.width import Width
+from tapa.verilog.ast_utils import make_port_arg
+from tapa.verilog.util import wire_name
+from tapa.verilog.xilinx.const import (
+    HANDSHAKE_CLK,
+    HANDSHAKE_IDLE,
+    HANDSHAKE_RST,
+    HANDSHAKE_START,
+)
+
+if TYPE_CHECKING:
+    from tapa.task import Task
+    from tapa.verilog.xilinx.module import Module
+
+_logger = logging.getLogger().getChild(__name__)
+
+# The kernel XML written by `tapa pack` declares a 4 KiB `s_axi_control`.
+PERF_COUNTERS_ADDR_WIDTH = 12
+
+_ADDR_WIDTH_PARAM = "C_S_AXI_CONTROL_ADDR_WIDTH"
+_CONTROL_INSTANCE = "control_s_axi_U"
+_READ_PORTS = ("ARVALID", "ARREADY", "ARADDR", "RVALID", "RREADY", "RDATA", "RRESP")
+_PREFIX = "__tapa_perf"
+
+
+class PerfCounter(NamedTuple):
+    """A 64-bit counter incremented in each cycle `enable` is asserted."""
+
+    name: str  # Instance name, FIFO name, or the top task name.
+    kind: Literal["kernel", "task", "fifo"]
+    event: str  # E.g., `busy_cycles`.
+    enable: str  # Verilog expression in the top-level module.
+
+    @property
+    def report(self) -> dict[str, str]:
+        return {"name": self.name, "kind": self.kind, "event": self.event}
+
+
+def get_perf_counters_offset(module: "Module") -> int:
+    """Returns the `s_axi_control` address of the first counter in `module`.
+
+    Counters are mapped right after the control registers generated by HLS,
+    which span `2 ** C_S_AXI_CONTROL_ADDR_WIDTH` bytes.
+
+    Raises:
+      ValueError: The address width of the control registers is unknown, or
+        the control registers leave no room for counters.
+    """
+    param = module.params.get(_ADDR_WIDTH_PARAM)
+    if param is None or not param.value.isdigit():
+        msg = f"cannot find the control register address width of {module.name}"
+        raise ValueError(msg)
+    offset = 1 << int(param.value)
+    if offset >= 1 << PERF_COUNTERS_ADDR_WIDTH:
+        msg = (
+            f"control registers of {module.name} span {offset} bytes, leaving no "
+            "room for performance counters in `s_axi_control`"
+        )
+        raise ValueError(msg)
+    return offset
+
+
+def get_perf_counters(task: "Task") -> list[PerfCounter]:
+    """Returns counters of `task` and its child instances and FIFOs.
+
+    Instances count `busy_cycles` while they have started but are not idle, and
+    `blocked_cycles` while busy without moving any token and at least one of
+    their streams being empty (inputs) or full (outputs). FIFOs count
+    `full_cycles` and `empty_cycles` while the kernel is busy. Only FIFOs
+    instantiated in `task` are counted.
+    """
+    busy = f"~{HANDSHAKE_IDLE}"
+    counters = [PerfCounter(task.name, "kernel", "cycles", busy)]
+
+    for instance in task.instances:
+        if instance.is_autorun:
+            instance_busy = f"{busy} & {instance.start.name}"
+        else:
+            instance_busy = f"{busy} & ~{instance.idle.name}"
+        counters.append(
+            PerfCounter(instance.name, "task", "busy_cycles", instance_busy)
+        )
+
+        transfers = []
+        stalls = []
+        for arg in instance.args:
+            if arg.cat.is_istream:
+                transfers.append(wire_name(arg.name, "_read"))
+                stalls.append(f"~{wire_name(arg.name, '_empty_n')}")
+            elif arg.cat.is_ostream:
+                transfers.append(wire_name(arg.name, "_write"))
+                stalls.append(f"~{wire_name(arg.name, '_full_n')}")
+        if stalls:
+            counters.append(
+                PerfCounter(
+                    instance.name,
+                    "task",
+                    "blocked_cycles",
+                    f"{instance_busy} & ~({' | '.join(transfers)})"
+                    f" & ({' | '.join(stalls)})",
+                )
+            )
+
+    for fifo_name, fifo in task.fifos.items():
+        if "depth" not in fifo:
+            continue
+        counters.extend(
+            PerfCounter(
+                fifo_name, "fifo", event, f"{busy} & ~{wire_name(fifo_name, suffix)}"
+            )
+            for event, suffix in (
+                ("full_cycles", "_full_n"),
+                ("empty_cycles", "_empty_n"),
+            )
+        )
+
+    offset = get_perf_counters_offset(task.module)
+    max_counters = ((1 << PERF_COUNTERS_ADDR_WIDTH) - offset) // 8
+    if len(counters) > max_counters:
+        _logger.warning(
+            "%s has %d performance counters; only the first %d are instantiated",
+            task.name,
+            len(counters),
+            max_counters,
+        )
+        counters = counters[:max_counters]
+    return counters
+
+
+def add_perf_counters(module: "Module", counters: list[PerfCounter]) -> None:
+    """Instantiates `counters` in the top-level `module` generated by HLS.
+
+    The counters are served as read-only `s_axi_control` registers starting at
+    `get_perf_counters_offset(module)`, so the address width of
+    `s_axi_control` is widened to cover them. Reads of other addresses are
+    forwarded to the control registers unchanged. Counters are cleared when the
+    kernel starts.
+    """
+    offset = get_perf_counters_offset(module)
+    if offset + 8 * len(counters) > 1 << PERF_COUNTERS_ADDR_WIDTH:
+        msg = f"{len(counters)} performance counters do not fit in `s_axi_control`"
+        raise ValueError(msg)
+    module.del_params(prefix=_ADDR_WIDTH_PARAM, suffix=_ADDR_WIDTH_PARAM)
+    module.add_params([Parameter(_ADDR_WIDTH_PARAM, str(PERF_COUNTERS_ADDR_WIDTH))])
+
+    addr_width = Width.create(PERF_COUNTERS_ADDR_WIDTH)
+    enable = f"{_PREFIX}_enable"
+    module.add_signals(
+        [
+            Wire(f"{_PREFIX}_ctrl_ARVALID"),
+            Wire(f"{_PREFIX}_ctrl_ARREADY"),
+            Wire(f"{_PREFIX}_ctrl_ARADDR", addr_width),
+            Wire(f"{_PREFIX}_ctrl_RVALID"),
+            Wire(f"{_PREFIX}_ctrl_RREADY"),
+            Wire(f"{_PREFIX}_ctrl_RDATA", Width.create(32)),
+            Wire(f"{_PREFIX}_ctrl_RRESP", Width.create(2)),
+            Wire(enable, Width.create(len(counters))),
+        ]
+    )
+    module.add_logics(
+        Assign(lhs=f"{enable}[{i}]", rhs=counter.enable)
+        for i, counter in enumerate(counters)
+    )
+
+    module.rewire_instance(
+        _CONTROL_INSTANCE, {port: f"{_PREFIX}_ctrl_{port}" for port in _READ_PORTS}
+    )
+    module.add_instance(
+        module_name="perf_counters",
+        instance_name=f"{_PREFIX}_counters_unit",
+        params=[
+            ParamArg("AddrWidth", Constant(PERF_COUNTERS_ADDR_WIDTH)),
+            ParamArg("BaseAddr", Constant(f"'h{offset:x}")),
+            ParamArg("CounterCount", Constant(len(counters))),
+        ],
+        ports=[
+            make_port_arg("clk", HANDSHAKE_CLK),
+            make_port_arg("rst", HANDSHAKE_RST),
+            make_port_arg("clear", f"{HANDSHAKE_START} & {HANDSHAKE_IDLE}"),
+            make_port_arg("enable", enable),
+            *(make_port_arg(f"s_axi_{x}", f"s_axi_control_{x}") for x in _READ_PORTS),
+            *(make_port_arg(f"m_axi_{x}", f"{_PREFIX}_ctrl_{x}") for x in _READ_PORTS),
+        ],
+    )
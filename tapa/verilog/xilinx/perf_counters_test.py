@@ -0,0 +1,47 @@
+"""Unit tests for tapa.verilog.xilinx.perf_counters."""
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import pytest
+
+from tapa.verilog.ast.parameter import Parameter
+from tapa.verilog.xilinx.module import Module
+from tapa.verilog.xilinx.perf_counters import (
+    PerfCounter,
+    add_perf_counters,
+    get_perf_counters_offset,
+)
+
+
+def _make_top(addr_width: str) -> Module:
+    module = Module(name="top")
+    module.add_params([Parameter("C_S_AXI_CONTROL_ADDR_WIDTH", addr_width)])
+    return module
+
+
+def test_offset_follows_control_registers() -> None:
+    assert get_perf_counters_offset(_make_top("6")) == 0x40
+    assert get_perf_counters_offset(_make_top("11")) == 0x800
+
+
+def test_offset_requires_known_address_width() -> None:
+    with pytest.raises(ValueError, match="cannot find the control register"):
+        get_perf_counters_offset(Module(name="top"))
+    with pytest.raises(ValueError, match="cannot find the control register"):
+        get_perf_counters_offset(_make_top("ADDR_WIDTH"))
+
+
+def test_offset_fails_when_control_registers_fill_address_range() -> None:
+    with pytest.raises(ValueError, match="leaving no room"):
+        get_perf_counters_offset(_make_top("12"))
+
+
+def test_add_fails_when_counters_overlap_address_range() -> None:
+    # Counters at 0x800 fit up to 0x1000.
+    counters = [PerfCounter(f"t{i}", "task", "busy_cycles", "1") for i in range(257)]
+    with pytest.raises(ValueError, match="do not fit"):
+        add_perf_counters(_make_top("11"), counters)
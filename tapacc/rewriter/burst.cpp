@@ -0,0 +1,547 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "burst.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/AST/ParentMapContext.h"
+#include "clang/Lex/Lexer.h"
+#include "clang/Rewrite/Core/Rewriter.h"
+
+#include "mmap.h"
+#include "type.h"
+
+using std::map;
+using std::max;
+using std::nullopt;
+using std::optional;
+using std::set;
+using std::string;
+using std::to_string;
+using std::vector;
+
+using clang::ASTContext;
+using clang::AttributedStmt;
+using clang::BinaryOperator;
+using clang::BreakStmt;
+using clang::CallExpr;
+using clang::CharSourceRange;
+using clang::CompoundAssignOperator;
+using clang::CompoundStmt;
+using clang::ContinueStmt;
+using clang::CXXForRangeStmt;
+using clang::CXXMethodDecl;
+using clang::CXXOperatorCallExpr;
+using clang::DeclRefExpr;
+using clang::DeclStmt;
+using clang::DoStmt;
+using clang::Expr;
+using clang::ForStmt;
+using clang::FunctionDecl;
+using clang::GotoStmt;
+using clang::IndirectGotoStmt;
+using clang::Lexer;
+using clang::MemberExpr;
+using clang::ParenExpr;
+using clang::ParmVarDecl;
+using clang::QualType;
+using clang::ReturnStmt;
+using clang::Rewriter;
+using clang::SourceLocation;
+using clang::Stmt;
+using clang::SwitchStmt;
+using clang::TapaBurstAttr;
+using clang::TapaPipelineAttr;
+using clang::TemplateArgument;
+using clang::UnaryOperator;
+using clang::ValueDecl;
+using clang::VarDecl;
+using clang::WhileStmt;
+
+using llvm::dyn_cast;
+using llvm::dyn_cast_or_null;
+using llvm::isa;
+
+namespace tapa {
+namespace internal {
+
+namespace {
+
+// Maximum number of beats of an AXI4 burst.
+constexpr int64_t kMaxBurstLen = 256;
+
+// Read requests issued ahead of the iterations by default, which is the
+// default buffer size of the async_mmap module.
+constexpr int64_t kDefaultMaxOutstanding = 32;
+
+enum MmapAccess : unsigned {
+  kRead = 1,
+  kWrite = 2,
+};
+
+string GetSourceText(const Stmt* stmt, ASTContext& context) {
+  return Lexer::getSourceText(
+             CharSourceRange::getTokenRange(stmt->getSourceRange()),
+             context.getSourceManager(), context.getLangOpts())
+      .str();
+}
+
+// Returns the `tapa::mmap` parameter subscripted by `stmt`, or nullptr if
+// `stmt` is not an mmap subscript.
+const ParmVarDecl* GetSubscriptedMmap(const Stmt* stmt) {
+  auto op = dyn_cast<CXXOperatorCallExpr>(stmt);
+  if (op == nullptr || op->getOperator() != clang::OO_Subscript ||
+      op->getNumArgs() != 2) {
+    return nullptr;
+  }
+  auto ref = dyn_cast<DeclRefExpr>(op->getArg(0)->IgnoreImpCasts());
+  if (ref == nullptr) return nullptr;
+  auto param = dyn_cast<ParmVarDecl>(ref->getDecl());
+  if (param == nullptr || !IsTapaType(param, "mmap")) return nullptr;
+  return param;
+}
+
+// Calls `callback` with each mmap subscript in `stmt` and its mmap.
+template <typename Callback>
+void ForEachMmapSubscript(const Stmt* stmt, const Callback& callback) {
+  if (stmt == nullptr) return;
+  if (auto param = GetSubscriptedMmap(stmt)) {
+    callback(dyn_cast<CXXOperatorCallExpr>(stmt), param);
+  }
+  for (auto child : stmt->children()) ForEachMmapSubscript(child, callback);
+}
+
+// Calls `callback` with each `[[tapa::burst]]` loop in `stmt` and its
+// attribute.
+template <typename Callback>
+void ForEachBurstLoop(const Stmt* stmt, const Callback& callback) {
+  if (stmt == nullptr) return;
+  if (auto attributed = dyn_cast<AttributedStmt>(stmt)) {
+    for (auto attr : attributed->getAttrs()) {
+      if (auto burst = dyn_cast<TapaBurstAttr>(attr)) {
+        callback(attributed, burst);
+      }
+    }
+  }
+  for (auto child : stmt->children()) ForEachBurstLoop(child, callback);
+}
+
+const Stmt* GetBody(const Stmt* loop) {
+  if (auto stmt = dyn_cast_or_null<ForStmt>(loop)) return stmt->getBody();
+  if (auto stmt = dyn_cast_or_null<WhileStmt>(loop)) return stmt->getBody();
+  if (auto stmt = dyn_cast_or_null<DoStmt>(loop)) return stmt->getBody();
+  if (auto stmt = dyn_cast_or_null<CXXForRangeStmt>(loop)) {
+    return stmt->getBody();
+  }
+  return nullptr;
+}
+
+bool IsRefTo(const Expr* expr, const ValueDecl* var) {
+  auto ref = dyn_cast_or_null<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  return ref != nullptr && ref->getDecl() == var;
+}
+
+bool RefersTo(const Stmt* stmt, const ValueDecl* var) {
+  if (stmt == nullptr) return false;
+  if (auto ref = dyn_cast<DeclRefExpr>(stmt)) {
+    if (ref->getDecl() == var) return true;
+  }
+  for (auto child : stmt->children()) {
+    if (RefersTo(child, var)) return true;
+  }
+  return false;
+}
+
+// Appends the references to `var` in `stmt` to `refs`.
+void FindRefs(const Stmt* stmt, const ValueDecl* var,
+              vector<const DeclRefExpr*>& refs) {
+  if (stmt == nullptr) return;
+  if (auto ref = dyn_cast<DeclRefExpr>(stmt)) {
+    if (ref->getDecl() == var) refs.push_back(ref);
+  }
+  for (auto child : stmt->children()) FindRefs(child, var, refs);
+}
+
+bool IsMutableRef(QualType type) {
+  return type->isReferenceType() &&
+         !type.getNonReferenceType().isConstQualified();
+}
+
+// Returns the `MmapAccess`es of mmap element `expr`.
+unsigned GetAccesses(const Expr* expr, ASTContext& context) {
+  auto parents = context.getParents(*expr);
+  if (parents.empty()) return kRead;
+  const auto& parent = parents[0];
+  if (auto paren = parent.get<ParenExpr>()) {
+    return GetAccesses(paren, context);
+  }
+  if (auto binary = parent.get<BinaryOperator>()) {
+    if (binary->getLHS() == expr) {
+      if (binary->getOpcode() == clang::BO_Assign) return kWrite;
+      if (binary->isCompoundAssignmentOp()) return kRead | kWrite;
+    }
+    return kRead;
+  }
+  if (auto unary = parent.get<UnaryOperator>()) {
+    return unary->isIncrementDecrementOp() ? kRead | kWrite : kRead;
+  }
+  if (auto member = parent.get<MemberExpr>()) {
+    if (auto method = dyn_cast<CXXMethodDecl>(member->getMemberDecl())) {
+      return method->isConst() ? kRead : kRead | kWrite;
+    }
+    return kRead | (GetAccesses(member, context) & kWrite);
+  }
+  if (auto op = parent.get<CXXOperatorCallExpr>()) {
+    auto method = dyn_cast_or_null<CXXMethodDecl>(op->getCalleeDecl());
+    if (method != nullptr && !method->isConst() && op->getArg(0) == expr) {
+      return op->getOperator() == clang::OO_Equal ? kWrite : kRead | kWrite;
+    }
+    return kRead;
+  }
+  if (auto call = parent.get<CallExpr>()) {
+    auto callee = call->getDirectCallee();
+    for (unsigned i = 0; callee != nullptr && i < call->getNumArgs(); ++i) {
+      if (call->getArg(i) == expr && i < callee->getNumParams() &&
+          IsMutableRef(callee->getParamDecl(i)->getType())) {
+        return kRead | kWrite;
+      }
+    }
+    return kRead;
+  }
+  if (auto var = parent.get<VarDecl>()) {
+    return IsMutableRef(var->getType()) ? kRead | kWrite : kRead;
+  }
+  return kRead;
+}
+
+// Returns the first statement in `stmt` that leaves the current iteration
+// without reaching the end of the loop body, or nullptr if none.
+const Stmt* FindJump(const Stmt* stmt, bool in_loop = false,
+                     bool in_switch = false) {
+  if (stmt == nullptr) return nullptr;
+  if (isa<ReturnStmt, GotoStmt, IndirectGotoStmt>(stmt)) return stmt;
+  if (isa<BreakStmt>(stmt) && !in_loop && !in_switch) return stmt;
+  if (isa<ContinueStmt>(stmt) && !in_loop) return stmt;
+  in_loop = in_loop || GetBody(stmt) != nullptr;
+  in_switch = in_switch || isa<SwitchStmt>(stmt);
+  for (auto child : stmt->children()) {
+    if (auto jump = FindJump(child, in_loop, in_switch)) return jump;
+  }
+  return nullptr;
+}
+
+// Returns the induction variable initialized by `init`, or nullptr.
+const ValueDecl* GetInitializedVar(const Stmt* init) {
+  if (auto decl_stmt = dyn_cast_or_null<DeclStmt>(init)) {
+    if (decl_stmt->isSingleDecl()) {
+      return dyn_cast<VarDecl>(decl_stmt->getSingleDecl());
+    }
+  } else if (auto assign = dyn_cast_or_null<BinaryOperator>(init)) {
+    if (assign->getOpcode() == clang::BO_Assign) {
+      if (auto ref = dyn_cast<DeclRefExpr>(assign->getLHS()->IgnoreParens())) {
+        return ref->getDecl();
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Returns whether `inc` increments `var` by one.
+bool IsIncrementByOne(const Expr* inc, const ValueDecl* var,
+                      ASTContext& context) {
+  if (auto unary = dyn_cast_or_null<UnaryOperator>(inc)) {
+    return unary->isIncrementOp() && IsRefTo(unary->getSubExpr(), var);
+  }
+  if (auto assign = dyn_cast_or_null<CompoundAssignOperator>(inc)) {
+    Expr::EvalResult step;
+    return assign->getOpcode() == clang::BO_AddAssign &&
+           IsRefTo(assign->getLHS(), var) &&
+           assign->getRHS()->EvaluateAsInt(step, context) &&
+           step.Val.getInt() == 1;
+  }
+  return false;
+}
+
+// Returns the element type of `param` without cv-qualifiers, e.g., `float`
+// for `tapa::mmap<const float>`. The channels of `tapa::async_mmap` and the
+// local copies of elements are declared with this type.
+string GetUnqualifiedElemType(const ParmVarDecl* param) {
+  auto arg = GetTemplateArg(param->getType(), 0);
+  if (arg == nullptr || arg->getKind() != TemplateArgument::Type) {
+    return GetMmapElemType(param);
+  }
+  return GetTemplateArgName(
+      TemplateArgument(arg->getAsType().getUnqualifiedType()));
+}
+
+// An mmap accessed in a `[[tapa::burst]]` loop.
+struct BurstMmap {
+  const ParmVarDecl* param;
+  // Offset of the accessed element from the loop variable, e.g., ` + (base)`.
+  string offset;
+  unsigned accesses = 0;
+  // Subscripts of the mmap and their `MmapAccess`es.
+  vector<std::pair<const CXXOperatorCallExpr*, unsigned>> subscripts;
+
+  string Var(const string& suffix) const {
+    return "_tapa_" + param->getNameAsString() + "_" + suffix;
+  }
+};
+
+}  // namespace
+
+optional<BurstConfig> GetBurstConfig(const ParmVarDecl* param) {
+  auto func = dyn_cast<FunctionDecl>(param->getDeclContext());
+  if (func == nullptr || !IsTapaType(param, "mmap")) return nullopt;
+  func = func->getDefinition();
+  const unsigned index = param->getFunctionScopeIndex();
+  if (func == nullptr || index >= func->getNumParams()) return nullopt;
+  param = func->getParamDecl(index);
+
+  optional<BurstConfig> config;
+  ForEachBurstLoop(
+      func->getBody(),
+      [&](const AttributedStmt* stmt, const TapaBurstAttr* attr) {
+        ForEachMmapSubscript(
+            stmt->getSubStmt(),
+            [&](const CXXOperatorCallExpr*, const ParmVarDecl* mmap) {
+              if (mmap != param) return;
+              if (!config) config.emplace();
+              config->burst_len =
+                  max<int64_t>(config->burst_len, attr->getBurstLen());
+              config->max_outstanding = max<int64_t>(config->max_outstanding,
+                                                     attr->getOutstanding());
+            });
+      });
+  return config;
+}
+
+void RewriteBurstLoop(const AttributedStmt* stmt, Rewriter& rewriter,
+                      ASTContext& context) {
+  auto report = [&context](SourceLocation loc, const string& message) {
+    static const auto diagnostic_id = context.getDiagnostics().getCustomDiagID(
+        clang::DiagnosticsEngine::Error, "invalid [[tapa::burst]] loop: %0");
+    context.getDiagnostics().Report(loc, diagnostic_id).AddString(message);
+  };
+
+  const TapaBurstAttr* burst = nullptr;
+  unsigned ii = 1;
+  for (auto attr : stmt->getAttrs()) {
+    if (auto burst_attr = dyn_cast<TapaBurstAttr>(attr)) {
+      burst = burst_attr;
+    } else if (auto pipeline = dyn_cast<TapaPipelineAttr>(attr)) {
+      ii = max<unsigned>(pipeline->getII(), 1);
+    }
+  }
+  assert(burst != nullptr);
+  if (burst->getBurstLen() > kMaxBurstLen) {
+    report(burst->getLocation(), "burst length must not exceed " +
+                                     to_string(kMaxBurstLen) + " beats");
+    return;
+  }
+  if (burst->getOutstanding() == 1) {
+    report(burst->getLocation(), "at least 2 outstanding requests required");
+    return;
+  }
+  const int64_t max_outstanding = burst->getOutstanding() > 0
+                                      ? burst->getOutstanding()
+                                      : kDefaultMaxOutstanding;
+
+  // The loop must be `for (init; var < end; ++var) { ... }`.
+  auto loop = dyn_cast<ForStmt>(stmt->getSubStmt());
+  if (loop == nullptr) {
+    report(stmt->getBeginLoc(), "only for loops are supported");
+    return;
+  }
+  auto var = GetInitializedVar(loop->getInit());
+  auto cond = dyn_cast_or_null<BinaryOperator>(loop->getCond());
+  auto body = dyn_cast_or_null<CompoundStmt>(loop->getBody());
+  if (var == nullptr || cond == nullptr ||
+      (cond->getOpcode() != clang::BO_LT &&
+       cond->getOpcode() != clang::BO_NE) ||
+      !IsRefTo(cond->getLHS(), var) ||
+      !IsIncrementByOne(loop->getInc(), var, context) || body == nullptr) {
+    report(loop->getBeginLoc(),
+           "loop must be in the form of `for (init; var < end; ++var) {...}`");
+    return;
+  }
+  if (auto jump = FindJump(body)) {
+    report(jump->getBeginLoc(), "the loop body must not be left early");
+    return;
+  }
+
+  // Each mmap must be accessed at the same offset from the loop variable.
+  vector<BurstMmap> mmaps;
+  map<const ParmVarDecl*, size_t> mmap_indices;
+  bool is_valid = true;
+  ForEachMmapSubscript(body, [&](const CXXOperatorCallExpr* subscript,
+                                 const ParmVarDecl* param) {
+    auto index = subscript->getArg(1)->IgnoreParenImpCasts();
+    optional<string> offset;
+    if (IsRefTo(index, var)) {
+      offset = "";
+    } else if (auto binary = dyn_cast<BinaryOperator>(index)) {
+      auto lhs = binary->getLHS();
+      auto rhs = binary->getRHS();
+      if (binary->getOpcode() == clang::BO_Add && IsRefTo(rhs, var)) {
+        std::swap(lhs, rhs);
+      }
+      if ((binary->getOpcode() == clang::BO_Add ||
+           binary->getOpcode() == clang::BO_Sub) &&
+          IsRefTo(lhs, var) && !RefersTo(rhs, var)) {
+        const char* op = binary->getOpcode() == clang::BO_Add ? " + " : " - ";
+        offset = string(op) + "(" + GetSourceText(rhs, context) + ")";
+      }
+    }
+    auto [it, inserted] = mmap_indices.emplace(param, mmaps.size());
+    if (inserted) mmaps.push_back({param, offset.value_or("")});
+    auto& mmap = mmaps[it->second];
+    if (!offset || *offset != mmap.offset) {
+      report(subscript->getExprLoc(),
+             "'" + param->getNameAsString() +
+                 "' must be accessed at the loop variable plus the same "
+                 "loop-invariant offset");
+      is_valid = false;
+      return;
+    }
+    const unsigned accesses = GetAccesses(subscript, context);
+    mmap.accesses |= accesses;
+    mmap.subscripts.emplace_back(subscript, accesses);
+  });
+  if (!is_valid) return;
+
+  const string var_name = var->getNameAsString();
+  const string end = GetSourceText(cond->getRHS(), context);
+  const string op = cond->getOpcodeStr().str();
+  string init = GetSourceText(loop->getInit(), context);
+  if (init.empty() || init.back() != ';') init += ';';
+
+  // Before the loop: declare the loop variable and the request counters.
+  string header = "{\n" + init + "\n";
+  string loop_cond = "(" + GetSourceText(cond, context) + ")";
+  for (const auto& mmap : mmaps) {
+    if (mmap.accesses & kRead) {
+      header += "decltype(" + var_name + ") " + mmap.Var("read_req") + " = " +
+                var_name + ";\n";
+    }
+    if (mmap.accesses & kWrite) {
+      header += "uint64_t " + mmap.Var("write_req") + " = 0;\n";
+      header += "uint64_t " + mmap.Var("write_resp") + " = 0;\n";
+      // Wait for all write responses before leaving the loop.
+      loop_cond +=
+          " || " + mmap.Var("write_req") + " != " + mmap.Var("write_resp");
+    }
+  }
+  header += "for (; " + loop_cond + ";) ";
+
+  // At the beginning of each iteration: issue read requests ahead, receive
+  // write responses, and run the original iteration if its elements arrived.
+  string prologue = "\n#pragma HLS pipeline II = " + to_string(ii) + "\n";
+  string guard = GetSourceText(cond, context);
+  string elems;
+  for (const auto& mmap : mmaps) {
+    const string name = mmap.param->getNameAsString();
+    const string elem_type = GetUnqualifiedElemType(mmap.param);
+    if (mmap.accesses & kRead) {
+      const string req = mmap.Var("read_req");
+      prologue += "if (" + req + " " + op + " " + end + " && " + req + " < " +
+                  var_name + " + " + to_string(max_outstanding) + " && " +
+                  name + ".read_addr.try_write(" + req + mmap.offset +
+                  ")) {\n++" + req + ";\n}\n";
+      guard += " && !" + name + ".read_data.empty()";
+      elems += elem_type + " " + mmap.Var("elem") + " = " + name +
+               ".read_data.read(nullptr);\n";
+    } else {
+      elems += elem_type + " " + mmap.Var("elem") + "{};\n";
+    }
+    if (mmap.accesses & kWrite) {
+      prologue += "if (!" + name + ".write_resp.empty()) {\n" +
+                  mmap.Var("write_resp") + " += " + name +
+                  ".write_resp.read(nullptr) + 1;\n}\n";
+      guard += " && !" + name + ".write_addr.full() && !" + name +
+               ".write_data.full()";
+      elems += "bool " + mmap.Var("written") + " = false;\n";
+    }
+  }
+  prologue += "if (" + guard + ") {\n" + elems;
+
+  // At the end of each iteration: write back the elements and increment.
+  string epilogue;
+  for (const auto& mmap : mmaps) {
+    if (mmap.accesses & kWrite) {
+      const string name = mmap.param->getNameAsString();
+      epilogue += "if (" + mmap.Var("written") + ") {\n" + name +
+                  ".write_addr.write(" + var_name + mmap.offset + ");\n" +
+                  name + ".write_data.write(" + mmap.Var("elem") + ");\n++" +
+                  mmap.Var("write_req") + ";\n}\n";
+    }
+  }
+  epilogue += GetSourceText(loop->getInc(), context) + ";\n}\n";
+
+  // Elements are accessed as local variables in the original iteration.
+  for (const auto& mmap : mmaps) {
+    for (const auto& [subscript, accesses] : mmap.subscripts) {
+      rewriter.ReplaceText(
+          subscript->getSourceRange(),
+          accesses & kWrite ? "(" + mmap.Var("written") + " = true, " +
+                                  mmap.Var("elem") + ")"
+                            : mmap.Var("elem"));
+    }
+  }
+  rewriter.ReplaceText(
+      CharSourceRange::getCharRange(loop->getBeginLoc(), body->getLBracLoc()),
+      header);
+  rewriter.InsertTextAfterToken(body->getLBracLoc(), prologue);
+  rewriter.InsertTextBefore(body->getRBracLoc(), epilogue);
+  rewriter.InsertTextAfterToken(body->getRBracLoc(), "\n}");
+}
+
+void RewriteBurstMmapParams(const FunctionDecl* func, Rewriter& rewriter,
+                            ASTContext& context) {
+  if (!func->doesThisDeclarationHaveABody()) return;
+
+  // Mmaps passed as async_mmaps can only be accessed by the rewritten loops.
+  set<const Expr*> burst_refs;
+  ForEachBurstLoop(func->getBody(), [&](const AttributedStmt* stmt,
+                                        const TapaBurstAttr*) {
+    ForEachMmapSubscript(
+        GetBody(stmt->getSubStmt()),
+        [&](const CXXOperatorCallExpr* subscript, const ParmVarDecl*) {
+          burst_refs.insert(subscript->getArg(0)->IgnoreImpCasts());
+        });
+  });
+
+  for (auto param : func->parameters()) {
+    if (!GetBurstConfig(param)) continue;
+
+    vector<const DeclRefExpr*> refs;
+    FindRefs(func->getBody(), param, refs);
+    for (auto ref : refs) {
+      if (burst_refs.count(ref)) continue;
+      static const auto diagnostic_id =
+          context.getDiagnostics().getCustomDiagID(
+              clang::DiagnosticsEngine::Error,
+              "mmap '%0' accessed in [[tapa::burst]] loops can only be "
+              "accessed by subscripts in such loops");
+      context.getDiagnostics()
+          .Report(ref->getLocation(), diagnostic_id)
+          .AddString(param->getNameAsString());
+    }
+
+    rewriter.ReplaceText(
+        param->getTypeSourceInfo()->getTypeLoc().getSourceRange(),
+        "tapa::async_mmap<" + GetUnqualifiedElemType(param) + ">&");
+  }
+}
+
+}  // namespace internal
+}  // namespace tapa
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef TAPA_BURST_H_
+#define TAPA_BURST_H_
+
+#include <cstdint>
+#include <optional>
+
+#include "clang/AST/AST.h"
+#include "clang/Rewrite/Core/Rewriter.h"
+
+namespace tapa {
+namespace internal {
+
+// Configuration of the burst engine of a `tapa::mmap` parameter. Zero means
+// the default of the async_mmap module.
+struct BurstConfig {
+  // Maximum number of beats per AXI burst.
+  int64_t burst_len = 0;
+  // Maximum number of outstanding read requests.
+  int64_t max_outstanding = 0;
+};
+
+// Returns the burst engine configuration of `tapa::mmap` parameter `param` if
+// its task accesses it in `[[tapa::burst]]` loops. Such mmaps are passed to
+// the task as `tapa::async_mmap` instead.
+std::optional<BurstConfig> GetBurstConfig(const clang::ParmVarDecl* param);
+
+// Rewrites the `[[tapa::burst]]` loop `stmt` of a lower-level task to access
+// its mmaps through the read and write channels of async_mmaps, issuing read
+// requests ahead of the iterations that consume them.
+void RewriteBurstLoop(const clang::AttributedStmt* stmt,
+                      clang::Rewriter& rewriter, clang::ASTContext& context);
+
+// Rewrites the mmap parameters of lower-level task `func` that are accessed
+// in `[[tapa::burst]]` loops as async_mmaps.
+void RewriteBurstMmapParams(const clang::FunctionDecl* func,
+                            clang::Rewriter& rewriter,
+                            clang::ASTContext& context);
+
+}  // namespace internal
+}  // namespace tapa
+
+#endif  // TAPA_BURST_H_
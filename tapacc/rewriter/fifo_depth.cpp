@@ -0,0 +1,383 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "fifo_depth.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <queue>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clang/AST/AST.h"
+
+#include "nlohmann/json.hpp"
+
+#include "type.h"
+
+using std::map;
+using std::max;
+using std::nullopt;
+using std::optional;
+using std::pair;
+using std::queue;
+using std::set;
+using std::string;
+using std::vector;
+
+using clang::ASTContext;
+using clang::AttributedStmt;
+using clang::BinaryOperator;
+using clang::CompoundAssignOperator;
+using clang::CompoundStmt;
+using clang::CXXForRangeStmt;
+using clang::CXXMemberCallExpr;
+using clang::DeclRefExpr;
+using clang::DeclStmt;
+using clang::DoStmt;
+using clang::Expr;
+using clang::ForStmt;
+using clang::FunctionDecl;
+using clang::IfStmt;
+using clang::Stmt;
+using clang::TapaPipelineAttr;
+using clang::UnaryOperator;
+using clang::ValueDecl;
+using clang::VarDecl;
+using clang::WhileStmt;
+
+using llvm::dyn_cast;
+using llvm::dyn_cast_or_null;
+
+using nlohmann::json;
+
+namespace tapa {
+namespace internal {
+
+namespace {
+
+enum StreamAccess : unsigned {
+  kRead = 1,
+  kWrite = 2,
+};
+
+// Returns the `StreamAccess`es in `stmt`, including nested loops.
+unsigned GetStreamAccesses(const Stmt* stmt) {
+  if (stmt == nullptr) return 0;
+  unsigned accesses = 0;
+  if (auto call = dyn_cast<CXXMemberCallExpr>(stmt)) {
+    if (IsTapaType(call->getRecordDecl(), "istream")) {
+      accesses |= kRead;
+    } else if (IsTapaType(call->getRecordDecl(), "ostream")) {
+      accesses |= kWrite;
+    }
+  }
+  for (auto child : stmt->children()) accesses |= GetStreamAccesses(child);
+  return accesses;
+}
+
+// A loop and the II of its `[[tapa::pipeline]]` attribute, or 0 if the loop
+// is not pipelined.
+struct Loop {
+  const Stmt* stmt;
+  const Stmt* body;
+  int64_t ii;
+};
+
+optional<Loop> GetLoop(const Stmt* stmt) {
+  int64_t ii = 0;
+  if (auto attributed = dyn_cast_or_null<AttributedStmt>(stmt)) {
+    for (auto attr : attributed->getAttrs()) {
+      if (auto pipeline = dyn_cast<TapaPipelineAttr>(attr)) {
+        ii = max<int64_t>(pipeline->getII(), 1);
+      }
+    }
+    stmt = attributed->getSubStmt();
+  }
+  const Stmt* body = nullptr;
+  if (auto loop = dyn_cast_or_null<ForStmt>(stmt)) {
+    body = loop->getBody();
+  } else if (auto loop = dyn_cast_or_null<WhileStmt>(stmt)) {
+    body = loop->getBody();
+  } else if (auto loop = dyn_cast_or_null<DoStmt>(stmt)) {
+    body = loop->getBody();
+  } else if (auto loop = dyn_cast_or_null<CXXForRangeStmt>(stmt)) {
+    body = loop->getBody();
+  } else {
+    return nullopt;
+  }
+  return Loop{stmt, body, ii};
+}
+
+class TimingEstimator {
+ public:
+  explicit TimingEstimator(ASTContext& context) : context_{context} {}
+
+  // Returns the cycles to execute `stmt` completely.
+  optional<int64_t> GetCycles(const Stmt* stmt) {
+    if (stmt == nullptr) return 0;
+    if (auto loop = GetLoop(stmt)) {
+      auto trip_count = GetTripCount(loop->stmt);
+      auto iteration = GetIterationCycles(*loop);
+      if (!trip_count || !iteration) return nullopt;
+      return *trip_count * *iteration;
+    }
+    if (auto compound = dyn_cast<CompoundStmt>(stmt)) {
+      int64_t cycles = 0;
+      for (auto child : compound->body()) {
+        auto child_cycles = GetCycles(child);
+        if (!child_cycles) return nullopt;
+        cycles += *child_cycles;
+      }
+      return cycles;
+    }
+    if (auto if_stmt = dyn_cast<IfStmt>(stmt)) {
+      auto then_cycles = GetCycles(if_stmt->getThen());
+      auto else_cycles = GetCycles(if_stmt->getElse());
+      if (!then_cycles || !else_cycles) return nullopt;
+      return max(*then_cycles, *else_cycles);
+    }
+    // Straight-line code is scheduled together except for stream accesses.
+    return GetStreamAccesses(stmt) ? 1 : 0;
+  }
+
+  // Returns the cycles between consecutive iterations of `loop`.
+  optional<int64_t> GetIterationCycles(const Loop& loop) {
+    if (loop.ii > 0) return loop.ii;
+    auto body_cycles = GetCycles(loop.body);
+    if (!body_cycles) return nullopt;
+    return max<int64_t>(*body_cycles, 1);
+  }
+
+ private:
+  ASTContext& context_;
+
+  optional<int64_t> EvalAsInt(const Expr* expr) {
+    Expr::EvalResult result;
+    if (expr == nullptr || !expr->EvaluateAsInt(result, context_)) {
+      return nullopt;
+    }
+    return result.Val.getInt().getExtValue();
+  }
+
+  static const ValueDecl* GetVar(const Expr* expr) {
+    if (expr == nullptr) return nullptr;
+    auto decl_ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+    return decl_ref == nullptr ? nullptr : decl_ref->getDecl();
+  }
+
+  // Returns the trip count of `loop` if it is a constant.
+  optional<int64_t> GetTripCount(const Stmt* loop) {
+    if (auto range_loop = dyn_cast<CXXForRangeStmt>(loop)) {
+      if (auto array = context_.getAsConstantArrayType(
+              range_loop->getRangeInit()->getType())) {
+        return array->getSize().getSExtValue();
+      }
+      return nullopt;
+    }
+    auto for_loop = dyn_cast<ForStmt>(loop);
+    if (for_loop == nullptr) return nullopt;
+
+    // Loop variable and its initial value.
+    const ValueDecl* var = nullptr;
+    optional<int64_t> begin;
+    if (auto decl_stmt = dyn_cast_or_null<DeclStmt>(for_loop->getInit())) {
+      if (decl_stmt->isSingleDecl()) {
+        if (auto var_decl = dyn_cast<VarDecl>(decl_stmt->getSingleDecl())) {
+          var = var_decl;
+          begin = EvalAsInt(var_decl->getInit());
+        }
+      }
+    } else if (auto assign =
+                   dyn_cast_or_null<BinaryOperator>(for_loop->getInit())) {
+      if (assign->isAssignmentOp()) {
+        var = GetVar(assign->getLHS());
+        begin = EvalAsInt(assign->getRHS());
+      }
+    }
+
+    // Loop bound.
+    auto cond = dyn_cast_or_null<BinaryOperator>(for_loop->getCond());
+    if (var == nullptr || !begin || cond == nullptr ||
+        GetVar(cond->getLHS()) != var) {
+      return nullopt;
+    }
+    auto end = EvalAsInt(cond->getRHS());
+
+    // Loop step.
+    optional<int64_t> step;
+    if (auto inc = dyn_cast_or_null<UnaryOperator>(for_loop->getInc())) {
+      if (GetVar(inc->getSubExpr()) == var) {
+        if (inc->isIncrementOp()) step = 1;
+        if (inc->isDecrementOp()) step = -1;
+      }
+    } else if (auto inc = dyn_cast_or_null<CompoundAssignOperator>(
+                   for_loop->getInc())) {
+      if (GetVar(inc->getLHS()) == var) {
+        auto delta = EvalAsInt(inc->getRHS());
+        if (delta && inc->getOpcode() == clang::BO_AddAssign) step = *delta;
+        if (delta && inc->getOpcode() == clang::BO_SubAssign) step = -*delta;
+      }
+    }
+    if (!end || !step || *step == 0) return nullopt;
+
+    const int64_t distance = *end - *begin;
+    switch (cond->getOpcode()) {
+      case clang::BO_LT:
+        if (*step < 0) return nullopt;
+        return distance > 0 ? (distance + *step - 1) / *step : 0;
+      case clang::BO_LE:
+        if (*step < 0) return nullopt;
+        return distance >= 0 ? distance / *step + 1 : 0;
+      case clang::BO_GT:
+        if (*step > 0) return nullopt;
+        return distance < 0 ? (-distance - *step - 1) / -*step : 0;
+      case clang::BO_GE:
+        if (*step > 0) return nullopt;
+        return distance <= 0 ? -distance / -*step + 1 : 0;
+      case clang::BO_NE:
+        if (distance % *step != 0 || distance / *step < 0) return nullopt;
+        return distance / *step;
+      default:
+        return nullopt;
+    }
+  }
+};
+
+}  // namespace
+
+optional<TaskTiming> EstimateTaskTiming(const FunctionDecl* func,
+                                        ASTContext& context) {
+  auto body = dyn_cast_or_null<CompoundStmt>(func->getBody());
+  if (body == nullptr) return nullopt;
+  vector<const Stmt*> stmts(body->body_begin(), body->body_end());
+
+  // Statements containing the first read and the first write.
+  size_t first_read = stmts.size();
+  size_t first_write = stmts.size();
+  for (size_t i = stmts.size(); i-- > 0;) {
+    auto accesses = GetStreamAccesses(stmts[i]);
+    if (accesses & kRead) first_read = i;
+    if (accesses & kWrite) first_write = i;
+  }
+
+  TimingEstimator estimator{context};
+  TaskTiming timing{/*waits_for_input=*/first_read <= first_write,
+                    /*latency=*/0, /*interval=*/1};
+  if (first_write == stmts.size()) return timing;
+
+  // If the first input and output are in the same loop, tokens flow through
+  // iteration by iteration; otherwise, the statements in between complete
+  // before the first output.
+  size_t begin = timing.waits_for_input ? first_read : 0;
+  auto write_loop = GetLoop(stmts[first_write]);
+  if (begin == first_write) {
+    timing.latency = 1;
+    if (write_loop) {
+      auto iteration = estimator.GetIterationCycles(*write_loop);
+      if (!iteration) return nullopt;
+      timing.latency = *iteration;
+    }
+  } else {
+    for (size_t i = begin; i < first_write; ++i) {
+      auto cycles = estimator.GetCycles(stmts[i]);
+      if (!cycles) return nullopt;
+      timing.latency += *cycles;
+    }
+  }
+  if (write_loop) {
+    auto interval = estimator.GetIterationCycles(*write_loop);
+    if (!interval) return nullopt;
+    timing.interval = *interval;
+  }
+  return timing;
+}
+
+void RecommendFifoDepths(json& fifos, const map<string, TaskTiming>& timings) {
+  // Instances are identified by their task name and index.
+  using Instance = pair<string, int64_t>;
+  struct Edge {
+    string fifo;
+    Instance producer;
+    Instance consumer;
+  };
+  vector<Edge> edges;
+  set<Instance> instances;
+  map<Instance, vector<const Edge*>> in_edges;
+  map<Instance, vector<const Edge*>> out_edges;
+  for (const auto& [name, fifo] : fifos.items()) {
+    if (!fifo.contains("produced_by") || !fifo.contains("consumed_by")) {
+      continue;
+    }
+    const auto& producer = fifo["produced_by"];
+    const auto& consumer = fifo["consumed_by"];
+    edges.push_back({name,
+                     {producer[0].get<string>(), producer[1].get<int64_t>()},
+                     {consumer[0].get<string>(), consumer[1].get<int64_t>()}});
+  }
+  for (const auto& edge : edges) {
+    instances.insert(edge.producer);
+    instances.insert(edge.consumer);
+    out_edges[edge.producer].push_back(&edge);
+    in_edges[edge.consumer].push_back(&edge);
+  }
+
+  // Visit instances in topological order, leaving out feedback loops, and
+  // compute when all inputs arrive and when the first output is written.
+  map<Instance, size_t> pending_inputs;
+  queue<Instance> ready;
+  for (const auto& instance : instances) {
+    pending_inputs[instance] = in_edges[instance].size();
+    if (pending_inputs[instance] == 0) ready.push(instance);
+  }
+  map<Instance, optional<int64_t>> input_time;
+  map<Instance, optional<int64_t>> output_time;
+  while (!ready.empty()) {
+    auto instance = ready.front();
+    ready.pop();
+
+    optional<int64_t> inputs = 0;
+    for (auto edge : in_edges[instance]) {
+      const auto& produced = output_time[edge->producer];
+      inputs = inputs && produced ? max(*inputs, *produced + 1) : nullopt;
+    }
+    input_time[instance] = inputs;
+
+    auto timing = timings.find(instance.first);
+    if (timing == timings.end()) {
+      output_time[instance] = nullopt;
+    } else if (!timing->second.waits_for_input) {
+      output_time[instance] = timing->second.latency;
+    } else if (inputs) {
+      output_time[instance] = *inputs + timing->second.latency;
+    }
+
+    for (auto edge : out_edges[instance]) {
+      if (--pending_inputs[edge->consumer] == 0) ready.push(edge->consumer);
+    }
+  }
+
+  for (const auto& edge : edges) {
+    auto consumed = input_time.find(edge.consumer);
+    auto produced = output_time.find(edge.producer);
+    auto timing = timings.find(edge.producer.first);
+    if (consumed == input_time.end() || !consumed->second ||
+        produced == output_time.end() || !produced->second ||
+        timing == timings.end()) {
+      continue;
+    }
+    // Tokens wait in the stream from their arrival until the other inputs of
+    // the consumer arrive.
+    int64_t slack = *consumed->second - (*produced->second + 1);
+    int64_t interval = max<int64_t>(timing->second.interval, 1);
+    fifos[edge.fifo]["recommended_min_depth"] =
+        max(kMinFifoDepth, (slack + interval - 1) / interval);
+  }
+}
+
+}  // namespace internal
+}  // namespace tapa
@@ -0,0 +1,56 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef TAPA_FIFO_DEPTH_H_
+#define TAPA_FIFO_DEPTH_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "clang/AST/AST.h"
+
+#include "nlohmann/json.hpp"
+
+namespace tapa {
+namespace internal {
+
+// Minimum depth recommended for any stream.
+constexpr int64_t kMinFifoDepth = 2;
+
+// Estimated stream timing of a lower-level task, in cycles.
+struct TaskTiming {
+  // Whether the first output token is written after the first input token is
+  // read. Otherwise, the output does not wait for the inputs.
+  bool waits_for_input;
+  // Cycles until the first output token, counted from the first input token
+  // if `waits_for_input`, or from the start of the task otherwise.
+  int64_t latency;
+  // Cycles between consecutive output tokens.
+  int64_t interval;
+};
+
+// Estimates the timing of lower-level task `func` from its loop structure,
+// constant trip counts, and `[[tapa::pipeline]]` IIs. Returns nullopt if the
+// timing depends on a loop whose trip count is unknown.
+std::optional<TaskTiming> EstimateTaskTiming(const clang::FunctionDecl* func,
+                                             clang::ASTContext& context);
+
+// Adds `recommended_min_depth` to each stream in `fifos`, the `fifos` metadata
+// of an upper-level task, given the timing of each child task by name.
+//
+// Tokens of a stream are buffered from their arrival until the consumer has
+// received its other inputs. Where paths from a common producer reconverge
+// with different latencies, the stream on the shorter path must hold the
+// tokens produced during the difference, or the design stalls or deadlocks.
+// Streams are skipped if the timing of a task on their paths is unknown or if
+// they are on a feedback loop.
+void RecommendFifoDepths(nlohmann::json& fifos,
+                         const std::map<std::string, TaskTiming>& timings);
+
+}  // namespace internal
+}  // namespace tapa
+
+#endif  // TAPA_FIFO_DEPTH_H_
@@ -0,0 +1,243 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "fingerprint.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "burst.h"
+
+using std::deque;
+using std::pair;
+using std::set;
+using std::string;
+using std::to_string;
+using std::vector;
+
+using clang::CharSourceRange;
+using clang::ClassTemplateDecl;
+using clang::CXXConstructExpr;
+using clang::CXXRecordDecl;
+using clang::Decl;
+using clang::DeclRefExpr;
+using clang::EnumConstantDecl;
+using clang::FunctionDecl;
+using clang::FunctionTemplateDecl;
+using clang::Lexer;
+using clang::MemberExpr;
+using clang::RecursiveASTVisitor;
+using clang::SourceManager;
+using clang::TagDecl;
+using clang::TagTypeLoc;
+using clang::TemplateSpecializationTypeLoc;
+using clang::TypedefTypeLoc;
+using clang::VarDecl;
+
+using llvm::dyn_cast;
+using llvm::isa;
+using llvm::StringRef;
+
+namespace tapa {
+namespace internal {
+
+namespace {
+
+// Returns the declaration whose source code defines `decl`, e.g., the
+// enclosing class of a member or the template of an instantiation.
+const Decl* GetDefiningDecl(const Decl* decl) {
+  if (decl == nullptr) return nullptr;
+  if (auto tmpl = dyn_cast<FunctionTemplateDecl>(decl)) {
+    decl = tmpl->getTemplatedDecl();
+  } else if (auto tmpl = dyn_cast<ClassTemplateDecl>(decl)) {
+    decl = tmpl->getTemplatedDecl();
+  }
+  if (auto func = dyn_cast<FunctionDecl>(decl)) {
+    if (auto pattern = func->getTemplateInstantiationPattern()) func = pattern;
+    if (auto definition = func->getDefinition()) func = definition;
+    decl = func;
+  } else if (auto record = dyn_cast<CXXRecordDecl>(decl)) {
+    if (auto pattern = record->getTemplateInstantiationPattern()) {
+      record = pattern;
+    }
+    if (auto definition = record->getDefinition()) record = definition;
+    decl = record;
+  } else if (auto var = dyn_cast<VarDecl>(decl)) {
+    if (auto definition = var->getDefinition()) decl = definition;
+  } else if (isa<EnumConstantDecl>(decl)) {
+    decl = Decl::castFromDeclContext(decl->getDeclContext());
+  }
+
+  // Members are defined by their outermost enclosing class.
+  while (decl != nullptr && !decl->isOutOfLine()) {
+    auto parent = dyn_cast<TagDecl>(decl->getDeclContext());
+    if (parent == nullptr) break;
+    decl = parent;
+  }
+  return decl;
+}
+
+// Collects the declarations in the main file used by a task transitively.
+class DependencyCollector : public RecursiveASTVisitor<DependencyCollector> {
+ public:
+  DependencyCollector(const SourceManager& source_manager,
+                      const set<const Decl*>& task_decls)
+      : source_manager_{source_manager}, task_decls_{task_decls} {}
+
+  bool shouldVisitTemplateInstantiations() const { return true; }
+  bool shouldVisitImplicitCode() const { return true; }
+
+  bool VisitDeclRefExpr(DeclRefExpr* expr) {
+    Add(expr->getDecl());
+    return true;
+  }
+  bool VisitMemberExpr(MemberExpr* expr) {
+    Add(expr->getMemberDecl());
+    return true;
+  }
+  bool VisitCXXConstructExpr(CXXConstructExpr* expr) {
+    Add(expr->getConstructor());
+    return true;
+  }
+  bool VisitTagTypeLoc(TagTypeLoc loc) {
+    Add(loc.getDecl());
+    return true;
+  }
+  bool VisitTypedefTypeLoc(TypedefTypeLoc loc) {
+    Add(loc.getTypedefNameDecl());
+    return true;
+  }
+  bool VisitTemplateSpecializationTypeLoc(TemplateSpecializationTypeLoc loc) {
+    Add(loc.getTypePtr()->getTemplateName().getAsTemplateDecl());
+    return true;
+  }
+
+  // Collects the dependencies of `root` and returns the source code of each,
+  // in the order of appearance in the main file.
+  vector<StringRef> Collect(const FunctionDecl* root) {
+    root_ = GetDefiningDecl(root);
+    Add(root);
+    // Template instantiations are traversed in addition to their patterns,
+    // so that types used only through template arguments are covered.
+    TraverseDecl(const_cast<FunctionDecl*>(root));
+    while (!worklist_.empty()) {
+      auto decl = worklist_.back();
+      worklist_.pop_back();
+      if (IsOtherTask(decl)) {
+        if (auto type = dyn_cast<FunctionDecl>(decl)->getTypeSourceInfo()) {
+          TraverseTypeLoc(type->getTypeLoc());
+        }
+      } else {
+        TraverseDecl(const_cast<Decl*>(decl));
+      }
+    }
+
+    vector<pair<unsigned, StringRef>> sources;
+    for (auto decl : visited_) {
+      auto begin = source_manager_.getExpansionLoc(decl->getBeginLoc());
+      auto end = decl->getEndLoc();
+      const unsigned offset = source_manager_.getFileOffset(begin);
+      // Only the signatures of other tasks are part of the rewritten code,
+      // as well as whether they receive mmaps through burst engines.
+      if (IsOtherTask(decl)) {
+        auto task = dyn_cast<FunctionDecl>(decl);
+        if (auto body = task->getBody()) end = body->getBeginLoc();
+        string bursts;
+        for (auto param : task->parameters()) {
+          if (auto burst = GetBurstConfig(param)) {
+            bursts += param->getNameAsString() + ":" +
+                      to_string(burst->burst_len) + ":" +
+                      to_string(burst->max_outstanding) + ";";
+          }
+        }
+        if (!bursts.empty()) {
+          sources.emplace_back(offset, bursts_.emplace_back(bursts));
+        }
+      }
+      auto range = CharSourceRange::getTokenRange(
+          begin, source_manager_.getExpansionLoc(end));
+      sources.emplace_back(
+          offset,
+          Lexer::getSourceText(range, source_manager_, decl->getLangOpts()));
+    }
+    std::sort(sources.begin(), sources.end());
+
+    vector<StringRef> result;
+    for (const auto& [offset, source] : sources) result.push_back(source);
+    return result;
+  }
+
+ private:
+  const SourceManager& source_manager_;
+  const set<const Decl*>& task_decls_;
+  const Decl* root_ = nullptr;
+  set<const Decl*> visited_;
+  vector<const Decl*> worklist_;
+  // Storage of the sources not in the main file.
+  deque<string> bursts_;
+
+  bool IsOtherTask(const Decl* decl) const {
+    return decl != root_ && task_decls_.count(decl) > 0;
+  }
+
+  void Add(const Decl* decl) {
+    decl = GetDefiningDecl(decl);
+    // Declarations outside the main file, e.g., in system headers, are
+    // covered by the compiler flags in the salt. Local declarations are
+    // covered by the enclosing function.
+    if (decl == nullptr || decl->isImplicit() ||
+        decl->getParentFunctionOrMethod() != nullptr ||
+        !source_manager_.isWrittenInMainFile(
+            source_manager_.getExpansionLoc(decl->getLocation()))) {
+      return;
+    }
+    if (visited_.insert(decl).second) worklist_.push_back(decl);
+  }
+};
+
+}  // namespace
+
+string GetTaskFingerprint(const FunctionDecl* func,
+                          const set<const FunctionDecl*>& task_funcs,
+                          StringRef salt) {
+  set<const Decl*> task_decls;
+  for (auto task_func : task_funcs) {
+    task_decls.insert(GetDefiningDecl(task_func));
+  }
+  DependencyCollector collector{func->getASTContext().getSourceManager(),
+                                task_decls};
+
+  llvm::SHA256 hasher;
+  auto update = [&hasher](StringRef data) {
+    hasher.update(std::to_string(data.size()));
+    hasher.update(StringRef("\0", 1));
+    hasher.update(data);
+  };
+  // Specializations of a template task share the source code, so the name
+  // with template arguments is covered as well.
+  string name;
+  llvm::raw_string_ostream os{name};
+  func->getNameForDiagnostic(os, func->getASTContext().getPrintingPolicy(),
+                             /*Qualified=*/true);
+  os.flush();
+
+  update(salt);
+  update(name);
+  for (auto source : collector.Collect(func)) update(source);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+}  // namespace internal
+}  // namespace tapa
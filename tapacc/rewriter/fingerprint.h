@@ -0,0 +1,32 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef TAPA_FINGERPRINT_H_
+#define TAPA_FINGERPRINT_H_
+
+#include <set>
+#include <string>
+
+#include "clang/AST/AST.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace tapa {
+namespace internal {
+
+// Returns a hex digest that changes whenever the rewritten code or metadata of
+// task `func` may change.
+//
+// The digest covers `salt` and the source code of `func` and of every
+// function, variable, and type it uses transitively in the main file. Other
+// tasks in `task_funcs` are covered only by their signatures, since their
+// bodies are removed from the rewritten code of `func`.
+std::string GetTaskFingerprint(
+    const clang::FunctionDecl* func,
+    const std::set<const clang::FunctionDecl*>& task_funcs,
+    llvm::StringRef salt);
+
+}  // namespace internal
+}  // namespace tapa
+
+#endif  // TAPA_FINGERPRINT_H_
@@ -0,0 +1,348 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include "perf_lint.h"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <regex>
+#include <string>
+
+#include "clang/AST/AST.h"
+#include "clang/Lex/Lexer.h"
+
+#include "stream.h"
+#include "type.h"
+
+using std::map;
+using std::max;
+using std::nullopt;
+using std::optional;
+using std::regex;
+using std::regex_search;
+using std::string;
+
+using clang::ASTContext;
+using clang::AttributedStmt;
+using clang::BinaryOperator;
+using clang::CharSourceRange;
+using clang::ConditionalOperator;
+using clang::CXXForRangeStmt;
+using clang::CXXMemberCallExpr;
+using clang::CXXOperatorCallExpr;
+using clang::DeclRefExpr;
+using clang::DeclStmt;
+using clang::DoStmt;
+using clang::Expr;
+using clang::ForStmt;
+using clang::FunctionDecl;
+using clang::IfStmt;
+using clang::Lexer;
+using clang::Stmt;
+using clang::TapaPipelineAttr;
+using clang::ValueDecl;
+using clang::VarDecl;
+using clang::WhileStmt;
+
+using llvm::dyn_cast;
+using llvm::dyn_cast_or_null;
+
+namespace tapa {
+namespace internal {
+
+namespace {
+
+// A loop and whether it is pipelined, either by `[[tapa::pipeline]]` or by an
+// HLS pragma in its body.
+struct Loop {
+  const Stmt* stmt;
+  const Stmt* body;
+  bool is_pipelined;
+  // II of `[[tapa::pipeline]]`, or 0 if not given.
+  unsigned ii;
+};
+
+// Returns whether `stmt` is a loop, possibly with attributes.
+bool IsLoop(const Stmt* stmt) {
+  if (auto attributed = dyn_cast<AttributedStmt>(stmt)) {
+    stmt = attributed->getSubStmt();
+  }
+  return llvm::isa<ForStmt, WhileStmt, DoStmt, CXXForRangeStmt>(stmt);
+}
+
+// Returns whether `op` waits until the stream is ready.
+bool IsBlocking(const CXXMemberCallExpr* op) {
+  const string name = op->getMethodDecl()->getNameAsString();
+  if (name == "read") return op->getNumArgs() == 0;
+  return name == "open" || name == "write" || name == "close";
+}
+
+// Returns whether `op` consumes or produces a token.
+bool IsTransfer(const CXXMemberCallExpr* op) {
+  string name = op->getMethodDecl()->getNameAsString();
+  if (name.rfind("try_", 0) == 0) name = name.substr(4);
+  return name == "read" || name == "open" || name == "write" ||
+         name == "close";
+}
+
+// Returns whether `stmt` refers to `var`.
+bool RefersTo(const Stmt* stmt, const ValueDecl* var) {
+  if (stmt == nullptr) return false;
+  if (auto ref = dyn_cast<DeclRefExpr>(stmt)) {
+    if (ref->getDecl() == var) return true;
+  }
+  for (auto child : stmt->children()) {
+    if (RefersTo(child, var)) return true;
+  }
+  return false;
+}
+
+// Returns whether `index` is an affine function of `var` with loop-invariant
+// coefficients, e.g., `i`, `i + offset`, or `i * 2 + 1`.
+bool IsAffineIndex(const Expr* index, const ValueDecl* var) {
+  index = index->IgnoreParenImpCasts();
+  if (auto ref = dyn_cast<DeclRefExpr>(index)) return ref->getDecl() == var;
+  if (auto binary = dyn_cast<BinaryOperator>(index)) {
+    auto lhs = binary->getLHS();
+    auto rhs = binary->getRHS();
+    switch (binary->getOpcode()) {
+      case clang::BO_Add:
+      case clang::BO_Mul:
+        return (IsAffineIndex(lhs, var) && !RefersTo(rhs, var)) ||
+               (IsAffineIndex(rhs, var) && !RefersTo(lhs, var));
+      case clang::BO_Sub:
+      case clang::BO_Shl:
+        return IsAffineIndex(lhs, var) && !RefersTo(rhs, var);
+      default: {
+      }
+    }
+  }
+  return false;
+}
+
+// Returns the induction variable of `loop`, or nullptr if unknown.
+const ValueDecl* GetInductionVar(const Stmt* loop) {
+  if (auto range_for = dyn_cast<CXXForRangeStmt>(loop)) {
+    return range_for->getLoopVariable();
+  }
+  auto for_stmt = dyn_cast<ForStmt>(loop);
+  if (for_stmt == nullptr) return nullptr;
+  if (auto decl_stmt = dyn_cast_or_null<DeclStmt>(for_stmt->getInit())) {
+    if (decl_stmt->isSingleDecl()) {
+      return dyn_cast<VarDecl>(decl_stmt->getSingleDecl());
+    }
+  } else if (auto init = dyn_cast_or_null<BinaryOperator>(
+                 for_stmt->getInit())) {
+    if (init->isAssignmentOp()) {
+      if (auto ref = dyn_cast<DeclRefExpr>(init->getLHS()->IgnoreParens())) {
+        return ref->getDecl();
+      }
+    }
+  }
+  return nullptr;
+}
+
+class PerfLinter {
+ public:
+  explicit PerfLinter(ASTContext& context) : context_{context} {}
+
+  // Lints all loops in `stmt`.
+  void Lint(const Stmt* stmt) {
+    if (stmt == nullptr) return;
+    if (auto loop = GetLoop(stmt)) {
+      LintLoop(*loop);
+      stmt = loop->stmt;
+    }
+    for (auto child : stmt->children()) Lint(child);
+  }
+
+ private:
+  ASTContext& context_;
+
+  // Number of times a stream transfers a token per iteration, and the location
+  // of its last transfer.
+  struct Transfers {
+    unsigned count = 0;
+    const CXXMemberCallExpr* last_op = nullptr;
+  };
+
+  string GetSourceText(const Stmt* stmt) {
+    return Lexer::getSourceText(
+               CharSourceRange::getTokenRange(stmt->getSourceRange()),
+               context_.getSourceManager(), context_.getLangOpts())
+        .str();
+  }
+
+  string GetStreamName(const CXXMemberCallExpr* op) {
+    return GetSourceText(op->getImplicitObjectArgument()->IgnoreImpCasts());
+  }
+
+  optional<Loop> GetLoop(const Stmt* stmt) {
+    bool is_pipelined = false;
+    unsigned ii = 0;
+    if (auto attributed = dyn_cast<AttributedStmt>(stmt)) {
+      for (auto attr : attributed->getAttrs()) {
+        if (auto pipeline = dyn_cast<TapaPipelineAttr>(attr)) {
+          is_pipelined = true;
+          ii = pipeline->getII();
+        }
+      }
+      stmt = attributed->getSubStmt();
+    }
+    const Stmt* body = nullptr;
+    if (auto loop = dyn_cast<ForStmt>(stmt)) {
+      body = loop->getBody();
+    } else if (auto loop = dyn_cast<WhileStmt>(stmt)) {
+      body = loop->getBody();
+    } else if (auto loop = dyn_cast<DoStmt>(stmt)) {
+      body = loop->getBody();
+    } else if (auto loop = dyn_cast<CXXForRangeStmt>(stmt)) {
+      body = loop->getBody();
+    } else {
+      return nullopt;
+    }
+    // Pragmas unknown to clang are only kept in the source text.
+    static const regex pipeline_pragma{
+        R"(#\s*pragma\s+HLS\s+pipeline(?!\s+off))", regex::icase};
+    if (!is_pipelined && body != nullptr) {
+      is_pipelined = regex_search(GetSourceText(body), pipeline_pragma);
+    }
+    return Loop{stmt, body, is_pipelined, ii};
+  }
+
+  // Adds the transfers of each stream in `stmt` in one iteration to
+  // `transfers`. Only one branch of a conditional is taken per iteration.
+  void CountTransfers(const Stmt* stmt, map<string, Transfers>& transfers) {
+    if (stmt == nullptr || IsLoop(stmt)) return;
+    const Stmt* branches[2] = {nullptr, nullptr};
+    const Stmt* cond = nullptr;
+    if (auto if_stmt = dyn_cast<IfStmt>(stmt)) {
+      cond = if_stmt->getCond();
+      branches[0] = if_stmt->getThen();
+      branches[1] = if_stmt->getElse();
+    } else if (auto conditional = dyn_cast<ConditionalOperator>(stmt)) {
+      cond = conditional->getCond();
+      branches[0] = conditional->getTrueExpr();
+      branches[1] = conditional->getFalseExpr();
+    }
+    if (cond != nullptr) {
+      CountTransfers(cond, transfers);
+      map<string, Transfers> then_transfers, else_transfers;
+      CountTransfers(branches[0], then_transfers);
+      CountTransfers(branches[1], else_transfers);
+      for (auto& [name, branch] : else_transfers) {
+        auto& other = then_transfers[name];
+        if (branch.count > other.count) other = branch;
+      }
+      for (auto& [name, branch] : then_transfers) {
+        auto& total = transfers[name];
+        total.count += branch.count;
+        total.last_op = branch.last_op;
+      }
+      return;
+    }
+    for (auto child : stmt->children()) CountTransfers(child, transfers);
+    if (auto op = dyn_cast<CXXMemberCallExpr>(stmt)) {
+      if (IsStreamInterface(op->getRecordDecl()) && IsTransfer(op)) {
+        auto& total = transfers[GetStreamName(op)];
+        ++total.count;
+        total.last_op = op;
+      }
+    }
+  }
+
+  // Calls `callback` with each `tapa::mmap` subscript in `stmt`, excluding
+  // nested loops.
+  template <typename Callback>
+  void ForEachMmapAccess(const Stmt* stmt, const Callback& callback) {
+    if (stmt == nullptr || IsLoop(stmt)) return;
+    if (auto op = dyn_cast<CXXOperatorCallExpr>(stmt)) {
+      if (op->getOperator() == clang::OO_Subscript && op->getNumArgs() == 2 &&
+          IsTapaType(op->getArg(0)->IgnoreImpCasts(), "mmap")) {
+        callback(op);
+      }
+    }
+    for (auto child : stmt->children()) ForEachMmapAccess(child, callback);
+  }
+
+  void LintLoop(const Loop& loop) {
+    auto& diagnostics = context_.getDiagnostics();
+    const auto ops = GetTapaStreamOps(loop.body);
+
+    if (!loop.is_pipelined && !ops.empty()) {
+      static const auto diagnostic_id = diagnostics.getCustomDiagID(
+          clang::DiagnosticsEngine::Warning,
+          "loop accessing streams is not pipelined; each iteration starts "
+          "after the previous one completes, add [[tapa::pipeline]] to "
+          "overlap iterations");
+      diagnostics.Report(loop.stmt->getBeginLoc(), diagnostic_id);
+    }
+
+    // Blocking operations on streams that are also tested by non-blocking
+    // operations, e.g., `if (!in.empty()) in.read()`, do not stall.
+    map<string, const CXXMemberCallExpr*> non_blocking_ops;
+    for (auto op : ops) {
+      if (!IsBlocking(op)) non_blocking_ops.emplace(GetStreamName(op), op);
+    }
+    const CXXMemberCallExpr* blocking = nullptr;
+    for (auto op : ops) {
+      if (IsBlocking(op) && non_blocking_ops.count(GetStreamName(op)) == 0) {
+        blocking = op;
+        break;
+      }
+    }
+    if (blocking != nullptr && !non_blocking_ops.empty()) {
+      auto non_blocking = non_blocking_ops.begin()->second;
+      static const auto diagnostic_id = diagnostics.getCustomDiagID(
+          clang::DiagnosticsEngine::Warning,
+          "blocking '%0' in a loop that also calls non-blocking '%1'; the "
+          "whole loop stalls while '%2' is not ready, including the "
+          "non-blocking accesses");
+      diagnostics.Report(blocking->getExprLoc(), diagnostic_id)
+          << blocking->getMethodDecl()->getNameAsString()
+          << non_blocking->getMethodDecl()->getNameAsString()
+          << GetStreamName(blocking) << blocking->getSourceRange();
+    }
+
+    if (!loop.is_pipelined) return;
+
+    map<string, Transfers> transfers;
+    CountTransfers(loop.body, transfers);
+    for (auto& [name, stream] : transfers) {
+      if (stream.count <= max(1U, loop.ii)) continue;
+      static const auto diagnostic_id = diagnostics.getCustomDiagID(
+          clang::DiagnosticsEngine::Warning,
+          "stream '%0' transfers %1 tokens per iteration of a pipelined loop, "
+          "which forces II >= %1; access it once per iteration or use a "
+          "wider element type");
+      diagnostics.Report(stream.last_op->getExprLoc(), diagnostic_id)
+          << name << stream.count << stream.last_op->getSourceRange();
+    }
+
+    const ValueDecl* var = GetInductionVar(loop.stmt);
+    if (var == nullptr) return;
+    ForEachMmapAccess(loop.body, [&](const CXXOperatorCallExpr* op) {
+      if (IsAffineIndex(op->getArg(1), var)) return;
+      static const auto diagnostic_id = diagnostics.getCustomDiagID(
+          clang::DiagnosticsEngine::Warning,
+          "random access to mmap '%0' in a pipelined loop cannot be "
+          "inferred as a burst; each access may take the full memory latency "
+          "and raise the II accordingly, consider tapa::async_mmap or "
+          "buffering in local memory");
+      diagnostics.Report(op->getExprLoc(), diagnostic_id)
+          << GetSourceText(op->getArg(0)->IgnoreImpCasts())
+          << op->getSourceRange();
+    });
+  }
+};
+
+}  // namespace
+
+void LintTaskPerformance(const FunctionDecl* func, ASTContext& context) {
+  PerfLinter(context).Lint(func->getBody());
+}
+
+}  // namespace internal
+}  // namespace tapa
@@ -0,0 +1,27 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#ifndef TAPA_PERF_LINT_H_
+#define TAPA_PERF_LINT_H_
+
+#include "clang/AST/AST.h"
+
+namespace tapa {
+namespace internal {
+
+// Reports stream and mmap access patterns in the loops of task `func` that
+// limit throughput, as warnings describing their impact:
+//
+// - loops accessing streams without `[[tapa::pipeline]]`;
+// - blocking stream operations in loops with non-blocking ones;
+// - multiple reads or writes of a stream per iteration of a pipelined loop;
+// - `tapa::mmap` accesses in pipelined loops with indices not affine in the
+//   loop variable.
+void LintTaskPerformance(const clang::FunctionDecl* func,
+                         clang::ASTContext& context);
+
+}  // namespace internal
+}  // namespace tapa
+
+#endif  // TAPA_PERF_LINT_H_
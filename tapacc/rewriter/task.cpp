@@ -14,6 +14,8 @@
 
 #include "nlohmann/json.hpp"
 
+#include "burst.h"
+#include "fifo_depth.h"
 #include "mmap.h"
 #include "stream.h"
 #include "type.h"
@@ -264,8 +266,21 @@ bool Visitor::VisitAttributedStmt(clang::AttributedStmt* stmt) {
   bool is_other_func = !isFuncTapaTask(rewriting_func);
   bool should_rewrite = rewriting_current_task || is_other_func;
   if (should_rewrite && rewriters_.count(*current_task) > 0) {
-    HandleAttrOnNodeWithBody(stmt, GetLoopBody(stmt->getSubStmt()),
-                             stmt->getAttrs());
+    if (stmt->getSpecificAttr<clang::TapaBurstAttr>() == nullptr) {
+      HandleAttrOnNodeWithBody(stmt, GetLoopBody(stmt->getSubStmt()),
+                               stmt->getAttrs());
+    } else if (rewriting_current_task &&
+               GetTapaTaskObjectExpr(rewriting_func->getBody()) == nullptr) {
+      // Burst loops are pipelined as part of the rewrite.
+      RewriteBurstLoop(stmt, GetRewriter(), context_);
+    } else {
+      static const auto diagnostic_id =
+          this->context_.getDiagnostics().getCustomDiagID(
+              clang::DiagnosticsEngine::Error,
+              "[[tapa::burst]] loops are only supported in lower-level tasks");
+      this->context_.getDiagnostics().Report(stmt->getBeginLoc(),
+                                             diagnostic_id);
+    }
   }
   return clang::RecursiveASTVisitor<Visitor>::VisitAttributedStmt(stmt);
 }
@@ -279,11 +294,12 @@ void Visitor::ProcessTaskPorts(const TapaTask& task, nlohmann::json& metadata) {
     const auto param_name = param->getNameAsString();
     auto add_mmap_meta = [&](const string& name) {
       std::string cat;
+      auto burst = GetBurstConfig(param);
       if (IsTapaType(param, "immap")) {
         cat = "immap";
       } else if (IsTapaType(param, "ommap")) {
         cat = "ommap";
-      } else if (IsTapaType(param, "async_mmap")) {
+      } else if (IsTapaType(param, "async_mmap") || burst) {
         cat = "async_mmap";
       } else {
         cat = "mmap";
@@ -292,6 +308,13 @@ void Visitor::ProcessTaskPorts(const TapaTask& task, nlohmann::json& metadata) {
                                    {"cat", cat},
                                    {"width", arg_width()},
                                    {"type", GetMmapElemType(param) + "*"}});
+      // Burst engine configuration of mmaps accessed in burst loops.
+      if (burst && burst->burst_len > 0) {
+        metadata["ports"].back()["burst_len"] = burst->burst_len;
+      }
+      if (burst && burst->max_outstanding > 0) {
+        metadata["ports"].back()["max_outstanding"] = burst->max_outstanding;
+      }
     };
     if (IsTapaType(param, "(async_)?mmap") || IsTapaType(param, "immap") ||
         IsTapaType(param, "ommap")) {
@@ -385,6 +408,7 @@ void Visitor::ProcessUpperLevelTaskFunc(const ExprWithCleanups* task_obj,
   unordered_map<string, int> ostreams_access_pos;
   unordered_map<string, int> mmaps_access_pos;
   unordered_map<const Expr*, int> seq_access_pos;
+  std::map<string, const FunctionDecl*> child_funcs;
 
   for (auto invoke : invokes) {
     int step = -1;
@@ -501,6 +525,7 @@ void Visitor::ProcessUpperLevelTaskFunc(const ExprWithCleanups* task_obj,
             }
             metadata["tasks"][task_name].push_back({{"step", step}});
             task = decl_ref->getDecl()->getAsFunction();
+            child_funcs[task_name] = task;
           } else {
             assert(task != nullptr);
             auto skip_params = (has_name ? 1 : 0) + (has_executable ? 1 : 0);
@@ -553,7 +578,8 @@ void Visitor::ProcessUpperLevelTaskFunc(const ExprWithCleanups* task_obj,
                   task_name, metadata["tasks"][task_name].size() - 1};
             };
             if (IsTapaType(param, "mmap")) {
-              param_cat = "mmap";
+              // mmaps accessed in burst loops are passed as async_mmaps
+              param_cat = GetBurstConfig(param) ? "async_mmap" : "mmap";
               // vector invocation can map mmaps to mmap
               register_arg(
                   get_name(arg_name, mmaps_access_pos[arg_name]++, decl_ref));
@@ -666,11 +692,45 @@ void Visitor::ProcessUpperLevelTaskFunc(const ExprWithCleanups* task_obj,
       }
     }
   }
+
+  // Recommend stream depths from the estimated timing of lower-level tasks.
+  std::map<string, TaskTiming> timings;
+  for (const auto& [child_name, child_func] : child_funcs) {
+    if (GetTapaTaskObjectExpr(child_func->getBody()) != nullptr &&
+        !IsFuncIgnored(child_func)) {
+      continue;
+    }
+    if (auto timing = EstimateTaskTiming(child_func, context_)) {
+      timings[child_name] = *timing;
+    }
+  }
+  RecommendFifoDepths(metadata["fifos"], timings);
+  for (const auto& [fifo_name, fifo] : metadata["fifos"].items()) {
+    const auto fifo_decl = fifo_decls.find(fifo_name);
+    if (fifo_decl == fifo_decls.end() ||
+        !fifo.contains("recommended_min_depth") ||
+        fifo["depth"] >= fifo["recommended_min_depth"]) {
+      continue;
+    }
+    auto& diagnostics = context_.getDiagnostics();
+    static const auto diagnostic_id = diagnostics.getCustomDiagID(
+        clang::DiagnosticsEngine::Remark,
+        "stream '%0' has depth %1, less than the estimated minimum %2 of "
+        "its reconvergent paths");
+    auto diagnostics_builder =
+        diagnostics.Report(fifo_decl->second->getBeginLoc(), diagnostic_id);
+    diagnostics_builder.AddString(fifo_name);
+    diagnostics_builder.AddString(fifo["depth"].dump());
+    diagnostics_builder.AddString(fifo["recommended_min_depth"].dump());
+    diagnostics_builder.AddSourceRange(
+        GetCharSourceRange(fifo_decl->second->getSourceRange()));
+  }
 }
 
 // Apply tapa s2s transformations on a lower-level task.
 void Visitor::ProcessLowerLevelTaskFunc(const clang::FunctionDecl* func) {
   current_target->RewriteLowerLevelFunc(func, GetRewriter());
+  RewriteBurstMmapParams(func, GetRewriter(), context_);
 
   // The task metadata should only be obtained from the function definition
   if (!func->isThisDeclarationADefinition()) return;
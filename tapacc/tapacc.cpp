@@ -2,6 +2,11 @@
 // All rights reserved. The contributor(s) of this file has/have agreed to the
 // RapidStream Contributor License Agreement.
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -19,10 +24,15 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "nlohmann/json.hpp"
 
+#include "rewriter/fingerprint.h"
+#include "rewriter/perf_lint.h"
 #include "rewriter/task.h"
 
 using std::make_shared;
@@ -62,9 +72,102 @@ namespace tapa {
 namespace internal {
 
 const string* top_name;
+const string* cache_dir = nullptr;
+const string* fingerprint_salt;
+const string* output_dir = nullptr;
+int jobs = 1;
+bool perf_lint = false;
 
 TapaTargetAttr::TargetType target = TapaTargetAttr::TargetType::XilinxHLS;
 
+string GetCachedTaskPath(const string& fingerprint) {
+  llvm::SmallString<128> path{*cache_dir};
+  llvm::sys::path::append(path, fingerprint + ".json");
+  return path.str().str();
+}
+
+// Returns the JSON document in `path`, or null if it cannot be read.
+json LoadJsonFile(const string& path) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) return nullptr;
+  auto output = json::parse((*buffer)->getBuffer().begin(),
+                            (*buffer)->getBuffer().end(), nullptr,
+                            /*allow_exceptions=*/false);
+  if (output.is_discarded()) return nullptr;
+  return output;
+}
+
+// Writes `output` to `path` atomically, so that a concurrent or interrupted
+// run never leaves a partial file.
+void WriteJsonFile(const string& path, const json& output) {
+  auto dir = llvm::sys::path::parent_path(path);
+  if (llvm::sys::fs::create_directories(dir)) return;
+  int fd;
+  llvm::SmallString<128> tmp_path;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmp_path)) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os{fd, /*shouldClose=*/true};
+    os << output.dump();
+  }
+  if (llvm::sys::fs::rename(tmp_path, path)) {
+    llvm::sys::fs::remove(tmp_path);
+  }
+}
+
+// Calls `process` with 0 to `count - 1` using `jobs` worker processes and
+// returns whether all calls succeeded.
+//
+// The workers are forked after the AST is built and share it copy-on-write.
+// Threads would need the AST to be read-only, but clang APIs used by the
+// rewriter, e.g., type sizes, source locations, and name mangling, update
+// caches in the shared contexts.
+bool RunInWorkers(size_t count, int jobs,
+                  const std::function<bool(size_t)>& process) {
+  auto process_range = [&](size_t begin) {
+    bool succeeded = true;
+    for (size_t i = begin; i < count; i += std::max(jobs, 1)) {
+      succeeded = process(i) && succeeded;
+    }
+    return succeeded;
+  };
+  if (jobs <= 1 || count <= 1) return process_range(0);
+
+  // Avoid duplicating buffered output in the workers.
+  std::cout.flush();
+  llvm::outs().flush();
+  llvm::errs().flush();
+
+  bool succeeded = true;
+  vector<pid_t> workers;
+  for (int worker = 0; worker < jobs && static_cast<size_t>(worker) < count;
+       ++worker) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      bool worker_succeeded = process_range(worker);
+      std::cout.flush();
+      llvm::outs().flush();
+      llvm::errs().flush();
+      _exit(worker_succeeded ? 0 : 1);
+    }
+    if (pid < 0) {
+      // Fall back to processing the tasks of this worker in place.
+      succeeded = process_range(worker) && succeeded;
+    } else {
+      workers.push_back(pid);
+    }
+  }
+  for (auto pid : workers) {
+    int status;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      succeeded = false;
+    }
+  }
+  return succeeded;
+}
+
 class Consumer : public ASTConsumer {
  public:
   explicit Consumer(ASTContext& context, vector<const FunctionDecl*>& funcs,
@@ -127,45 +230,122 @@ class Consumer : public ASTConsumer {
           Rewriter(context.getSourceManager(), context.getLangOpts());
     }
 
-    // tapa_tasks has been reset to only contain the TAPA tasks from the top
-    // level task's call graph. Now we can traverse the AST again to extract
-    // metadata and rewrite the source code.
-    for (auto task : tapa_tasks_) {
-      visitor_.VisitTask(task);
+    // Tasks are linted before they are generated, or reused from the cache.
+    if (perf_lint) {
+      for (auto task : tapa_tasks_) LintTaskPerformance(task.func, context);
     }
-    map<TapaTask, string> code_table;
-    json code;
-    for (auto task : tapa_tasks_) {
-      auto task_name = task.func->getNameAsString();
-      auto readable_name = task_name;
-      // For template specializations, use the mangled name
-      if (task.is_template_specialization) {
-        task_name = visitor_.GetMangledFuncName(task.func);
-        readable_name = visitor_.GetTemplatedFuncName(task.func);
+
+    // Names and fingerprints are computed upfront, so that tasks can be
+    // generated independently by worker processes.
+    set<const FunctionDecl*> task_funcs;
+    for (auto task : tapa_tasks_) task_funcs.insert(task.func);
+    vector<TapaTask> tasks(tapa_tasks_.begin(), tapa_tasks_.end());
+    vector<string> task_names;
+    for (const auto& task : tasks) {
+      task_names.push_back(task.is_template_specialization
+                               ? visitor_.GetMangledFuncName(task.func)
+                               : task.func->getNameAsString());
+      fingerprints_[task] =
+          GetTaskFingerprint(task.func, task_funcs, *fingerprint_salt);
+    }
+
+    // Without an output directory, print all tasks as a single document.
+    if (output_dir == nullptr && jobs <= 1) {
+      json code;
+      for (size_t i = 0; i < tasks.size(); ++i) {
+        code["tasks"][task_names[i]] = GenerateTask(context, tasks[i]);
       }
-      raw_string_ostream oss{code_table[task]};
-      rewriters_[task]
-          .getEditBuffer(rewriters_[task].getSourceMgr().getMainFileID())
-          .write(oss);
-      oss.flush();
-      code["tasks"][task_name]["readable_name"] = readable_name;
-      code["tasks"][task_name]["code"] = code_table[task];
-      // if a task is ignored, it is a lower-level task.
-      bool is_upper = GetTapaTaskObjectExpr(task.func->getBody()) != nullptr &&
-                      !IsFuncIgnored(task.func);
-      code["tasks"][task_name]["level"] = is_upper ? "upper" : "lower";
-      code["tasks"][task_name].update(metadata_[task]);
+      code["top"] = *top_name;
+      std::cout << code;
+      return;
+    }
+
+    // Otherwise, write each task to a separate file, in parallel if requested.
+    // Workers without an output directory use a temporary one, from which the
+    // single document is assembled.
+    llvm::SmallString<128> task_dir;
+    if (output_dir != nullptr) {
+      task_dir = *output_dir;
+      llvm::sys::fs::create_directories(task_dir);
+    } else if (llvm::sys::fs::createUniqueDirectory("tapacc", task_dir)) {
+      static const auto diagnostic_id = diagnostics_engine.getCustomDiagID(
+          clang::DiagnosticsEngine::Fatal, "cannot create output directory");
+      diagnostics_engine.Report(diagnostic_id);
+      return;
+    }
+    vector<string> task_paths;
+    for (const auto& task_name : task_names) {
+      llvm::SmallString<128> path{task_dir};
+      llvm::sys::path::append(path, task_name + ".json");
+      task_paths.push_back(path.str().str());
     }
+    bool succeeded = RunInWorkers(tasks.size(), jobs, [&](size_t i) {
+      WriteJsonFile(task_paths[i], GenerateTask(context, tasks[i]));
+      return !diagnostics_engine.hasErrorOccurred();
+    });
+    if (!succeeded) {
+      static const auto diagnostic_id = diagnostics_engine.getCustomDiagID(
+          clang::DiagnosticsEngine::Error, "failed to generate tasks");
+      diagnostics_engine.Report(diagnostic_id);
+    }
+
+    json code;
     code["top"] = *top_name;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      if (output_dir != nullptr) {
+        code["tasks"][task_names[i]] = task_paths[i];
+      } else if (succeeded) {
+        code["tasks"][task_names[i]] = LoadJsonFile(task_paths[i]);
+      }
+    }
+    if (output_dir == nullptr) llvm::sys::fs::remove_directories(task_dir);
     std::cout << code;
   }
 
  private:
+  // Returns the output of `task`, reusing the cached output if its
+  // fingerprint is unchanged.
+  json GenerateTask(ASTContext& context, const TapaTask& task) {
+    const auto& fingerprint = fingerprints_[task];
+    if (cache_dir != nullptr) {
+      auto cached_task = LoadJsonFile(GetCachedTaskPath(fingerprint));
+      if (!cached_task.is_null()) return cached_task;
+    }
+
+    visitor_.VisitTask(task);
+    string code;
+    raw_string_ostream oss{code};
+    rewriters_[task]
+        .getEditBuffer(rewriters_[task].getSourceMgr().getMainFileID())
+        .write(oss);
+    oss.flush();
+
+    json output;
+    output["readable_name"] = task.is_template_specialization
+                                  ? visitor_.GetTemplatedFuncName(task.func)
+                                  : task.func->getNameAsString();
+    output["code"] = std::move(code);
+    // if a task is ignored, it is a lower-level task.
+    bool is_upper = GetTapaTaskObjectExpr(task.func->getBody()) != nullptr &&
+                    !IsFuncIgnored(task.func);
+    output["level"] = is_upper ? "upper" : "lower";
+    output.update(metadata_[task]);
+    output["fingerprint"] = fingerprint;
+    // Release the rewritten buffers as early as possible.
+    rewriters_.erase(task);
+    metadata_.erase(task);
+    if (cache_dir != nullptr && !context.getDiagnostics().hasErrorOccurred()) {
+      WriteJsonFile(GetCachedTaskPath(fingerprint), output);
+    }
+    return output;
+  }
+
   Visitor visitor_;
   vector<const FunctionDecl*>& funcs_;
   set<TapaTask>& tapa_tasks_;
   map<TapaTask, Rewriter> rewriters_;
   map<TapaTask, json> metadata_;
+  map<TapaTask, string> fingerprints_;
 };
 
 class Action : public ASTFrontendAction {
@@ -201,6 +381,22 @@ static llvm::cl::opt<TapaTargetAttr::TargetType> tapa_opt_target(
         llvm::cl::OptionEnumValue{"xilinx-vitis",
                                   TapaTargetAttr::TargetType::XilinxVitis,
                                   "Xilinx Vitis target"}));
+static llvm::cl::opt<string> tapa_opt_cache_dir(
+    "cache-dir",
+    llvm::cl::desc("Directory to reuse the output of unchanged tasks from"),
+    llvm::cl::cat(tapa_option_category));
+static llvm::cl::opt<string> tapa_opt_output_dir(
+    "output-dir",
+    llvm::cl::desc("Directory to write the output of each task to; only an "
+                   "index of the tasks is printed"),
+    llvm::cl::cat(tapa_option_category));
+static llvm::cl::opt<int> tapa_opt_jobs(
+    "jobs", llvm::cl::desc("Number of worker processes generating tasks"),
+    llvm::cl::init(1), llvm::cl::cat(tapa_option_category));
+static llvm::cl::opt<bool> tapa_opt_perf_lint(
+    "perf-lint",
+    llvm::cl::desc("Warn about code patterns that limit task throughput"),
+    llvm::cl::cat(tapa_option_category));
 
 int main(int argc, const char** argv) {
   auto expected_parser =
@@ -211,9 +407,31 @@ int main(int argc, const char** argv) {
   string top_name{tapa_opt_top_name.getValue()};
   tapa::internal::top_name = &top_name;
 
+  string cache_dir{tapa_opt_cache_dir.getValue()};
+  if (!cache_dir.empty()) tapa::internal::cache_dir = &cache_dir;
+
+  string output_dir{tapa_opt_output_dir.getValue()};
+  if (!output_dir.empty()) tapa::internal::output_dir = &output_dir;
+  tapa::internal::jobs = tapa_opt_jobs.getValue();
+  tapa::internal::perf_lint = tapa_opt_perf_lint.getValue();
+
+  // The fingerprints cover the target, the top-level task, and the compile
+  // commands, whose flags affect code outside the main files.
   if (tapa_opt_target.getNumOccurrences() > 0) {
     tapa::internal::target = tapa_opt_target.getValue();
   }
+  string fingerprint_salt{
+      TapaTargetAttr::ConvertTargetTypeToStr(tapa::internal::target)};
+  fingerprint_salt += '\0' + top_name;
+  for (const auto& source : parser.getSourcePathList()) {
+    for (const auto& command :
+         parser.getCompilations().getCompileCommands(source)) {
+      for (const auto& arg : command.CommandLine) {
+        fingerprint_salt += '\0' + arg;
+      }
+    }
+  }
+  tapa::internal::fingerprint_salt = &fingerprint_salt;
 
   int ret = tool.run(newFrontendActionFactory<tapa::internal::Action>().get());
   return ret;
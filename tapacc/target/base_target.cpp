@@ -4,6 +4,7 @@
 
 #include "base_target.h"
 
+#include "../rewriter/burst.h"
 #include "../rewriter/mmap.h"
 #include "../rewriter/stream.h"
 #include "../rewriter/type.h"
@@ -95,7 +96,7 @@ void BaseTarget::AddCodeForMiddleLevelParameter(ADD_FOR_PARAMS_ARGS_DEF) {
 void BaseTarget::AddCodeForLowerLevelParameter(ADD_FOR_PARAMS_ARGS_DEF) {
   if (IsTapaType(param, "(i|o)streams?")) {
     AddCodeForLowerLevelStream(param, add_line, add_pragma);
-  } else if (IsTapaType(param, "async_mmaps?")) {
+  } else if (IsTapaType(param, "async_mmaps?") || GetBurstConfig(param)) {
     AddCodeForLowerLevelAsyncMmap(param, add_line, add_pragma);
   } else if (IsTapaType(param, "(mmaps?|hmap)")) {
     AddCodeForLowerLevelMmap(param, add_line, add_pragma);
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <tapa.h>
+
+using std::clog;
+using std::endl;
+using std::vector;
+
+void Burst(tapa::mmap<const float> src, tapa::mmap<float> dst,
+           tapa::mmap<float> mem, uint64_t offset, uint64_t n);
+
+DEFINE_string(bitstream, "", "path to bitstream file, run csim if empty");
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, /*remove_flags=*/true);
+
+  const uint64_t n = argc > 1 ? atoll(argv[1]) : 1024 * 1024;
+  const uint64_t offset = 3;
+  vector<float> src(n + offset);
+  vector<float> dst(n);
+  vector<float> mem(n + offset);
+  for (uint64_t i = 0; i < n + offset; ++i) {
+    src[i] = static_cast<float>(i);
+    mem[i] = static_cast<float>(i) * 3;
+  }
+  int64_t kernel_time_ns = tapa::invoke(
+      Burst, FLAGS_bitstream, tapa::read_only_mmap<const float>(src),
+      tapa::write_only_mmap<float>(dst), tapa::read_write_mmap<float>(mem),
+      offset, n);
+  clog << "kernel time: " << kernel_time_ns * 1e-9 << " s" << endl;
+
+  uint64_t num_errors = 0;
+  const uint64_t threshold = 10;  // only report up to these errors
+  auto check = [&](const char* name, uint64_t i, float expected, float actual) {
+    if (actual != expected) {
+      if (num_errors < threshold) {
+        clog << name << "[" << i << "] expected: " << expected
+             << ", actual: " << actual << endl;
+      } else if (num_errors == threshold) {
+        clog << "...";
+      }
+      ++num_errors;
+    }
+  };
+  for (uint64_t i = 0; i < n; ++i) {
+    check("dst", i, static_cast<float>(i + offset) * 2, dst[i]);
+  }
+  for (uint64_t i = 0; i < n + offset; ++i) {
+    check("mem", i, static_cast<float>(i) * 3 + (i < offset ? 0 : 1), mem[i]);
+  }
+  if (num_errors == 0) {
+    clog << "PASS!" << endl;
+  } else {
+    if (num_errors > threshold) {
+      clog << " (+" << (num_errors - threshold) << " more errors)" << endl;
+    }
+    clog << "FAIL!" << endl;
+  }
+  return num_errors > 0 ? 1 : 0;
+}
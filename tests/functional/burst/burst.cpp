@@ -0,0 +1,42 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <cstdint>
+
+#include <tapa.h>
+
+// Read-only burst at an offset, with a const element type.
+void Read(tapa::mmap<const float> src, uint64_t offset, uint64_t n,
+          tapa::ostream<float>& out) {
+  [[tapa::burst(64, 32)]] [[tapa::pipeline(1)]]
+  for (uint64_t i = 0; i < n; ++i) {
+    out.write(src[i + offset]);
+  }
+}
+
+// Write-only burst.
+void Write(tapa::istream<float>& in, uint64_t n, tapa::mmap<float> dst) {
+  [[tapa::burst(64)]] [[tapa::pipeline(1)]]
+  for (uint64_t i = 0; i < n; ++i) {
+    dst[i] = in.read() * 2;
+  }
+}
+
+// Read-modify-write burst at an offset.
+void Update(tapa::mmap<float> mem, uint64_t offset, uint64_t n) {
+  [[tapa::burst]] [[tapa::pipeline(1)]]
+  for (uint64_t i = 0; i < n; ++i) {
+    mem[i + offset] += 1;
+  }
+}
+
+void Burst(tapa::mmap<const float> src, tapa::mmap<float> dst,
+           tapa::mmap<float> mem, uint64_t offset, uint64_t n) {
+  tapa::stream<float> data("data");
+
+  tapa::task()
+      .invoke(Read, src, offset, n, data)
+      .invoke(Write, data, n, dst)
+      .invoke(Update, mem, offset, n);
+}
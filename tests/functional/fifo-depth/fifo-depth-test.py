@@ -0,0 +1,48 @@
+# ruff: noqa: INP001
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import json
+
+import pytest
+from python.runfiles import Runfiles  # type: ignore[reportMissingImports]
+
+_TESTDATA_PATH = "_main/tests/functional/fifo-depth/fifo-depth-graph.json"
+_RUNFILES = Runfiles.Create()
+assert _RUNFILES is not None
+_GRAPH_PATH = _RUNFILES.Rlocation(_TESTDATA_PATH)
+assert _GRAPH_PATH is not None
+with open(_GRAPH_PATH, encoding="utf-8") as _graph_file:
+    _FIFOS = json.load(_graph_file)["tasks"]["FifoDepth"]["fifos"]
+
+
+# `Source` writes its first tokens at cycle 1. A stream delivers a token one
+# cycle after it is written, and `Stage` and `Join` forward it one cycle later.
+@pytest.mark.parametrize(
+    ("fifo", "depth"),
+    [
+        # `Delay` reads all 64 tokens before writing its first one at cycle 66,
+        # so `Join` has all inputs at cycle 67 and the short path holds the
+        # tokens written at cycles 1 through 65.
+        ("diamond_short", 65),
+        ("diamond_long_in", 2),
+        ("diamond_long_out", 2),
+        ("diamond_joined", 2),
+        # The long path writes its last stream at cycle 7 and the short path
+        # at cycle 3, so `Join` has all inputs at cycle 8 and the short path
+        # holds 4 tokens.
+        ("chain_short_in", 2),
+        ("chain_short_out", 4),
+        ("chain_long_0", 2),
+        ("chain_long_1", 2),
+        ("chain_long_2", 2),
+        ("chain_long_3", 2),
+        ("chain_joined", 2),
+    ],
+)
+def test_recommended_min_depth(fifo: str, depth: int) -> None:
+    assert _FIFOS[fifo]["recommended_min_depth"] == depth
@@ -0,0 +1,68 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <tapa.h>
+
+constexpr int kN = 64;
+
+void Source(tapa::ostream<int>& short_out, tapa::ostream<int>& long_out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) {
+    short_out.write(i);
+    long_out.write(i);
+  }
+}
+
+// Reads all tokens before writing the first one.
+void Delay(tapa::istream<int>& in, tapa::ostream<int>& out) {
+  int buf[kN];
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) { buf[i] = in.read(); }
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) { out.write(buf[i]); }
+}
+
+// Forwards tokens one per cycle.
+void Stage(tapa::istream<int>& in, tapa::ostream<int>& out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) { out.write(in.read()); }
+}
+
+void Join(tapa::istream<int>& a, tapa::istream<int>& b,
+          tapa::ostream<int>& out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) {
+    out.write(a.read() + b.read());
+  }
+}
+
+void Sink(tapa::istream<int>& in, tapa::mmap<int> mem) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) { mem[i] = in.read(); }
+}
+
+void FifoDepth(tapa::mmap<int> diamond_mem, tapa::mmap<int> chain_mem) {
+  // Diamond: the long path buffers all tokens in `Delay`.
+  tapa::stream<int> diamond_short("diamond_short");
+  tapa::stream<int> diamond_long_in("diamond_long_in");
+  tapa::stream<int> diamond_long_out("diamond_long_out");
+  tapa::stream<int> diamond_joined("diamond_joined");
+
+  // Unbalanced paths: one `Stage` on the short path and three on the long
+  // path.
+  tapa::stream<int> chain_short_in("chain_short_in");
+  tapa::stream<int> chain_short_out("chain_short_out");
+  tapa::stream<int> chain_long_0("chain_long_0");
+  tapa::stream<int> chain_long_1("chain_long_1");
+  tapa::stream<int> chain_long_2("chain_long_2");
+  tapa::stream<int> chain_long_3("chain_long_3");
+  tapa::stream<int> chain_joined("chain_joined");
+
+  tapa::task()
+      .invoke(Source, diamond_short, diamond_long_in)
+      .invoke(Delay, diamond_long_in, diamond_long_out)
+      .invoke(Join, diamond_short, diamond_long_out, diamond_joined)
+      .invoke(Sink, diamond_joined, diamond_mem)
+      .invoke(Source, chain_short_in, chain_long_0)
+      .invoke(Stage, chain_short_in, chain_short_out)
+      .invoke(Stage, chain_long_0, chain_long_1)
+      .invoke(Stage, chain_long_1, chain_long_2)
+      .invoke(Stage, chain_long_2, chain_long_3)
+      .invoke(Join, chain_short_out, chain_long_3, chain_joined)
+      .invoke(Sink, chain_joined, chain_mem);
+}
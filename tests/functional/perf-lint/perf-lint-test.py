@@ -0,0 +1,44 @@
+# ruff: noqa: INP001
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import re
+
+from python.runfiles import Runfiles  # type: ignore[reportMissingImports]
+
+_TESTDATA_PATH = "_main/tests/functional/perf-lint/perf-lint.log"
+_LINT_WARNING = re.compile(
+    r"warning: ((loop accessing streams|blocking '|stream '|random access).*)$"
+)
+
+
+def test_perf_lint_warnings() -> None:
+    runfiles = Runfiles.Create()
+    assert runfiles is not None
+    log_path = runfiles.Rlocation(_TESTDATA_PATH)
+    assert log_path is not None
+    with open(log_path, encoding="utf-8") as f:
+        warnings = [
+            match.group(1)
+            for match in map(_LINT_WARNING.search, f.read().splitlines())
+            if match is not None
+        ]
+
+    # `Load`, instantiated twice, and `Negate` do not warn.
+    assert sorted(warnings) == [
+        "blocking 'read' in a loop that also calls non-blocking 'try_read'; the "
+        "whole loop stalls while 'b' is not ready, including the non-blocking "
+        "accesses",
+        "loop accessing streams is not pipelined; each iteration starts after "
+        "the previous one completes, add [[tapa::pipeline]] to overlap iterations",
+        "random access to mmap 'table' in a pipelined loop cannot be inferred as "
+        "a burst; each access may take the full memory latency and raise the II "
+        "accordingly, consider tapa::async_mmap or buffering in local memory",
+        "stream 'pairs' transfers 2 tokens per iteration of a pipelined loop, "
+        "which forces II >= 2; access it once per iteration or use a wider "
+        "element type",
+    ]
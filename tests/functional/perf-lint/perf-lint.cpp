@@ -0,0 +1,74 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <tapa.h>
+
+constexpr int kN = 64;
+
+// Affine indices do not warn.
+void Load(tapa::mmap<const int> mem, tapa::ostream<int>& out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) { out.write(mem[i + 1]); }
+}
+
+// Warns that the loop is not pipelined.
+void Copy(tapa::istream<int>& in, tapa::ostream<int>& out) {
+  for (int i = 0; i < kN; ++i) {
+    out.write(in.read());
+  }
+}
+
+// One transfer per branch does not warn.
+void Negate(tapa::istream<int>& in, tapa::ostream<int>& pairs) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN; ++i) {
+    if (i % 2 == 0) {
+      pairs.write(in.read());
+    } else {
+      pairs.write(-in.read());
+    }
+  }
+}
+
+// Warns that `pairs` is read twice per iteration.
+void Sum(tapa::istream<int>& pairs, tapa::ostream<int>& out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN / 2; ++i) {
+    out.write(pairs.read() + pairs.read());
+  }
+}
+
+// Warns that `table` is accessed at random.
+void Gather(tapa::mmap<const int> table, tapa::istream<int>& indices,
+            tapa::ostream<int>& out) {
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN / 2; ++i) {
+    out.write(table[indices.read()]);
+  }
+}
+
+// Warns that the blocking read of `b` stalls the non-blocking read of `a`.
+void Merge(tapa::istream<int>& a, tapa::istream<int>& b, tapa::mmap<int> mem) {
+  int sum = 0;
+  [[tapa::pipeline(1)]] for (int i = 0; i < kN / 2; ++i) {
+    int x;
+    if (a.try_read(x)) sum += x;
+    sum += b.read();
+  }
+  mem[0] = sum;
+}
+
+void PerfLint(tapa::mmap<const int> table, tapa::mmap<int> result) {
+  tapa::stream<int> loaded("loaded");
+  tapa::stream<int> copied("copied");
+  tapa::stream<int> pairs("pairs");
+  tapa::stream<int> indices("indices");
+  tapa::stream<int> gathered("gathered");
+  tapa::stream<int> offsets("offsets");
+
+  tapa::task()
+      .invoke(Load, table, loaded)
+      .invoke(Copy, loaded, copied)
+      .invoke(Negate, copied, pairs)
+      .invoke(Sum, pairs, indices)
+      .invoke(Gather, table, indices, gathered)
+      .invoke(Load, table, offsets)
+      .invoke(Merge, gathered, offsets, result);
+}
@@ -0,0 +1,78 @@
+# ruff: noqa: INP001
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import json
+import re
+
+from python.runfiles import Runfiles  # type: ignore[reportMissingImports]
+
+_TESTDATA_DIR = "_main/tests/functional/tapacc-cache"
+_CHANGED_TASKS = re.compile(
+    r"(\d+) of (\d+) tasks changed since the last analysis: (.*)$", re.MULTILINE
+)
+
+# `Scale` and `Store` are edited. Only the burst of `Store` is visible to its
+# caller, which instantiates the burst engine; `Compute` sees the signature of
+# `Scale` only.
+_EXPECTED_CHANGED_TASKS = ["Scale", "Store", "TapaccCache"]
+
+
+def _read(name: str) -> str:
+    runfiles = Runfiles.Create()
+    assert runfiles is not None
+    path = runfiles.Rlocation(f"{_TESTDATA_DIR}/{name}")
+    assert path is not None
+    with open(path, encoding="utf-8") as f:
+        return f.read()
+
+
+def _fingerprints(name: str) -> dict[str, str]:
+    tasks = json.loads(_read(name))["tasks"]
+    return {task: obj["fingerprint"] for task, obj in tasks.items()}
+
+
+def _files(name: str) -> dict[str, tuple[str, str]]:
+    """Returns the inode and SHA-256 of each file listed in `name`."""
+    files = {}
+    for line in _read(name).splitlines():
+        file, inode, sha256 = line.split()
+        files[file] = (inode, sha256)
+    return files
+
+
+def test_only_edited_tasks_and_callers_change() -> None:
+    old = _fingerprints("graph-v1.json")
+    new = _fingerprints("graph-v2.json")
+    assert sorted(new) == sorted(old)
+    changed = sorted(task for task in new if new[task] != old[task])
+    assert changed == _EXPECTED_CHANGED_TASKS
+
+    match = _CHANGED_TASKS.search(_read("analyze-v2.log"))
+    assert match is not None
+    assert int(match.group(1)) == len(_EXPECTED_CHANGED_TASKS)
+    assert int(match.group(2)) == len(new)
+    assert sorted(match.group(3).split(", ")) == _EXPECTED_CHANGED_TASKS
+
+
+def test_unchanged_tasks_are_served_from_cache() -> None:
+    old = _fingerprints("graph-v1.json")
+    new = _fingerprints("graph-v2.json")
+    old_cache = _files("cache-v1.txt")
+    new_cache = _files("cache-v2.txt")
+    old_tasks = _files("tasks-v1.txt")
+    new_tasks = _files("tasks-v2.txt")
+
+    for task, fingerprint in new.items():
+        # Each task is output exactly as cached under its fingerprint.
+        assert new_tasks[task][1] == new_cache[fingerprint][1], task
+        if task in _EXPECTED_CHANGED_TASKS:
+            assert fingerprint not in old_cache, task
+        else:
+            # Not rewritten, but read from the cache of the first analysis.
+            assert new_cache[fingerprint] == old_cache[old[task]], task
+            assert new_tasks[task][1] == old_tasks[task][1], task
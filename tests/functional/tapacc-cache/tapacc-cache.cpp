@@ -0,0 +1,50 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <cstdint>
+
+#include <tapa.h>
+
+void Load(tapa::mmap<const float> src, uint64_t n, tapa::ostream<float>& out) {
+  [[tapa::pipeline(1)]] for (uint64_t i = 0; i < n; ++i) { out.write(src[i]); }
+}
+
+// The second analysis scales by 3 instead.
+void Scale(tapa::istream<float>& in, tapa::ostream<float>& out, uint64_t n) {
+  [[tapa::pipeline(1)]] for (uint64_t i = 0; i < n; ++i) {
+    out.write(in.read() * 2);
+  }
+}
+
+void Offset(tapa::istream<float>& in, tapa::ostream<float>& out, uint64_t n) {
+  [[tapa::pipeline(1)]] for (uint64_t i = 0; i < n; ++i) {
+    out.write(in.read() + 1);
+  }
+}
+
+void Compute(tapa::istream<float>& in, tapa::ostream<float>& out, uint64_t n) {
+  tapa::stream<float> scaled("scaled");
+
+  tapa::task().invoke(Scale, in, scaled, n).invoke(Offset, scaled, out, n);
+}
+
+// The second analysis bursts 32 beats instead, which changes the burst engine
+// instantiated by the caller.
+void Store(tapa::istream<float>& in, tapa::mmap<float> dst, uint64_t n) {
+  [[tapa::burst(64)]] [[tapa::pipeline(1)]]
+  for (uint64_t i = 0; i < n; ++i) {
+    dst[i] = in.read();
+  }
+}
+
+void TapaccCache(tapa::mmap<const float> src, tapa::mmap<float> dst,
+                 uint64_t n) {
+  tapa::stream<float> loaded("loaded");
+  tapa::stream<float> computed("computed");
+
+  tapa::task()
+      .invoke(Load, src, n, loaded)
+      .invoke(Compute, loaded, computed, n)
+      .invoke(Store, computed, dst, n);
+}
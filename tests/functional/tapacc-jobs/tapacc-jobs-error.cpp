@@ -0,0 +1,27 @@
+// Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+// All rights reserved. The contributor(s) of this file has/have agreed to the
+// RapidStream Contributor License Agreement.
+
+#include <cstdint>
+
+#include <tapa.h>
+
+void Load(tapa::mmap<const float> src, uint64_t n, tapa::ostream<float>& out) {
+  [[tapa::pipeline(1)]] for (uint64_t i = 0; i < n; ++i) { out.write(src[i]); }
+}
+
+// Invalid: a burst needs at least 2 outstanding requests, which is only
+// diagnosed when the task is generated.
+void Store(tapa::istream<float>& in, tapa::mmap<float> dst, uint64_t n) {
+  [[tapa::burst(64, 1)]] [[tapa::pipeline(1)]]
+  for (uint64_t i = 0; i < n; ++i) {
+    dst[i] = in.read();
+  }
+}
+
+void TapaccJobsError(tapa::mmap<const float> src, tapa::mmap<float> dst,
+                     uint64_t n) {
+  tapa::stream<float> loaded("loaded");
+
+  tapa::task().invoke(Load, src, n, loaded).invoke(Store, loaded, dst, n);
+}
@@ -0,0 +1,52 @@
+# ruff: noqa: INP001
+
+__copyright__ = """
+Copyright (c) 2025 RapidStream Design Automation, Inc. and contributors.
+All rights reserved. The contributor(s) of this file has/have agreed to the
+RapidStream Contributor License Agreement.
+"""
+
+import json
+from pathlib import Path
+
+from python.runfiles import Runfiles  # type: ignore[reportMissingImports]
+
+_TESTDATA_DIR = "_main/tests/functional/tapacc-jobs"
+
+
+def _read(name: str) -> str:
+    runfiles = Runfiles.Create()
+    assert runfiles is not None
+    path = runfiles.Rlocation(f"{_TESTDATA_DIR}/{name}")
+    assert path is not None
+    with open(path, encoding="utf-8") as f:
+        return f.read()
+
+
+def test_parallel_document_matches_serial() -> None:
+    serial = json.loads(_read("serial.json"))
+    assert sorted(serial["tasks"]) == [
+        "Compute",
+        "Load",
+        "Offset",
+        "Scale",
+        "Store",
+        "TapaccJobs",
+    ]
+    assert json.loads(_read("parallel-document.json")) == serial
+
+
+def test_output_dir_matches_serial() -> None:
+    serial = json.loads(_read("serial.json"))
+    index = json.loads(_read("parallel-index.json"))
+    assert index["top"] == serial["top"]
+    assert sorted(index["tasks"]) == sorted(serial["tasks"])
+    for name, path in index["tasks"].items():
+        task = json.loads(_read(f"parallel/{Path(path).name}"))
+        assert task == serial["tasks"][name], name
+
+
+def test_worker_failure_fails_tapacc() -> None:
+    log = _read("error.log")
+    assert "at least 2 outstanding requests required" in log
+    assert "failed to generate tasks" in log